@@ -1,5 +1,7 @@
 CREATE SCHEMA public;
 
+CREATE EXTENSION IF NOT EXISTS pg_stat_statements;
+
 CREATE TYPE public.points AS ENUM (
     '0',
     '15',
@@ -10,6 +12,110 @@ CREATE TYPE public.points AS ENUM (
 
 ALTER TYPE public.points OWNER TO postgres;
 
+CREATE FUNCTION public.notify_point_event() RETURNS trigger
+    LANGUAGE plpgsql
+    AS $$
+BEGIN
+    PERFORM pg_notify('point_events', NEW.match_id || ',' || NEW.seq || ',' || NEW.winner || ',' || NEW.is_player_one_serving::integer);
+    RETURN NULL;
+END;
+$$;
+
+ALTER FUNCTION public.notify_point_event() OWNER TO postgres;
+
+CREATE FUNCTION public.notify_match_status() RETURNS trigger
+    LANGUAGE plpgsql
+    AS $$
+BEGIN
+    PERFORM pg_notify('match_status', NEW.id || ',' || NEW.status_id);
+    RETURN NULL;
+END;
+$$;
+
+ALTER FUNCTION public.notify_match_status() OWNER TO postgres;
+
+CREATE FUNCTION public.refresh_match_summary(p_match_id integer) RETURNS void
+    LANGUAGE plpgsql
+    AS $$
+BEGIN
+    INSERT INTO public.match_summary (match_id, status, player_id1, player_id2, player1_name, player2_name, winner_name,
+                                      no_sets, sets_won_player1, sets_won_player2, set_scores, duration)
+    SELECT m.id, ms.status, m.player_id1, m.player_id2,
+           p1.first_name || ' ' || p1.last_name,
+           p2.first_name || ' ' || p2.last_name,
+           COALESCE(w.first_name || ' ' || w.last_name, 'N/A'),
+           m.no_sets,
+           COALESCE(s.sets_won_player1, 0),
+           COALESCE(s.sets_won_player2, 0),
+           COALESCE(s.set_scores, ''),
+           m.duration
+    FROM public.matches m
+    JOIN public.players p1 ON m.player_id1 = p1.id
+    JOIN public.players p2 ON m.player_id2 = p2.id
+    LEFT JOIN public.players w ON m.winner_id = w.id
+    LEFT JOIN public.match_status ms ON m.status_id = ms.id
+    LEFT JOIN LATERAL (
+        SELECT SUM(CASE WHEN (mse.games_won_player1 >= 6 AND mse.games_won_player1 >= mse.games_won_player2 + 2) OR mse.games_won_player1 = 7 THEN 1 ELSE 0 END) AS sets_won_player1,
+               SUM(CASE WHEN (mse.games_won_player2 >= 6 AND mse.games_won_player2 >= mse.games_won_player1 + 2) OR mse.games_won_player2 = 7 THEN 1 ELSE 0 END) AS sets_won_player2,
+               string_agg(mse.games_won_player1 || '-' || mse.games_won_player2, ' ' ORDER BY mse.set_number) AS set_scores
+        FROM public.matches_sets mse
+        WHERE mse.match_id = m.id
+    ) s ON true
+    WHERE m.id = p_match_id
+    ON CONFLICT (match_id) DO UPDATE SET
+        status = EXCLUDED.status,
+        player_id1 = EXCLUDED.player_id1,
+        player_id2 = EXCLUDED.player_id2,
+        player1_name = EXCLUDED.player1_name,
+        player2_name = EXCLUDED.player2_name,
+        winner_name = EXCLUDED.winner_name,
+        no_sets = EXCLUDED.no_sets,
+        sets_won_player1 = EXCLUDED.sets_won_player1,
+        sets_won_player2 = EXCLUDED.sets_won_player2,
+        set_scores = EXCLUDED.set_scores,
+        duration = EXCLUDED.duration;
+END;
+$$;
+
+ALTER FUNCTION public.refresh_match_summary(integer) OWNER TO postgres;
+
+CREATE FUNCTION public.match_summary_on_match() RETURNS trigger
+    LANGUAGE plpgsql
+    AS $$
+BEGIN
+    PERFORM public.refresh_match_summary(NEW.id);
+    RETURN NULL;
+END;
+$$;
+
+ALTER FUNCTION public.match_summary_on_match() OWNER TO postgres;
+
+CREATE FUNCTION public.match_summary_on_set() RETURNS trigger
+    LANGUAGE plpgsql
+    AS $$
+BEGIN
+    IF TG_OP = 'DELETE' THEN
+        PERFORM public.refresh_match_summary(OLD.match_id);
+    ELSE
+        PERFORM public.refresh_match_summary(NEW.match_id);
+    END IF;
+    RETURN NULL;
+END;
+$$;
+
+ALTER FUNCTION public.match_summary_on_set() OWNER TO postgres;
+
+CREATE FUNCTION public.match_summary_on_player() RETURNS trigger
+    LANGUAGE plpgsql
+    AS $$
+BEGIN
+    PERFORM public.refresh_match_summary(m.id) FROM public.matches m WHERE m.player_id1 = NEW.id OR m.player_id2 = NEW.id;
+    RETURN NULL;
+END;
+$$;
+
+ALTER FUNCTION public.match_summary_on_player() OWNER TO postgres;
+
 CREATE TABLE public.game_points (
     match_id integer NOT NULL,
     set_number integer NOT NULL,
@@ -53,6 +159,23 @@ ALTER SEQUENCE public.matches_id_seq OWNER TO postgres;
 
 ALTER SEQUENCE public.matches_id_seq OWNED BY public.matches.id;
 
+CREATE TABLE public.match_summary (
+    match_id integer NOT NULL,
+    status character varying(20),
+    player_id1 integer NOT NULL,
+    player_id2 integer NOT NULL,
+    player1_name text NOT NULL,
+    player2_name text NOT NULL,
+    winner_name text NOT NULL,
+    no_sets integer NOT NULL,
+    sets_won_player1 integer NOT NULL,
+    sets_won_player2 integer NOT NULL,
+    set_scores text NOT NULL,
+    duration interval NOT NULL
+);
+
+ALTER TABLE public.match_summary OWNER TO postgres;
+
 CREATE TABLE public.matches_sets (
     match_id integer NOT NULL,
     set_number integer NOT NULL,
@@ -69,11 +192,23 @@ CREATE TABLE public.players (
     first_name character varying(25) NOT NULL,
     last_name character varying(25) NOT NULL,
     matches_won integer DEFAULT 0,
-    matches_lost integer DEFAULT 0
+    matches_lost integer DEFAULT 0,
+    rating double precision DEFAULT 1500 NOT NULL,
+    rated_matches integer DEFAULT 0 NOT NULL
 );
 
 ALTER TABLE public.players OWNER TO postgres;
 
+CREATE TABLE public.point_events (
+    match_id integer NOT NULL,
+    seq integer NOT NULL,
+    winner smallint NOT NULL,
+    is_player_one_serving boolean NOT NULL,
+    CONSTRAINT point_events_winner_check CHECK (((winner = 1) OR (winner = 2)))
+);
+
+ALTER TABLE public.point_events OWNER TO postgres;
+
 CREATE SEQUENCE public.players_id_seq
     START WITH 1
     INCREMENT BY 1
@@ -85,6 +220,17 @@ ALTER SEQUENCE public.players_id_seq OWNER TO postgres;
 
 ALTER SEQUENCE public.players_id_seq OWNED BY public.players.id;
 
+CREATE TABLE public.rating_parameters (
+    id integer DEFAULT 1 NOT NULL,
+    initial_rating double precision NOT NULL,
+    k_factor double precision NOT NULL,
+    provisional_k_factor double precision NOT NULL,
+    provisional_matches integer NOT NULL,
+    CONSTRAINT rating_parameters_single_row_check CHECK ((id = 1))
+);
+
+ALTER TABLE public.rating_parameters OWNER TO postgres;
+
 CREATE TABLE public.tie_break_type (
     type_id integer NOT NULL,
     min_points integer NOT NULL
@@ -128,6 +274,10 @@ COPY public.match_status (id, status) FROM stdin;
 5	Delayed
 \.
 
+COPY public.rating_parameters (id, initial_rating, k_factor, provisional_k_factor, provisional_matches) FROM stdin;
+1	1500	24	40	20
+\.
+
 COPY public.tie_break_type (type_id, min_points) FROM stdin;
 1	7
 2	10
@@ -157,6 +307,9 @@ ALTER TABLE ONLY public.match_status
 ALTER TABLE public.matches
     ADD CONSTRAINT matches_check CHECK (((winner_id = player_id1) OR (winner_id = player_id2))) NOT VALID;
 
+ALTER TABLE ONLY public.match_summary
+    ADD CONSTRAINT match_summary_pkey PRIMARY KEY (match_id);
+
 ALTER TABLE ONLY public.matches
     ADD CONSTRAINT matches_pkey PRIMARY KEY (id);
 
@@ -178,6 +331,12 @@ ALTER TABLE public.players
 ALTER TABLE ONLY public.players
     ADD CONSTRAINT players_pkey PRIMARY KEY (id);
 
+ALTER TABLE ONLY public.rating_parameters
+    ADD CONSTRAINT rating_parameters_pkey PRIMARY KEY (id);
+
+ALTER TABLE ONLY public.point_events
+    ADD CONSTRAINT point_events_pkey PRIMARY KEY (match_id, seq);
+
 ALTER TABLE ONLY public.tie_break_type
     ADD CONSTRAINT tie_break_type_pkey PRIMARY KEY (type_id);
 
@@ -193,6 +352,30 @@ ALTER TABLE public.tie_breaks
 ALTER TABLE public.tie_breaks
     ADD CONSTRAINT tie_breaks_set_number_check CHECK ((set_number > 0)) NOT VALID;
 
+CREATE INDEX match_summary_player_id1_idx ON public.match_summary USING btree (player_id1, match_id);
+
+CREATE INDEX match_summary_player_id2_idx ON public.match_summary USING btree (player_id2, match_id);
+
+CREATE INDEX match_summary_status_idx ON public.match_summary USING btree (status, match_id);
+
+CREATE INDEX matches_player_id1_idx ON public.matches USING btree (player_id1, id);
+
+CREATE INDEX matches_player_id2_idx ON public.matches USING btree (player_id2, id);
+
+CREATE INDEX matches_status_id_idx ON public.matches USING btree (status_id, id);
+
+CREATE INDEX tie_breaks_match_id_idx ON public.tie_breaks USING btree (match_id, set_number);
+
+CREATE TRIGGER matches_status_notify AFTER UPDATE OF status_id ON public.matches FOR EACH ROW WHEN (OLD.status_id IS DISTINCT FROM NEW.status_id) EXECUTE FUNCTION public.notify_match_status();
+
+CREATE TRIGGER matches_summary AFTER INSERT OR UPDATE OF player_id1, player_id2, status_id, winner_id, duration, no_sets ON public.matches FOR EACH ROW EXECUTE FUNCTION public.match_summary_on_match();
+
+CREATE TRIGGER matches_sets_summary AFTER INSERT OR DELETE OR UPDATE ON public.matches_sets FOR EACH ROW EXECUTE FUNCTION public.match_summary_on_set();
+
+CREATE TRIGGER players_summary AFTER UPDATE OF first_name, last_name ON public.players FOR EACH ROW EXECUTE FUNCTION public.match_summary_on_player();
+
+CREATE TRIGGER point_events_notify AFTER INSERT ON public.point_events FOR EACH ROW EXECUTE FUNCTION public.notify_point_event();
+
 ALTER TABLE ONLY public.game_points
     ADD CONSTRAINT game_points_matchid_fkey FOREIGN KEY (match_id) REFERENCES public.matches(id);
 
@@ -205,6 +388,9 @@ ALTER TABLE ONLY public.matches
 ALTER TABLE ONLY public.matches
     ADD CONSTRAINT matches_playerid2_fkey FOREIGN KEY (player_id2) REFERENCES public.players(id);
 
+ALTER TABLE ONLY public.match_summary
+    ADD CONSTRAINT match_summary_match_id_fkey FOREIGN KEY (match_id) REFERENCES public.matches(id) ON DELETE CASCADE;
+
 ALTER TABLE ONLY public.matches_sets
     ADD CONSTRAINT matches_sets_matchid_fkey FOREIGN KEY (match_id) REFERENCES public.matches(id);
 
@@ -214,6 +400,9 @@ ALTER TABLE ONLY public.matches
 ALTER TABLE ONLY public.matches
     ADD CONSTRAINT matches_winnerid_fkey FOREIGN KEY (winner_id) REFERENCES public.players(id);
 
+ALTER TABLE ONLY public.point_events
+    ADD CONSTRAINT point_events_match_id_fkey FOREIGN KEY (match_id) REFERENCES public.matches(id);
+
 ALTER TABLE ONLY public.tie_breaks
     ADD CONSTRAINT tie_breaks_match_id_fkey FOREIGN KEY (match_id) REFERENCES public.matches(id);
 
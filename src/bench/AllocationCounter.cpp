@@ -0,0 +1,37 @@
+#include "AllocationCounter.hpp"
+#include <cstdlib>
+#include <new>
+
+static thread_local std::uint64_t thread_allocations = 0;
+
+std::uint64_t AllocationCounter::current() {
+    return thread_allocations;
+}
+
+void* operator new(const std::size_t size) {
+    ++thread_allocations;
+    if (void* memory = std::malloc(size == 0 ? 1 : size)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](const std::size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
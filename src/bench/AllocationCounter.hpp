@@ -0,0 +1,19 @@
+#pragma once
+#include <benchmark/benchmark.h>
+#include <cstdint>
+
+// Counts operator new calls made by the calling thread; the persistence queue's worker is not included.
+class AllocationCounter {
+public:
+	static std::uint64_t current();
+
+	AllocationCounter() : started_(current()) {}
+
+	// Reports allocations per iteration as the "allocs" counter.
+	void report(benchmark::State& state) const {
+		state.counters["allocs"] = benchmark::Counter(static_cast<double>(current() - started_), benchmark::Counter::kAvgIterations);
+	}
+
+private:
+	std::uint64_t started_;
+};
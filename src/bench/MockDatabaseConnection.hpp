@@ -0,0 +1,22 @@
+#pragma once
+#include "IDatabaseConnection.hpp"
+#include <atomic>
+#include <stdexcept>
+
+// Stands in for PostgreSQL as the persistence queue's sink: every transaction is accepted and counted without running
+// its writes. Benchmarks against it measure the scoring path's own cost, including building and queueing its writes.
+class MockDatabaseConnection : public IDatabaseConnection {
+public:
+	ConnectionLease acquire() override {
+		throw std::runtime_error("The mock database has no connections.");
+	}
+
+	void runTransaction(const std::string&, const std::function<void(pqxx::work&)>&) override {
+		++transactions_;
+	}
+
+	unsigned long long getTransactions() const { return transactions_; }
+
+private:
+	std::atomic<unsigned long long> transactions_{ 0 };
+};
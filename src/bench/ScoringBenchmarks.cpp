@@ -0,0 +1,298 @@
+#include "AllocationCounter.hpp"
+#include "MockDatabaseConnection.hpp"
+#include "DatabaseConnection.hpp"
+#include "Game.hpp"
+#include "Match.hpp"
+#include "PersistenceQueue.hpp"
+#include "PointLog.hpp"
+#include "PreparedStatements.hpp"
+#include "ReferenceData.hpp"
+#include "ScoringEngine.hpp"
+#include "Set.hpp"
+#include "Tiebreak.hpp"
+#include "UnitOfWork.hpp"
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <iostream>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+// Scoring hot path benchmarks. Run with --database=mock (default) to measure the code alone, or --database=postgres
+// to include the local database the app uses. Results are written as JSON to bench_results.json unless
+// --benchmark_out is given, so runs from two commits can be compared with Google Benchmark's compare.py.
+
+struct BenchEnvironment {
+    bool is_postgres = false;
+    int player_id1 = 1;
+    int player_id2 = 2;
+    // Points, games and tiebreaks are scored against one match; resume reads another holding a short recorded log.
+    int scoring_match_id = 1;
+    int resume_match_id = 2;
+    MockDatabaseConnection mock;
+};
+
+static BenchEnvironment environment;
+
+// The app reports every point on std::cout; the benchmarks keep the formatting but drop the text.
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(const int c) override { return traits_type::not_eof(c); }
+    std::streamsize xsputn(const char*, const std::streamsize count) override { return count; }
+};
+
+static int nextPlayer(std::uint32_t& seed) {
+    seed = seed * 1664525u + 1013904223u;
+    return (seed >> 16) % 100 < 55 ? 1 : 2;
+}
+
+static void finishRun(benchmark::State& state, const AllocationCounter& allocations) {
+    allocations.report(state);
+    state.SetItemsProcessed(state.iterations());
+    state.PauseTiming();
+    PersistenceQueue::getInstance().flush();
+    state.ResumeTiming();
+}
+
+static void BM_GameAddPoint(benchmark::State& state) {
+    Game game;
+    game.setIsPlayerOneServing(true);
+    std::uint32_t seed = 7;
+    const AllocationCounter allocations;
+
+    for (auto _ : state) {
+        game.addPoint(nextPlayer(seed), environment.scoring_match_id, 1);
+        if (game.isWonGame()) {
+            game = Game();
+            game.setIsPlayerOneServing(true);
+        }
+    }
+    finishRun(state, allocations);
+}
+BENCHMARK(BM_GameAddPoint);
+
+static void BM_TiebreakAddPoint(benchmark::State& state) {
+    const int max_points = static_cast<int>(state.range(0));
+    Tiebreak tiebreak(true, 1, max_points);
+    std::uint32_t seed = 11;
+    const AllocationCounter allocations;
+
+    for (auto _ : state) {
+        tiebreak.addPoint(nextPlayer(seed), environment.scoring_match_id);
+        if (tiebreak.isTiebreakWon()) {
+            tiebreak = Tiebreak(true, 1, max_points);
+        }
+        tiebreak.updateIsPlayerOneServing();
+    }
+    finishRun(state, allocations);
+}
+BENCHMARK(BM_TiebreakAddPoint)->Arg(ScoringEngine::TIEBREAK_POINTS)->Arg(ScoringEngine::SUPER_TIEBREAK_POINTS);
+
+// Game results that finish a set 6-4 without reaching a tiebreak, each in its own unit of work as UIManager does.
+static void BM_SetAddGameResult(benchmark::State& state) {
+    static constexpr int WINNERS[] = { 1, 2, 1, 2, 1, 2, 1, 2, 1, 1 };
+    Set set(environment.scoring_match_id, 3, 1, 0, 0, true);
+    std::size_t game = 0;
+    const AllocationCounter allocations;
+
+    for (auto _ : state) {
+        UnitOfWork uow(environment.scoring_match_id);
+        set.addGameResult(WINNERS[game], uow);
+        uow.commit();
+        if (++game == std::size(WINNERS)) {
+            game = 0;
+            set = Set(environment.scoring_match_id, 3, 1, 0, 0, true);
+        }
+    }
+    finishRun(state, allocations);
+}
+BENCHMARK(BM_SetAddGameResult);
+
+// From 6-5 the game for 6-6 starts a tiebreak, which reads its points from std::cin; player 1 takes every point.
+// Argument 1 is a regular tiebreak in the first set, 5 a super-tiebreak in the deciding set of a best of five.
+static void BM_SetAddGameResultTiebreak(benchmark::State& state) {
+    const int set_num = static_cast<int>(state.range(0));
+    const int points = ScoringEngine::tiebreakPoints(set_num, 3);
+    std::string choices;
+    for (int i = 0; i < points; ++i) {
+        choices += "1\n";
+    }
+
+    std::streambuf* const original_input = std::cin.rdbuf();
+    const AllocationCounter allocations;
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::istringstream input(choices);
+        std::cin.rdbuf(input.rdbuf());
+        Set set(environment.scoring_match_id, 3, set_num, 6, 5, true);
+        UnitOfWork uow(environment.scoring_match_id);
+        state.ResumeTiming();
+
+        benchmark::DoNotOptimize(set.addGameResult(2, uow));
+        uow.commit();
+    }
+    std::cin.rdbuf(original_input);
+
+    allocations.report(state);
+    state.SetItemsProcessed(state.iterations() * points);
+    state.PauseTiming();
+    PersistenceQueue::getInstance().flush();
+    state.ResumeTiming();
+}
+BENCHMARK(BM_SetAddGameResultTiebreak)->Arg(1)->Arg(5);
+
+static void BM_MatchIsPlayerOneServing(benchmark::State& state) {
+    int total_games = 0;
+    bool is_first_player_starting = true;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Match::isPlayerOneServing(total_games, is_first_player_starting));
+        if (++total_games == 13) {
+            total_games = 0;
+            is_first_player_starting = !is_first_player_starting;
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MatchIsPlayerOneServing);
+
+// A best-of-five match played out point by point, for replaying without a database.
+static std::vector<PointEvent> recordMatch(const int no_sets, std::uint32_t seed) {
+    std::vector<PointEvent> events;
+    MatchScore score;
+    score.no_sets = no_sets;
+    while (!score.isFinished()) {
+        const int winner = nextPlayer(seed);
+        events.push_back(PointEvent{ static_cast<int>(events.size()) + 1, winner, score.is_player_one_serving });
+        ScoringEngine::scorePoint(score, winner);
+    }
+    return events;
+}
+
+// The resume path: with the mock, rebuilding the score from a recorded point log; against PostgreSQL,
+// Match::resumeMatch end to end (status update, set lookup, point log replay and the current game).
+static void BM_ResumeMatch(benchmark::State& state) {
+    const AllocationCounter allocations;
+    if (!environment.is_postgres) {
+        const std::vector<PointEvent> events = recordMatch(3, 5);
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(PointLog::replay(3, events));
+        }
+        allocations.report(state);
+        state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(events.size()));
+        return;
+    }
+
+    for (auto _ : state) {
+        Match match(environment.resume_match_id, environment.player_id1, environment.player_id2, 3, std::chrono::seconds(0));
+        match.resumeMatch(environment.resume_match_id);
+        benchmark::DoNotOptimize(match.getCurrentSet());
+    }
+    allocations.report(state);
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ResumeMatch);
+
+// Two players and two matches of their own, plus a partly played set on the resume match for Match::resumeMatch.
+static bool preparePostgres() {
+    try {
+        ConnectionLease lease = DatabaseConnection::getInstance().acquire();
+        pqxx::work txn(*lease);
+        environment.player_id1 = txn.exec("INSERT INTO public.players (first_name, last_name) VALUES ('Bench', 'One') RETURNING id")[0][0].as<int>();
+        environment.player_id2 = txn.exec("INSERT INTO public.players (first_name, last_name) VALUES ('Bench', 'Two') RETURNING id")[0][0].as<int>();
+
+        const std::string insert_match = "INSERT INTO public.matches (status_id, player_id1, player_id2, predicted_start_time, duration, no_sets) "
+            "VALUES ($1, $2, $3, now(), interval '0 minutes', 3) RETURNING id";
+        const int suspended = ReferenceData::getInstance().getStatusId("Suspended");
+        environment.scoring_match_id = txn.exec_params(insert_match, suspended, environment.player_id1, environment.player_id2)[0][0].as<int>();
+        environment.resume_match_id = txn.exec_params(insert_match, suspended, environment.player_id1, environment.player_id2)[0][0].as<int>();
+
+        std::vector<PointEvent> events = recordMatch(3, 9);
+        events.resize(events.size() / 4);
+        MatchScore score = PointLog::replay(3, events);
+        for (const auto& event : events) {
+            PreparedStatements::exec<InsertPointEventQuery>(txn, environment.resume_match_id, event.seq, event.winner, event.is_player_one_serving);
+        }
+        PreparedStatements::exec<InsertMatchSetQuery>(txn, environment.resume_match_id, score.getSetNum(), score.games_player1, score.games_player2, true);
+        PreparedStatements::exec<InsertGamePointsQuery>(txn, environment.resume_match_id, score.getSetNum(), score.games_player1 + score.games_player2 + 1,
+            Game::getScoreString(score.points_player1), Game::getScoreString(score.points_player2));
+        txn.commit();
+        return true;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Cannot prepare benchmark data in PostgreSQL: " << e.what() << '\n';
+        return false;
+    }
+}
+
+static void cleanUpPostgres() {
+    try {
+        ConnectionLease lease = DatabaseConnection::getInstance().acquire();
+        pqxx::work txn(*lease);
+        const std::string matches = std::to_string(environment.scoring_match_id) + ", " + std::to_string(environment.resume_match_id);
+        for (const char* table : { "point_events", "game_points", "tie_breaks", "matches_sets" }) {
+            txn.exec(std::string("DELETE FROM public.") + table + " WHERE match_id IN (" + matches + ")");
+        }
+        txn.exec("DELETE FROM public.matches WHERE id IN (" + matches + ")");
+        txn.exec("DELETE FROM public.players WHERE id IN (" + std::to_string(environment.player_id1) + ", " + std::to_string(environment.player_id2) + ")");
+        txn.commit();
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Cannot remove benchmark data from PostgreSQL: " << e.what() << '\n';
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<char*> args;
+    bool has_output = false;
+    for (int i = 0; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--database=postgres") == 0) {
+            environment.is_postgres = true;
+        }
+        else if (std::strcmp(argv[i], "--database=mock") != 0) {
+            has_output = has_output || std::strncmp(argv[i], "--benchmark_out=", 16) == 0;
+            args.push_back(argv[i]);
+        }
+    }
+    std::string out_flag = "--benchmark_out=bench_results.json";
+    std::string format_flag = "--benchmark_out_format=json";
+    if (!has_output) {
+        args.push_back(out_flag.data());
+        args.push_back(format_flag.data());
+    }
+
+    int bench_argc = static_cast<int>(args.size());
+    benchmark::Initialize(&bench_argc, args.data());
+    if (benchmark::ReportUnrecognizedArguments(bench_argc, args.data())) {
+        return 1;
+    }
+
+    if (environment.is_postgres) {
+        ReferenceData::getInstance().refresh();
+        if (!preparePostgres()) {
+            return 1;
+        }
+    }
+    else {
+        PersistenceQueue::getInstance().setDatabase(&environment.mock);
+        PointLog::getInstance().setLastSeq(environment.scoring_match_id, 0);
+    }
+    benchmark::AddCustomContext("database", environment.is_postgres ? "postgres" : "mock");
+
+    std::ostream console(std::cout.rdbuf());
+    NullBuffer discard;
+    std::cout.rdbuf(&discard);
+    benchmark::ConsoleReporter display;
+    display.SetOutputStream(&console);
+    display.SetErrorStream(&std::cerr);
+    benchmark::RunSpecifiedBenchmarks(&display);
+    std::cout.rdbuf(console.rdbuf());
+
+    if (environment.is_postgres) {
+        cleanUpPostgres();
+    }
+    benchmark::Shutdown();
+    return 0;
+}
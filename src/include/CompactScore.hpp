@@ -0,0 +1,121 @@
+#pragma once
+#include "ScoringTables.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+
+// Whole match score packed into one 64-bit word: cheap to copy, hash, compare and send over the wire.
+class CompactScore {
+private:
+	static constexpr unsigned POINTS_PLAYER1_SHIFT = 0;
+	static constexpr unsigned POINTS_PLAYER2_SHIFT = 8;
+	static constexpr unsigned GAMES_PLAYER1_SHIFT = 16;
+	static constexpr unsigned GAMES_PLAYER2_SHIFT = 20;
+	static constexpr unsigned SETS_PLAYER1_SHIFT = 24;
+	static constexpr unsigned SETS_PLAYER2_SHIFT = 27;
+	static constexpr unsigned NO_SETS_SHIFT = 30;
+	static constexpr unsigned TIEBREAK_SHIFT = 33;
+	static constexpr unsigned SERVER_SHIFT = 34;
+	static constexpr unsigned WINNER_SHIFT = 35;
+
+	static constexpr std::uint64_t POINTS_MASK = 0xFF;
+	static constexpr std::uint64_t GAMES_MASK = 0xF;
+	static constexpr std::uint64_t SETS_MASK = 0x7;
+	static constexpr std::uint64_t FLAG_MASK = 0x1;
+	static constexpr std::uint64_t WINNER_MASK = 0x3;
+
+	std::uint64_t bits_ = 0;
+
+	constexpr explicit CompactScore(const std::uint64_t bits) : bits_(bits) {}
+
+	constexpr int field(const unsigned shift, const std::uint64_t mask) const {
+		return static_cast<int>((bits_ >> shift) & mask);
+	}
+
+	static constexpr std::uint64_t pack(const int value, const unsigned shift, const std::uint64_t mask) {
+		const std::uint64_t clamped = value < 0 ? 0 : (static_cast<std::uint64_t>(value) > mask ? mask : static_cast<std::uint64_t>(value));
+		return clamped << shift;
+	}
+
+public:
+	static constexpr int MAX_POINTS = static_cast<int>(POINTS_MASK);
+	static constexpr int MAX_NO_SETS = static_cast<int>(SETS_MASK);
+
+	constexpr CompactScore() = default;
+
+	// Tiebreak points saturate at MAX_POINTS; no real tiebreak gets close.
+	static constexpr CompactScore fromMatchScore(const MatchScore& score) {
+		return CompactScore(
+			pack(score.points_player1, POINTS_PLAYER1_SHIFT, POINTS_MASK) |
+			pack(score.points_player2, POINTS_PLAYER2_SHIFT, POINTS_MASK) |
+			pack(score.games_player1, GAMES_PLAYER1_SHIFT, GAMES_MASK) |
+			pack(score.games_player2, GAMES_PLAYER2_SHIFT, GAMES_MASK) |
+			pack(score.sets_player1, SETS_PLAYER1_SHIFT, SETS_MASK) |
+			pack(score.sets_player2, SETS_PLAYER2_SHIFT, SETS_MASK) |
+			pack(score.no_sets, NO_SETS_SHIFT, SETS_MASK) |
+			pack(score.is_tiebreak ? 1 : 0, TIEBREAK_SHIFT, FLAG_MASK) |
+			pack(score.is_player_one_serving ? 1 : 0, SERVER_SHIFT, FLAG_MASK) |
+			pack(score.winner, WINNER_SHIFT, WINNER_MASK));
+	}
+
+	static constexpr CompactScore fromBits(const std::uint64_t bits) { return CompactScore(bits); }
+	static constexpr CompactScore start(const int no_sets, const bool is_player_one_serving) {
+		MatchScore score;
+		score.no_sets = no_sets;
+		score.is_player_one_serving = is_player_one_serving;
+		return fromMatchScore(score);
+	}
+
+	constexpr MatchScore toMatchScore() const {
+		MatchScore score;
+		score.no_sets = getNoSets();
+		score.sets_player1 = getSetsPlayerOne();
+		score.sets_player2 = getSetsPlayerTwo();
+		score.games_player1 = getGamesPlayerOne();
+		score.games_player2 = getGamesPlayerTwo();
+		score.points_player1 = getPointsPlayerOne();
+		score.points_player2 = getPointsPlayerTwo();
+		score.is_tiebreak = getIsTiebreak();
+		score.is_player_one_serving = getIsPlayerOneServing();
+		score.winner = getWinner();
+		return score;
+	}
+
+	constexpr std::uint64_t getBits() const { return bits_; }
+	constexpr int getPointsPlayerOne() const { return field(POINTS_PLAYER1_SHIFT, POINTS_MASK); }
+	constexpr int getPointsPlayerTwo() const { return field(POINTS_PLAYER2_SHIFT, POINTS_MASK); }
+	constexpr int getGamesPlayerOne() const { return field(GAMES_PLAYER1_SHIFT, GAMES_MASK); }
+	constexpr int getGamesPlayerTwo() const { return field(GAMES_PLAYER2_SHIFT, GAMES_MASK); }
+	constexpr int getSetsPlayerOne() const { return field(SETS_PLAYER1_SHIFT, SETS_MASK); }
+	constexpr int getSetsPlayerTwo() const { return field(SETS_PLAYER2_SHIFT, SETS_MASK); }
+	constexpr int getNoSets() const { return field(NO_SETS_SHIFT, SETS_MASK); }
+	constexpr bool getIsTiebreak() const { return field(TIEBREAK_SHIFT, FLAG_MASK) != 0; }
+	constexpr bool getIsPlayerOneServing() const { return field(SERVER_SHIFT, FLAG_MASK) != 0; }
+	constexpr int getWinner() const { return field(WINNER_SHIFT, WINNER_MASK); }
+	constexpr int getSetNum() const { return getSetsPlayerOne() + getSetsPlayerTwo() + 1; }
+	constexpr bool isFinished() const { return getWinner() != 0; }
+
+	constexpr PointResult addPoint(const int player) {
+		MatchScore score = toMatchScore();
+		const PointResult result = ScoringTables::scorePoint(score, player);
+		*this = fromMatchScore(score);
+		return result;
+	}
+
+	friend constexpr bool operator==(const CompactScore& lhs, const CompactScore& rhs) { return lhs.bits_ == rhs.bits_; }
+	friend constexpr bool operator!=(const CompactScore& lhs, const CompactScore& rhs) { return lhs.bits_ != rhs.bits_; }
+	friend constexpr bool operator<(const CompactScore& lhs, const CompactScore& rhs) { return lhs.bits_ < rhs.bits_; }
+};
+
+static_assert(sizeof(CompactScore) == sizeof(std::uint64_t), "CompactScore must stay one word.");
+static_assert(std::is_trivially_copyable<CompactScore>::value, "CompactScore must be trivially copyable.");
+
+namespace std {
+	template<>
+	struct hash<CompactScore> {
+		size_t operator()(const CompactScore& score) const noexcept {
+			return hash<uint64_t>()(score.getBits());
+		}
+	};
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include "IDatabaseConnection.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+struct PoolMetrics {
+	std::size_t size = 0;
+	std::size_t open = 0;
+	std::size_t idle = 0;
+	unsigned long long checkouts = 0;
+	unsigned long long blocked_checkouts = 0;
+	unsigned long long timeouts = 0;
+	unsigned long long failed_health_checks = 0;
+	unsigned long long reconnects = 0;
+	std::chrono::microseconds total_wait{ 0 };
+	std::chrono::microseconds max_wait{ 0 };
+};
+
+class ConnectionPool : public IDatabaseConnection {
+public:
+	using Factory = std::function<std::unique_ptr<pqxx::connection>()>;
+
+	ConnectionPool(Factory factory, std::size_t size,
+		std::chrono::milliseconds checkout_timeout = std::chrono::seconds(30));
+	~ConnectionPool() override;
+
+	ConnectionPool(const ConnectionPool&) = delete;
+	ConnectionPool& operator=(const ConnectionPool&) = delete;
+
+	ConnectionLease acquire() override;
+
+	std::size_t size() const { return size_; }
+	std::size_t healthCheck();
+	PoolMetrics getMetrics() const;
+	void close();
+
+private:
+	Factory factory_;
+	std::size_t size_;
+	std::chrono::milliseconds checkout_timeout_;
+
+	std::vector<std::unique_ptr<pqxx::connection>> connections_;
+	std::vector<pqxx::connection*> idle_;
+	std::size_t opening_ = 0;
+	bool is_closed_ = false;
+
+	mutable std::mutex mutex_;
+	std::condition_variable available_;
+	PoolMetrics metrics_;
+
+	void release(pqxx::connection* conn);
+	pqxx::connection* open();
+	pqxx::connection* replace(pqxx::connection* conn);
+	static bool isHealthy(pqxx::connection& conn);
+	void recordWait(std::chrono::steady_clock::duration waited, bool was_blocked);
+};
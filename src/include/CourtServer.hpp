@@ -0,0 +1,61 @@
+#pragma once
+#include "MatchActor.hpp"
+#include "ThreadPool.hpp"
+#include <future>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+enum class SuspendResult {
+	SUSPENDED,
+	NOT_LIVE,
+	NOT_SAVED
+};
+
+// Headless scoring for many courts at once: every open match is a MatchActor on a shared work-stealing pool.
+class CourtServer {
+public:
+	explicit CourtServer(unsigned threads = 0, bool is_persistent = true);
+
+	// A Started match may still be scored by the console or another server, so it is only opened as a takeover, once
+	// the caller knows its previous scorer is gone (e.g. after a crash). Returns true if the match is open here.
+	bool openMatch(int match_id, bool is_player_one_serving = true, bool is_takeover = false);
+	bool openMatch(const MatchInfo& info);
+	void closeMatch(int match_id);
+	SuspendResult suspendMatch(int match_id);
+
+	std::future<PointAck> submitPoint(int match_id, int player);
+	std::future<PointAck> finishMatch(int match_id, int winner);
+	void submitPoint(int match_id, int player, MatchActor::AckCallback on_ack);
+	void finishMatch(int match_id, int winner, MatchActor::AckCallback on_ack);
+	std::optional<CompactScore> getScore(int match_id) const;
+	std::vector<int> getMatchIds() const;
+	ThreadPool& getPool() { return pool_; }
+
+	// Line protocol for clients on a pipe: "open <match_id> [server] [takeover]", "point <match_id> <player>", "score <match_id>",
+	// "suspend <match_id>", "finish <match_id> <winner>", "close <match_id>", "quit". Points and finishes are acked as
+	// their match handles them, so the next command is read straight away; acks name their match and may arrive out of
+	// order across matches. Several clients can be served at once, each by its own run() on its own thread.
+	void run(std::istream& in, std::ostream& out);
+
+private:
+	class AckWriter;
+
+	ThreadPool pool_;
+	bool is_persistent_;
+
+	mutable std::shared_mutex matches_mutex_;
+	std::unordered_map<int, std::shared_ptr<MatchActor>> matches_;
+
+	std::shared_ptr<MatchActor> findMatch(int match_id) const;
+	std::shared_ptr<MatchActor> takeMatch(int match_id);
+	bool insertMatch(const MatchInfo& info, bool is_marking_started);
+	static std::optional<MatchInfo> loadMatch(int match_id, bool is_player_one_serving);
+	static bool isOpenable(int status_id, bool is_takeover);
+	static void printAck(std::ostream& out, const PointAck& ack);
+	static PointAck rejectedAck(int match_id);
+	static std::future<PointAck> rejected(int match_id);
+};
@@ -1,12 +1,19 @@
 #pragma once
 #include "IDatabaseConnection.hpp"
+#include "ConnectionPool.hpp"
 #include <pqxx/pqxx>
 #include <memory>
 
 class DatabaseConnection : public IDatabaseConnection {
 public:
+	static constexpr std::size_t DEFAULT_POOL_SIZE = 4;
+
 	static DatabaseConnection& getInstance();
-	pqxx::connection* getConnection() override;
+	static void setPoolSize(std::size_t size);
+	ConnectionLease acquire() override;
+	ConnectionPool& getPool() const { return *pool_; }
+	// A connection outside the pool, for long-lived work such as LISTEN that must not hold a pool slot.
+	static std::unique_ptr<pqxx::connection> initializeConnection();
 
 	DatabaseConnection(const DatabaseConnection&) = delete;
 	DatabaseConnection& operator=(const DatabaseConnection&) = delete;
@@ -14,9 +21,9 @@ public:
 	~DatabaseConnection() override;
 
 private:
-	std::unique_ptr<pqxx::connection> conn_;
+	static std::size_t pool_size_;
+	std::unique_ptr<ConnectionPool> pool_;
 	DatabaseConnection();
-	void initializeConnection();
 	static void handleException(const std::exception& e);
 	void closeConnection() const;
-};
\ No newline at end of file
+};
@@ -0,0 +1,31 @@
+#pragma once
+#include <cstddef>
+#include <initializer_list>
+#include <istream>
+#include <optional>
+#include <string>
+#include <vector>
+
+struct DelimitedRecord {
+	std::size_t line;
+	std::vector<std::string> fields;
+};
+
+// Line 0 is used for errors that concern the whole file rather than one record.
+struct ImportError {
+	std::size_t line;
+	std::string message;
+};
+
+// CSV/TSV reader shared by the bulk importers. The delimiter (tab, semicolon or comma) is detected from the first
+// non-blank line; fields are trimmed and may be double-quoted, but a quoted field may not span lines.
+class DelimitedFile {
+public:
+	static std::vector<DelimitedRecord> read(std::istream& in);
+	static std::optional<std::size_t> findColumn(const std::vector<std::string>& header, std::initializer_list<const char*> names);
+	static std::string trim(const std::string& value);
+
+private:
+	static char detectDelimiter(const std::string& line);
+	static std::vector<std::string> splitRecord(const std::string& line, char delimiter);
+};
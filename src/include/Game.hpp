@@ -1,4 +1,7 @@
 #pragma once
+#include "PersistenceQueue.hpp"
+#include "ScoringEngine.hpp"
+#include "UnitOfWork.hpp"
 #include <iostream>
 #include <string>
 
@@ -9,13 +12,15 @@ private:
     int game_num;
     bool is_player_one_serving;
 
-    static std::string getScoreString(int points);
-
 public:
+    static std::string getScoreString(int points);
     Game();
     Game(int points_player1, int points_player2, int game_num);
 
     int getGameNum() const { return game_num; }
+    int getPointsPlayerOne() const { return points_player1; }
+    int getPointsPlayerTwo() const { return points_player2; }
+    bool getIsPlayerOneServing() const { return is_player_one_serving; }
     void setGameNum(const int game_num) { this->game_num = game_num; }
     void setIsPlayerOneServing(const bool is_serving) { is_player_one_serving = is_serving; }
 
@@ -23,14 +28,11 @@ public:
 
     void checkServer();
     int determineWinner() const;
-    void resetGame(int match_id, int set_num);
-    bool isWonGame() const {
-        return (points_player1 >= 4 && points_player1 >= points_player2 + 2) ||
-            (points_player2 >= 4 && points_player2 >= points_player1 + 2);
-    }
+    void resetGame(int match_id, int set_num, UnitOfWork& uow);
+    bool isWonGame() const { return ScoringEngine::gameWinner(points_player1, points_player2) != 0; }
 
-    void saveGameRecordToDatabase(bool is_new_record, int match_id, int set_num) const;
-    void saveGameRecord(int match_id, int set_num) const;
+    PersistenceQueue::Write gameRecordWrite(bool is_new_record, int match_id, int set_num) const;
+    void saveGameRecord(int match_id, int set_num, UnitOfWork& uow) const;
     void updateGameRecord(int match_id, int set_num) const;
 
     void printCurScore() const { std::cout << "Current score in " << game_num << " game: \t" << getScoreString(points_player1)
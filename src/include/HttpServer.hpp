@@ -0,0 +1,98 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+
+struct HttpRequest {
+	std::string method;
+	std::string path;
+	std::map<std::string, std::string> query;
+	std::map<std::string, std::string> headers;
+	std::string body;
+	std::size_t content_length = 0;
+};
+
+// Lets a handler keep writing to its connection after the headers, e.g. for server-sent events.
+class HttpStream {
+public:
+	HttpStream(std::intptr_t socket, const std::atomic<bool>& is_running) : socket_(socket), is_running_(is_running) {}
+
+	bool write(const std::string& data);
+	bool isOpen() const { return is_open_ && is_running_; }
+
+private:
+	std::intptr_t socket_;
+	const std::atomic<bool>& is_running_;
+	bool is_open_ = true;
+};
+
+struct HttpResponse {
+	int status = 200;
+	std::string content_type = "application/json";
+	std::string body;
+	// When set, the body is ignored and the connection is handed to this callback until it returns.
+	std::function<void(HttpStream&)> stream;
+
+	static HttpResponse json(const int status, std::string body) { return HttpResponse{ status, "application/json", std::move(body), nullptr }; }
+	static HttpResponse error(int status, const std::string& message);
+	static HttpResponse eventStream(std::function<void(HttpStream&)> stream);
+};
+
+// Minimal HTTP/1.1 server over plain sockets (Winsock on Windows, BSD sockets elsewhere) with keep-alive.
+// Every connection gets its own thread, capped at max_connections; open event streams count towards the cap.
+// There is no authentication, so it listens on loopback unless another IPv4 address, e.g. 0.0.0.0, is passed.
+class HttpServer {
+public:
+	using Handler = std::function<HttpResponse(const HttpRequest&)>;
+
+	static constexpr std::size_t MAX_REQUEST_BYTES = 64 * 1024;
+	static constexpr int IDLE_TIMEOUT_SECONDS = 5;
+	static constexpr const char* DEFAULT_BIND_ADDRESS = "127.0.0.1";
+	static constexpr std::chrono::milliseconds MIN_ACCEPT_BACKOFF{ 10 };
+	static constexpr std::chrono::milliseconds MAX_ACCEPT_BACKOFF{ 1000 };
+
+	HttpServer(unsigned short port, Handler handler, std::size_t max_connections = 256,
+		std::string bind_address = DEFAULT_BIND_ADDRESS);
+	~HttpServer();
+
+	HttpServer(const HttpServer&) = delete;
+	HttpServer& operator=(const HttpServer&) = delete;
+
+	bool start();
+	void stop();
+	unsigned short getPort() const { return port_; }
+	const std::string& getBindAddress() const { return bind_address_; }
+	unsigned long long getRequestCount() const { return requests_.load(std::memory_order_relaxed); }
+
+	static std::string urlDecode(const std::string& value);
+
+private:
+	unsigned short port_;
+	Handler handler_;
+	std::size_t max_connections_;
+	std::string bind_address_;
+
+	std::intptr_t listen_socket_ = -1;
+	std::thread acceptor_;
+	std::atomic<bool> is_running_{ false };
+	std::atomic<unsigned long long> requests_{ 0 };
+
+	std::mutex connections_mutex_;
+	std::condition_variable connections_done_;
+	std::size_t active_connections_ = 0;
+	std::set<std::intptr_t> open_clients_;
+
+	void acceptLoop();
+	void serveConnection(std::intptr_t client);
+	static bool parseRequest(const std::string& head, HttpRequest& request);
+	static std::string serialize(const HttpResponse& response, bool is_keep_alive);
+	static std::string streamHeader(const HttpResponse& response);
+	static const char* reasonPhrase(int status);
+};
@@ -1,8 +1,65 @@
 #pragma once
+#include "QueryMetrics.hpp"
 #include <pqxx/pqxx>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+class ConnectionLease {
+private:
+    pqxx::connection* conn_ = nullptr;
+    std::function<void(pqxx::connection*)> release_;
+
+public:
+    ConnectionLease() = default;
+    ConnectionLease(pqxx::connection* conn, std::function<void(pqxx::connection*)> release)
+        : conn_(conn), release_(std::move(release)) {}
+
+    ConnectionLease(const ConnectionLease&) = delete;
+    ConnectionLease& operator=(const ConnectionLease&) = delete;
+
+    ConnectionLease(ConnectionLease&& other) noexcept
+        : conn_(std::exchange(other.conn_, nullptr)), release_(std::move(other.release_)) {}
+
+    ConnectionLease& operator=(ConnectionLease&& other) noexcept {
+        if (this != &other) {
+            reset();
+            conn_ = std::exchange(other.conn_, nullptr);
+            release_ = std::move(other.release_);
+        }
+        return *this;
+    }
+
+    ~ConnectionLease() { reset(); }
+
+    void reset() {
+        if (conn_ && release_) {
+            release_(conn_);
+        }
+        conn_ = nullptr;
+    }
+
+    pqxx::connection* get() const { return conn_; }
+    pqxx::connection& operator*() const { return *conn_; }
+    pqxx::connection* operator->() const { return conn_; }
+    explicit operator bool() const { return conn_ != nullptr; }
+};
 
 class IDatabaseConnection {
 public:
     virtual ~IDatabaseConnection() = default;
-    virtual pqxx::connection* getConnection() = 0;
-};
\ No newline at end of file
+    virtual ConnectionLease acquire() = 0;
+
+    // Runs work in one transaction traced under name and commits it. Throws if no connection can be had or the work
+    // fails, so callers treat both the same way.
+    virtual void runTransaction(const std::string& name, const std::function<void(pqxx::work&)>& work) {
+        ConnectionLease lease = acquire();
+        if (!lease) {
+            throw std::runtime_error("No database connection for " + name + ".");
+        }
+        TracedWork txn(*lease, name);
+        work(txn.get());
+        txn.commit();
+    }
+};
@@ -0,0 +1,28 @@
+#pragma once
+#include <pqxx/pqxx>
+#include <cstddef>
+#include <functional>
+#include <string>
+
+// Walks a listing one page at a time with "key > last ORDER BY key LIMIT n", so neither the result nor the rendered
+// table ever holds more than one page however long the history grows. The key column must be selected first.
+class KeysetPager {
+public:
+	static constexpr int DEFAULT_PAGE_SIZE = 50;
+
+	using RenderPage = std::function<void(const pqxx::result&)>;
+	using WantsMore = std::function<bool()>;
+
+	// select is everything before WHERE; filter, if given, is ANDed with the keyset condition.
+	KeysetPager(std::string select, std::string key_column, std::string filter = "", int page_size = DEFAULT_PAGE_SIZE);
+
+	pqxx::result fetch(pqxx::transaction_base& txn, long long after) const;
+	// Renders pages until the listing ends or wants_more returns false. Returns the number of rows shown.
+	std::size_t run(const RenderPage& render, const WantsMore& wants_more = &KeysetPager::promptForMore) const;
+
+	static bool promptForMore();
+
+private:
+	std::string query_;
+	int page_size_;
+};
@@ -0,0 +1,77 @@
+#pragma once
+#include "CompactScore.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+struct LiveMatch {
+	int match_id = 0;
+	int status_id = 0;
+	int player_id1 = 0;
+	int player_id2 = 0;
+	std::string player1_name;
+	std::string player2_name;
+	CompactScore score;
+};
+
+// Process-wide live state of every match this process has seen started, suspended or finished. Readers never lock:
+// each slot's match id, score and status sit behind a seqlock, and its players are an immutable snapshot swapped
+// atomically. A finished match keeps its slot until a new match needs one, so the table holds at most CAPACITY
+// unfinished matches; claiming and reusing slots is serialised by a mutex.
+class LiveScoreCache {
+public:
+	static constexpr std::size_t CAPACITY = 8192;
+
+	static LiveScoreCache& getInstance();
+
+	// Adds the match if it is new, then sets its score and status. Returns false when every slot holds an
+	// unfinished match.
+	bool upsert(const LiveMatch& match);
+	// A status_id of 0 keeps the current status.
+	bool update(int match_id, const CompactScore& score, int status_id = 0);
+	bool setStatus(int match_id, int status_id);
+
+	std::optional<LiveMatch> get(int match_id) const;
+	std::vector<LiveMatch> getAll() const;
+	std::size_t size() const { return size_.load(std::memory_order_relaxed); }
+
+	// Loads every Started and Suspended match with one query plus one point-log replay.
+	bool warm();
+
+	LiveScoreCache(const LiveScoreCache&) = delete;
+	LiveScoreCache& operator=(const LiveScoreCache&) = delete;
+
+private:
+	struct Players {
+		int match_id = 0;
+		int player_id1 = 0;
+		int player_id2 = 0;
+		std::string player1_name;
+		std::string player2_name;
+	};
+
+	struct Slot {
+		std::atomic<int> match_id{ 0 };
+		std::atomic<std::uint32_t> seq{ 0 };
+		std::atomic<std::uint64_t> score{ 0 };
+		std::atomic<int> status_id{ 0 };
+		std::shared_ptr<const Players> players;
+	};
+
+	std::unique_ptr<Slot[]> slots_;
+	std::atomic<std::size_t> size_{ 0 };
+	std::mutex claim_mutex_;
+
+	LiveScoreCache();
+
+	Slot* find(int match_id) const;
+	Slot* claim(const LiveMatch& match);
+	static std::size_t home(int match_id);
+	static std::uint32_t lock(Slot& slot);
+	static bool write(Slot& slot, int match_id, std::optional<std::uint64_t> score, int status_id);
+	static bool read(const Slot& slot, int match_id, LiveMatch& match);
+};
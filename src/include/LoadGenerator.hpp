@@ -0,0 +1,90 @@
+#pragma once
+#include "PersistenceQueue.hpp"
+#include "QueryMetrics.hpp"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <vector>
+
+class Match;
+
+struct LoadTestParams {
+	std::size_t matches = 1000;
+	unsigned concurrency = 8;
+	int no_sets = 2;
+	double serve_win = 0.64;
+	std::uint64_t seed = 0;
+	bool is_keeping_data = false;
+};
+
+struct LatencySummary {
+	std::chrono::nanoseconds p50{ 0 };
+	std::chrono::nanoseconds p90{ 0 };
+	std::chrono::nanoseconds p99{ 0 };
+	std::chrono::nanoseconds p999{ 0 };
+	std::chrono::nanoseconds max{ 0 };
+};
+
+struct LoadTestReport {
+	std::size_t matches_planned = 0;
+	std::size_t matches_played = 0;
+	std::size_t score_mismatches = 0;
+	unsigned threads = 0;
+	unsigned long long points = 0;
+	unsigned long long tiebreak_points = 0;
+	std::chrono::milliseconds scoring_elapsed{ 0 };
+	std::chrono::milliseconds elapsed{ 0 };
+	LatencySummary latency;
+	// Server side, for the whole database: pg_stat_database, and pg_stat_statements when it is installed.
+	std::optional<long long> commits;
+	std::optional<long long> rollbacks;
+	std::optional<long long> statements;
+	// Client side, from QueryMetrics: round trips the app made, and the statements it spent the most time in.
+	unsigned long long client_round_trips = 0;
+	std::vector<StatementSummary> top_statements;
+	QueueMetrics queue;
+	unsigned long long blocked_checkouts = 0;
+	std::chrono::microseconds max_checkout_wait{ 0 };
+};
+
+// Tournament-day load: plays whole matches through Match, Set, Game and Tiebreak the way the console does, with random
+// but rule-valid points, many matches at once on their own threads. Every match gets a fresh pair of players, so no two
+// threads update the same rows. Point latency is measured from a point being played until the app is ready for the next.
+class LoadGenerator {
+public:
+	static LoadTestReport run(const LoadTestParams& params);
+	static void printReport(const LoadTestReport& report);
+	// One lease at a time per match thread, plus one for the persistence queue.
+	static std::size_t poolSizeFor(const unsigned concurrency) { return concurrency + 1; }
+	static constexpr std::size_t TOP_STATEMENTS = 5;
+
+private:
+	struct PlannedMatch {
+		int match_id;
+		int player_id1;
+		int player_id2;
+	};
+
+	struct WorkerTally {
+		std::vector<long long> latencies;
+		std::size_t matches_played = 0;
+		std::size_t score_mismatches = 0;
+		unsigned long long tiebreak_points = 0;
+	};
+
+	struct ServerCounters {
+		std::optional<long long> commits;
+		std::optional<long long> rollbacks;
+		std::optional<long long> statements;
+	};
+
+	static std::vector<PlannedMatch> createMatches(const LoadTestParams& params);
+	static void removeMatches(const std::vector<PlannedMatch>& matches);
+	static bool playMatch(const PlannedMatch& planned, std::uint64_t server_threshold, std::uint64_t& seed, WorkerTally& tally);
+	static int completeGame(Match& match, const std::function<int()>& tiebreak_input);
+	static ServerCounters readServerCounters();
+	static LatencySummary summarize(std::vector<long long>& latencies);
+	static std::uint64_t nextRandom(std::uint64_t& state);
+};
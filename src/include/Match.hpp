@@ -1,7 +1,9 @@
 #pragma once
+#include "CompactScore.hpp"
 #include "Set.hpp"
 #include "MatchState.hpp"
 #include "Timer.hpp"
+#include "UnitOfWork.hpp"
 #include <optional>
 #include <string>
 #include <chrono>
@@ -31,6 +33,10 @@ private:
 
 	void saveToDatabase(const std::string& predicted_start_time);
 	void updateStatusInDatabase() const;
+	static void flushPendingWrites();
+	void recordResult() const;
+	void resumeFromPointLog(int match_id, const MatchScore& score);
+	void resumeFromSetRecord(int match_id);
 
 	std::string getGameLabel() const { return sets_player1 + sets_player2 == 1 ? " set: \t" : " sets: \t"; }
 
@@ -63,9 +69,10 @@ public:
 	void updateSetsPlayerTwo() { sets_player2++; }
 
 	int getNoSets() const { return no_sets; }
+	CompactScore getCompactScore() const;
 
 	static bool isPlayerOneServing(const int total_games, const bool is_first_player_starting) {
-		return (total_games % 2 == 0) ? is_first_player_starting : !is_first_player_starting;
+		return ScoringEngine::isPlayerOneServing(total_games, is_first_player_starting);
 	}
 
 	std::optional<Set>& getCurrentSet() { return current_set; }
@@ -73,7 +80,7 @@ public:
 
 	void initializeCurrentSet(int match_id);
 	void resumeCurrentSet(int match_id);
-	void updateCurrentSet(int match_id);
+	void updateCurrentSet(int match_id, UnitOfWork& uow);
 
 	bool isMatchWinner() const { return sets_player1 == no_sets || sets_player2 == no_sets;  }
 
@@ -82,7 +89,12 @@ public:
 	void setWinner(int player_id) { winner_id = player_id; }
 	void resumeMatch(int match_id);
 
-	void updateMatchInDatabase();
+	void updateMatchInDatabase(UnitOfWork& uow);
+	// Gives a won game to the current set and moves on to the next game, or counts a won set and opens the next one.
+	// Returns the set's game status; suspending or finishing from a tiebreak (10, 11) is left to the caller.
+	int recordGame(int game_winner, UnitOfWork& uow, const Set::TiebreakInput& tiebreak_input = nullptr);
+	// Ends the match once a player has won no_sets sets. Returns whether it ended.
+	bool endIfWon();
 
 	void printScoreInfo() const
 	{
@@ -0,0 +1,82 @@
+#pragma once
+#include "CompactScore.hpp"
+#include "ThreadPool.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+
+struct PointAck {
+	int match_id = 0;
+	bool is_accepted = false;
+	std::uint8_t events = NO_EVENT;
+	CompactScore score;
+	std::chrono::steady_clock::time_point received_at;
+	std::chrono::steady_clock::time_point acked_at;
+};
+
+struct MatchInfo {
+	int match_id = 0;
+	int status_id = 0;
+	int player_id1 = 0;
+	int player_id2 = 0;
+	std::string player1_name;
+	std::string player2_name;
+	// Time already played in earlier sessions, from matches.duration.
+	int duration_seconds = 0;
+	MatchScore score;
+};
+
+// Owns one live match. Points are posted to its mailbox and applied in order by whichever pool worker picks the actor up,
+// so one match's work never waits on another's.
+class MatchActor : public std::enable_shared_from_this<MatchActor> {
+public:
+	static constexpr std::size_t MAX_BATCH = 32;
+	// Runs on the pool worker that applied the command, instead of fulfilling a future.
+	using AckCallback = std::function<void(const PointAck&)>;
+
+	MatchActor(const MatchInfo& info, ThreadPool& pool, bool is_persistent);
+
+	std::future<PointAck> post(int player);
+	std::future<PointAck> finish(int winner);
+	void post(int player, AckCallback on_ack);
+	void finish(int winner, AckCallback on_ack);
+	// Acked once every command posted before it has been applied and its writes queued; later commands are rejected.
+	std::future<PointAck> stop();
+	CompactScore getScore() const { return CompactScore::fromBits(snapshot_.load(std::memory_order_acquire)); }
+	int getMatchId() const { return info_.match_id; }
+	// Seconds since this actor opened the match.
+	long long getSessionSeconds() const;
+
+private:
+	struct Command {
+		int player;
+		bool is_finishing;
+		std::chrono::steady_clock::time_point received_at;
+		std::promise<PointAck> ack;
+		AckCallback on_ack;
+		bool is_stopping = false;
+	};
+
+	MatchInfo info_;
+	ThreadPool& pool_;
+	bool is_persistent_;
+	std::chrono::steady_clock::time_point opened_at_;
+
+	std::mutex mailbox_mutex_;
+	std::deque<Command> mailbox_;
+	bool is_scheduled_ = false;
+	// Only touched by drain(), which never runs on two workers at once.
+	bool is_stopped_ = false;
+	std::atomic<std::uint64_t> snapshot_;
+
+	void enqueue(Command command);
+	void drain();
+	void persist(const MatchScore& before, int player, const PointResult& result) const;
+	void persistResult() const;
+};
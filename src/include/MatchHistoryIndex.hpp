@@ -0,0 +1,51 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+struct MatchRecord {
+	int match_id = 0;
+	int player_id1 = 0;
+	int player_id2 = 0;
+	int winner_id = 0;
+	int duration_seconds = 0;
+	std::uint8_t no_sets = 0;
+	std::uint8_t sets_player1 = 0;
+	std::uint8_t sets_player2 = 0;
+};
+
+// Finished matches indexed by player and by unordered player pair, so a player's history or a head-to-head is a
+// hash lookup plus a copy. Records are kept in match ID order. Names are not stored; RatingEngine holds them.
+class MatchHistoryIndex {
+public:
+	static constexpr std::size_t DEFAULT_FETCH_SIZE = 5000;
+
+	static MatchHistoryIndex& getInstance();
+
+	// Replaces the index with one cursor scan over every finished match in match_summary.
+	bool build(std::size_t fetch_size = DEFAULT_FETCH_SIZE);
+	// Adds a finished match, or replaces it if already indexed.
+	void record(const MatchRecord& match);
+
+	std::vector<MatchRecord> getPlayerHistory(int player_id) const;
+	std::vector<MatchRecord> getHeadToHead(int player_a, int player_b) const;
+	std::size_t size() const;
+
+	MatchHistoryIndex(const MatchHistoryIndex&) = delete;
+	MatchHistoryIndex& operator=(const MatchHistoryIndex&) = delete;
+
+private:
+	mutable std::shared_mutex mutex_;
+	std::vector<MatchRecord> records_;
+	std::unordered_map<int, std::uint32_t> by_match_;
+	std::unordered_map<int, std::vector<std::uint32_t>> by_player_;
+	std::unordered_map<std::uint64_t, std::vector<std::uint32_t>> by_pair_;
+
+	MatchHistoryIndex() = default;
+	void insert(const MatchRecord& match);
+	void link(std::vector<std::uint32_t>& positions, std::uint32_t position) const;
+	std::vector<MatchRecord> collect(const std::vector<std::uint32_t>* positions) const;
+	static std::uint64_t pairKey(int player_a, int player_b);
+};
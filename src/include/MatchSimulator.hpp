@@ -0,0 +1,52 @@
+#pragma once
+#include "CompactScore.hpp"
+#include "ScoringTables.hpp"
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+class Match;
+
+struct SimulationParams {
+	double serve_win_player1 = 0.64;
+	double serve_win_player2 = 0.64;
+	std::size_t simulations = 1000000;
+	unsigned threads = 0;
+	std::chrono::milliseconds budget{ 50 };
+	std::uint64_t seed = 0;
+};
+
+struct SimulationResult {
+	double match_win_player1 = 0.0;
+	double set_win_player1 = 0.0;
+	double game_win_player1 = 0.0;
+	std::size_t simulations = 0;
+	std::chrono::microseconds elapsed{ 0 };
+	bool is_budget_exceeded = false;
+};
+
+// Monte Carlo estimate of win probabilities from a live score, assuming each player wins a fixed share of service points.
+class MatchSimulator {
+public:
+	static constexpr std::size_t LANES = 64;
+
+	static SimulationResult simulate(const CompactScore& start, const SimulationParams& params = SimulationParams());
+	static SimulationResult simulate(const Match& match, const SimulationParams& params = SimulationParams());
+
+private:
+	using GameThresholds = std::array<std::uint64_t, ScoringTables::GAME_STATES * ScoringTables::GAME_STATES>;
+
+	struct Tally {
+		std::size_t simulations = 0;
+		std::size_t matches_won_player1 = 0;
+		std::size_t sets_won_player1 = 0;
+		std::size_t games_won_player1 = 0;
+	};
+
+	static void runWorker(const MatchScore& start, const SimulationParams& params, std::size_t quota, std::uint64_t seed,
+		std::chrono::steady_clock::time_point deadline, Tally& tally);
+	static GameThresholds gameThresholds(double point_win_player1);
+	static std::uint64_t toThreshold(double probability);
+	static std::uint64_t nextRandom(std::uint64_t& state);
+};
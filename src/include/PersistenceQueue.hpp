@@ -0,0 +1,94 @@
+#pragma once
+#include "IDatabaseConnection.hpp"
+#include <pqxx/pqxx>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+struct QueueMetrics {
+	unsigned long long enqueued = 0;
+	unsigned long long coalesced = 0;
+	unsigned long long statements = 0;
+	unsigned long long batches = 0;
+	unsigned long long failed_batches = 0;
+	std::size_t max_depth = 0;
+	std::size_t depth = 0;
+};
+
+class PersistenceQueue {
+public:
+	using Write = std::function<void(pqxx::work&)>;
+	using Committed = std::function<void()>;
+
+	static constexpr std::size_t DEFAULT_CAPACITY = 1024;
+	static constexpr std::size_t DEFAULT_BATCH_SIZE = 64;
+	static constexpr std::chrono::milliseconds DEFAULT_FLUSH_INTERVAL{ 50 };
+
+	static PersistenceQueue& getInstance();
+
+	// Writes are committed in enqueue order. A keyed write replaces a pending write with the same
+	// match_id and key, so only the latest value of a row reaches the database; the replacement takes
+	// the place of the newest write, after anything enqueued in between. Keyed writes are therefore
+	// only used for UPDATEs of a single row that no other pending write depends on.
+	void enqueue(int match_id, Write write);
+	// on_committed runs on the queue's thread once the write has committed, and never if it fails.
+	void enqueue(int match_id, Write write, Committed on_committed);
+	void enqueue(int match_id, const std::string& key, Write write);
+	void addDuration(int match_id, long long seconds);
+
+	// Blocks until everything enqueued before the call is committed. Returns false if a batch failed since the last flush.
+	bool flush();
+	QueueMetrics getMetrics() const;
+	// Where batches are committed through IDatabaseConnection::runTransaction; nullptr means DatabaseConnection.
+	void setDatabase(IDatabaseConnection* database) { database_ = database; }
+
+	PersistenceQueue(const PersistenceQueue&) = delete;
+	PersistenceQueue& operator=(const PersistenceQueue&) = delete;
+	~PersistenceQueue();
+
+private:
+	struct PendingWrite {
+		std::uint64_t seq = 0;
+		int match_id = 0;
+		std::string key;
+		Write write;
+		long long duration_seconds = 0;
+		Committed on_committed;
+	};
+
+	std::size_t capacity_;
+	std::size_t batch_size_;
+	std::chrono::milliseconds flush_interval_;
+
+	std::list<PendingWrite> pending_;
+	std::unordered_map<std::string, std::list<PendingWrite>::iterator> pending_by_key_;
+	std::uint64_t next_seq_ = 1;
+	std::uint64_t committed_seq_ = 0;
+	std::uint64_t flush_target_ = 0;
+	bool has_failed_ = false;
+	bool is_stopping_ = false;
+	std::chrono::steady_clock::time_point oldest_pending_;
+
+	mutable std::mutex mutex_;
+	std::condition_variable work_available_;
+	std::condition_variable space_available_;
+	std::condition_variable committed_;
+	QueueMetrics metrics_;
+	std::thread worker_;
+	std::atomic<IDatabaseConnection*> database_{ nullptr };
+
+	PersistenceQueue(std::size_t capacity, std::size_t batch_size, std::chrono::milliseconds flush_interval);
+
+	void push(int match_id, const std::string& key, Write write, long long duration_seconds, Committed on_committed = nullptr);
+	void run();
+	bool commitBatch(const std::vector<PendingWrite>& batch);
+	static std::string makeKey(int match_id, const std::string& key) { return std::to_string(match_id) + ':' + key; }
+};
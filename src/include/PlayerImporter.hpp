@@ -0,0 +1,37 @@
+#pragma once
+#include "DelimitedFile.hpp"
+#include <chrono>
+#include <cstddef>
+#include <istream>
+#include <string>
+#include <vector>
+
+struct ImportReport {
+	std::size_t rows_read = 0;
+	std::size_t imported = 0;
+	std::vector<ImportError> errors;
+	std::chrono::milliseconds elapsed{ 0 };
+	bool is_committed = false;
+};
+
+// Bulk roster import: CSV or TSV with first and last name columns (an optional header row picks their order).
+// Rows are validated with the same rules as Player::addPlayer across all cores and the valid ones are loaded with a
+// single COPY. Invalid rows are reported and skipped; a database failure loads nothing.
+class PlayerImporter {
+public:
+	static ImportReport importFile(const std::string& path, unsigned threads = 0);
+	static ImportReport importStream(std::istream& in, unsigned threads = 0);
+	static void printReport(const ImportReport& report, std::size_t max_errors = 20);
+
+private:
+	struct Row {
+		std::size_t line = 0;
+		std::string first_name;
+		std::string last_name;
+		std::string error;
+	};
+
+	static std::string normalize(const std::string& name, const char* field, std::string& error);
+	static void validate(std::vector<Row>& rows, unsigned threads);
+	static bool load(const std::vector<Row>& rows, ImportReport& report);
+};
@@ -0,0 +1,106 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+struct PlayerMatch {
+	int player_id = 0;
+	std::string first_name;
+	std::string last_name;
+	int score = 0;
+};
+
+// Name lookup for the console and API. Every query word must match the player's first or last name; an exact name
+// ranks above a prefix (shorter completions first), which ranks above a name one typo away. Distinct name tokens are
+// kept in ordered maps per length, so prefix matches come out best first and a search stops once the page is full.
+// Typos are found through a deletion index: two words one edit apart share a single-deletion variant.
+class PlayerSearchIndex {
+public:
+	static constexpr std::size_t DEFAULT_LIMIT = 10;
+	static constexpr std::size_t DEFAULT_FETCH_SIZE = 10000;
+	// Words shorter than this only match exactly or as a prefix.
+	static constexpr std::size_t MIN_TYPO_LENGTH = 4;
+
+	static PlayerSearchIndex& getInstance();
+
+	// Replaces the index with one cursor scan over public.players.
+	bool load(std::size_t fetch_size = DEFAULT_FETCH_SIZE);
+	// Names are normalized with formatName; a player already indexed is ignored.
+	void add(int player_id, const std::string& first_name, const std::string& last_name);
+
+	std::vector<PlayerMatch> search(const std::string& query, std::size_t limit = DEFAULT_LIMIT) const;
+	std::size_t size() const;
+
+	static std::vector<std::string> tokenize(const std::string& text);
+	// Optimal string alignment distance, giving up once it exceeds max_distance.
+	static int editDistance(const std::string& a, const std::string& b, int max_distance);
+
+	PlayerSearchIndex(const PlayerSearchIndex&) = delete;
+	PlayerSearchIndex& operator=(const PlayerSearchIndex&) = delete;
+
+private:
+	static constexpr int EXACT_SCORE = 100;
+	static constexpr int PREFIX_SCORE = 60;
+	static constexpr int TYPO_SCORE = 30;
+	static constexpr std::size_t MAX_PENDING_DELETES = 4096;
+	static constexpr int MAX_STACK_LENGTH = 32;
+	// A query word matching more name tokens than this is checked against candidates' names directly.
+	static constexpr std::size_t MAX_WORD_TOKENS = 1 << 14;
+
+	// Carrying the player's other name token lets a search score candidates without touching players_.
+	struct Posting {
+		std::uint32_t position;
+		std::uint32_t other_token;
+	};
+
+	struct Token {
+		std::string text;
+		std::vector<Posting> players;
+	};
+
+	struct IndexedPlayer {
+		int player_id;
+		std::string first_name;
+		std::string last_name;
+		std::uint32_t first_token;
+		std::uint32_t last_token;
+	};
+
+	// Tokens one query word matches, open-addressed by token id plus one (zero marks a free slot). A candidate is
+	// scored with a couple of probes into a table small enough to stay in cache.
+	struct WordMatches {
+		std::vector<std::pair<std::uint32_t, int>> slots;
+		std::size_t postings = 0;
+		bool is_complete = false;
+
+		void build(const std::vector<std::pair<std::uint32_t, int>>& scores);
+		int scoreOf(std::uint32_t token_id) const;
+	};
+
+	using DeleteEntry = std::pair<std::uint64_t, std::uint32_t>;
+
+	mutable std::shared_mutex mutex_;
+	std::vector<IndexedPlayer> players_;
+	std::unordered_map<int, std::uint32_t> by_id_;
+	std::vector<Token> tokens_;
+	std::vector<std::map<std::string, std::uint32_t>> tokens_by_length_;
+	// Sorted (variant hash, token) pairs; tokens added after a load collect in pending_deletes_ until merged.
+	std::vector<DeleteEntry> deletes_;
+	std::vector<DeleteEntry> pending_deletes_;
+
+	PlayerSearchIndex() = default;
+	void insert(int player_id, std::string first_name, std::string last_name);
+	std::uint32_t internToken(const std::string& text, std::vector<DeleteEntry>& deletes);
+	void link(std::vector<Posting>& postings, Posting posting) const;
+	bool isRankedBefore(std::uint32_t a, std::uint32_t b) const;
+	void mergePendingDeletes();
+	std::vector<std::uint32_t> findTypos(const std::string& word) const;
+	bool collectMatches(const std::string& word, std::size_t max_tokens, WordMatches& matches) const;
+	static int scoreToken(const std::string& token, const std::string& word);
+	static std::vector<std::uint64_t> deletionVariants(const std::string& token);
+};
@@ -0,0 +1,36 @@
+#pragma once
+#include "CompactScore.hpp"
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+struct PointEvent {
+	int seq;
+	int winner;
+	bool is_player_one_serving;
+};
+
+// Append-only log of every point, written through the persistence queue. Replaying it rebuilds the exact score and server.
+class PointLog {
+public:
+	static PointLog& getInstance();
+
+	void record(int match_id, int winner, bool is_player_one_serving);
+	void setLastSeq(int match_id, int seq);
+
+	static std::vector<PointEvent> load(int match_id);
+	static MatchScore replay(int no_sets, const std::vector<PointEvent>& events);
+	static std::optional<MatchScore> replayMatch(int match_id, int no_sets);
+	static std::unordered_map<int, CompactScore> replayAll();
+
+	PointLog(const PointLog&) = delete;
+	PointLog& operator=(const PointLog&) = delete;
+
+private:
+	std::mutex mutex_;
+	std::unordered_map<int, int> last_seq_;
+
+	PointLog() = default;
+	int nextSeq(int match_id);
+};
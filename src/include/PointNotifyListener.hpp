@@ -0,0 +1,45 @@
+#pragma once
+#include "ScoringEngine.hpp"
+#include <atomic>
+#include <functional>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+// Follows the point_events NOTIFY channel so points scored by other processes (e.g. an umpire on the console app)
+// reach this process's ScoreEventBus. Each match is read from the point log once and then advanced point by point;
+// a gap in sequence numbers triggers a fresh replay. The match_status channel carries their status changes
+// (started, suspended, finished) into the LiveScoreCache.
+class PointNotifyListener {
+public:
+	static constexpr const char* CHANNEL = "point_events";
+	static constexpr const char* STATUS_CHANNEL = "match_status";
+
+	// Matches for which is_local returns true are skipped; their actors already publish every point.
+	explicit PointNotifyListener(std::function<bool(int)> is_local = nullptr);
+	~PointNotifyListener();
+
+	PointNotifyListener(const PointNotifyListener&) = delete;
+	PointNotifyListener& operator=(const PointNotifyListener&) = delete;
+
+	void start();
+	void stop();
+	void onNotification(const std::string& payload);
+	void onStatusNotification(const std::string& payload);
+
+private:
+	struct Replica {
+		int last_seq = 0;
+		MatchScore score;
+	};
+
+	std::function<bool(int)> is_local_;
+	std::unordered_map<int, Replica> replicas_;
+	std::atomic<bool> is_running_{ false };
+	std::thread worker_;
+
+	void run();
+	void apply(int match_id, int seq, int winner);
+	static std::optional<Replica> load(int match_id);
+};
@@ -0,0 +1,179 @@
+#pragma once
+#include "QueryMetrics.hpp"
+#include <pqxx/pqxx>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+struct InsertGamePointsQuery {
+	static constexpr const char* name = "insert_game_points";
+	static constexpr const char* sql =
+		"INSERT INTO game_points (match_id, set_number, game_number, player1_points, player2_points) "
+		"VALUES ($1, $2, $3, $4, $5)";
+	using Params = std::tuple<int, int, int, std::string, std::string>;
+};
+
+struct UpdateGamePointsQuery {
+	static constexpr const char* name = "update_game_points";
+	static constexpr const char* sql =
+		"UPDATE game_points SET player1_points = $1, player2_points = $2 "
+		"WHERE match_id = $3 AND set_number = $4 AND game_number = $5";
+	using Params = std::tuple<std::string, std::string, int, int, int>;
+};
+
+struct InsertMatchSetQuery {
+	static constexpr const char* name = "insert_match_set";
+	static constexpr const char* sql =
+		"INSERT INTO matches_sets (match_id, set_number, games_won_player1, games_won_player2, is_first_player_serving) "
+		"VALUES ($1, $2, $3, $4, $5)";
+	using Params = std::tuple<int, int, int, int, bool>;
+};
+
+struct UpdateMatchSetQuery {
+	static constexpr const char* name = "update_match_set";
+	static constexpr const char* sql =
+		"UPDATE matches_sets SET games_won_player1 = $1, games_won_player2 = $2, is_first_player_serving = $3 "
+		"WHERE match_id = $4 AND set_number = $5";
+	using Params = std::tuple<int, int, bool, int, int>;
+};
+
+struct UpdateSetGamesQuery {
+	static constexpr const char* name = "update_set_games";
+	static constexpr const char* sql =
+		"UPDATE matches_sets SET games_won_player1 = $1, games_won_player2 = $2 "
+		"WHERE match_id = $3 AND set_number = $4";
+	using Params = std::tuple<int, int, int, int>;
+};
+
+struct MarkSetTiebreakQuery {
+	static constexpr const char* name = "mark_set_tiebreak";
+	static constexpr const char* sql =
+		"UPDATE matches_sets SET is_tie_break = TRUE WHERE match_id = $1 AND set_number = $2";
+	using Params = std::tuple<int, int>;
+};
+
+struct InsertTiebreakQuery {
+	static constexpr const char* name = "insert_tiebreak";
+	static constexpr const char* sql =
+		"INSERT INTO tie_breaks (match_id, set_number, player1_score, player2_score, tie_break_type) "
+		"VALUES ($1, $2, $3, $4, $5)";
+	using Params = std::tuple<int, int, int, int, int>;
+};
+
+struct UpdateTiebreakQuery {
+	static constexpr const char* name = "update_tiebreak";
+	static constexpr const char* sql =
+		"UPDATE tie_breaks SET player1_score = $1, player2_score = $2 WHERE match_id = $3 AND set_number = $4";
+	using Params = std::tuple<int, int, int, int>;
+};
+
+struct AddMatchDurationQuery {
+	static constexpr const char* name = "add_match_duration";
+	static constexpr const char* sql =
+		"UPDATE public.matches SET duration = duration + $1 * interval '1 second' WHERE id = $2";
+	using Params = std::tuple<long long, int>;
+};
+
+struct UpdateMatchStatusQuery {
+	static constexpr const char* name = "update_match_status";
+	static constexpr const char* sql = "UPDATE public.matches SET status_id = $1 WHERE id = $2";
+	using Params = std::tuple<int, int>;
+};
+
+struct UpdateMatchWinnerQuery {
+	static constexpr const char* name = "update_match_winner";
+	static constexpr const char* sql = "UPDATE public.matches SET winner_id = $1 WHERE id = $2";
+	using Params = std::tuple<std::optional<int>, int>;
+};
+
+struct UpdateMatchProgressQuery {
+	static constexpr const char* name = "update_match_progress";
+	static constexpr const char* sql =
+		"UPDATE public.matches SET duration = duration + $1 * interval '1 minute', status_id = $2, winner_id = $3 "
+		"WHERE id = $4";
+	using Params = std::tuple<long long, int, std::optional<int>, int>;
+};
+
+struct InsertPointEventQuery {
+	static constexpr const char* name = "insert_point_event";
+	static constexpr const char* sql =
+		"INSERT INTO point_events (match_id, seq, winner, is_player_one_serving) VALUES ($1, $2, $3, $4)";
+	using Params = std::tuple<int, int, int, bool>;
+};
+
+struct UpsertSetResultQuery {
+	static constexpr const char* name = "upsert_set_result";
+	static constexpr const char* sql =
+		"INSERT INTO matches_sets (match_id, set_number, games_won_player1, games_won_player2, is_tie_break) "
+		"VALUES ($1, $2, $3, $4, $5) "
+		"ON CONFLICT (match_id, set_number) DO UPDATE SET games_won_player1 = EXCLUDED.games_won_player1, "
+		"games_won_player2 = EXCLUDED.games_won_player2, is_tie_break = EXCLUDED.is_tie_break";
+	using Params = std::tuple<int, int, int, int, bool>;
+};
+
+struct RecordPlayerWinQuery {
+	static constexpr const char* name = "record_player_win";
+	static constexpr const char* sql = "UPDATE public.players SET matches_won = matches_won + 1 WHERE id = $1";
+	using Params = std::tuple<int>;
+};
+
+struct RecordPlayerLossQuery {
+	static constexpr const char* name = "record_player_loss";
+	static constexpr const char* sql = "UPDATE public.players SET matches_lost = matches_lost + 1 WHERE id = $1";
+	using Params = std::tuple<int>;
+};
+
+// Locks both players' rows in id order, so concurrent results for overlapping players cannot deadlock.
+struct LockPlayerRatingsQuery {
+	static constexpr const char* name = "lock_player_ratings";
+	static constexpr const char* sql = "SELECT id, rating, rated_matches FROM public.players WHERE id IN ($1, $2) ORDER BY id FOR UPDATE";
+	using Params = std::tuple<int, int>;
+};
+
+struct UpdatePlayerRatingQuery {
+	static constexpr const char* name = "update_player_rating";
+	static constexpr const char* sql = "UPDATE public.players SET rating = $1, rated_matches = $2 WHERE id = $3";
+	using Params = std::tuple<double, int, int>;
+};
+
+class PreparedStatements {
+public:
+	using All = std::tuple<
+		InsertGamePointsQuery,
+		UpdateGamePointsQuery,
+		InsertMatchSetQuery,
+		UpdateMatchSetQuery,
+		UpdateSetGamesQuery,
+		MarkSetTiebreakQuery,
+		InsertTiebreakQuery,
+		UpdateTiebreakQuery,
+		AddMatchDurationQuery,
+		UpdateMatchStatusQuery,
+		UpdateMatchWinnerQuery,
+		UpdateMatchProgressQuery,
+		InsertPointEventQuery,
+		UpsertSetResultQuery,
+		RecordPlayerWinQuery,
+		RecordPlayerLossQuery,
+		LockPlayerRatingsQuery,
+		UpdatePlayerRatingQuery>;
+
+	static void prepareAll(pqxx::connection& conn);
+	static std::vector<std::string_view> names();
+
+	template<typename Query, typename... Args>
+	static pqxx::result exec(pqxx::transaction_base& txn, Args&&... args) {
+		static_assert(sizeof...(Args) == std::tuple_size<typename Query::Params>::value,
+			"Wrong number of parameters for prepared statement.");
+		const typename Query::Params params(std::forward<Args>(args)...);
+		static StatementMetrics& metrics = QueryMetrics::getInstance().get(Query::name);
+		return QueryMetrics::time(metrics, [&]() {
+			return std::apply([&txn](const auto&... values) {
+				return txn.exec_prepared(Query::name, values...);
+			}, params);
+		});
+	}
+};
@@ -0,0 +1,187 @@
+#pragma once
+#include <pqxx/pqxx>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Log-linear latency histogram in the style of HdrHistogram, in microseconds: values below 32 are exact, and each
+// power of two above is split into 32 buckets, so every value is within about 3% of its bucket. Recording is a
+// couple of relaxed atomic adds.
+class LatencyHistogram {
+public:
+	static constexpr int SUB_BUCKET_BITS = 5;
+	static constexpr std::uint64_t SUB_BUCKETS = 1ULL << SUB_BUCKET_BITS;
+	static constexpr int MAX_BIT = 35;
+	static constexpr std::size_t BUCKETS = SUB_BUCKETS * (MAX_BIT - SUB_BUCKET_BITS + 2);
+
+	void record(std::chrono::nanoseconds elapsed);
+	std::uint64_t getCount() const { return count_.load(std::memory_order_relaxed); }
+	std::chrono::microseconds getSum() const { return std::chrono::microseconds(sum_.load(std::memory_order_relaxed)); }
+	std::vector<std::uint64_t> getBuckets() const;
+
+	static std::size_t bucketIndex(std::uint64_t micros);
+	static std::uint64_t bucketLowerBound(std::size_t index);
+	static std::uint64_t bucketUpperBound(std::size_t index);
+	// Upper bound of the bucket holding the given quantile, from a copy of the buckets.
+	static std::chrono::microseconds quantile(const std::vector<std::uint64_t>& buckets, std::uint64_t count, double q);
+
+private:
+	std::array<std::atomic<std::uint64_t>, BUCKETS> buckets_{};
+	std::atomic<std::uint64_t> count_{ 0 };
+	std::atomic<std::uint64_t> sum_{ 0 };
+};
+
+// Statements are named by their call site, or by name for prepared statements; transactions by their call site.
+struct StatementMetrics {
+	LatencyHistogram statements;
+	LatencyHistogram transactions;
+	std::atomic<std::uint64_t> errors{ 0 };
+	std::atomic<std::uint64_t> rollbacks{ 0 };
+};
+
+struct StatementSummary {
+	std::string name;
+	std::uint64_t count = 0;
+	std::uint64_t errors = 0;
+	std::chrono::microseconds total{ 0 };
+	std::chrono::microseconds p50{ 0 };
+	std::chrono::microseconds p99{ 0 };
+	std::chrono::microseconds max{ 0 };
+};
+
+// Per-statement latency, round trips, transaction durations and errors for database calls. Disabled by default;
+// while disabled every hook costs one relaxed load. Rendered in the Prometheus text format, together with the
+// persistence queue and connection pool counters.
+class QueryMetrics {
+public:
+	static QueryMetrics& getInstance();
+
+	static bool isEnabled() { return is_enabled_.load(std::memory_order_relaxed); }
+	static void setEnabled(const bool is_enabled) { is_enabled_.store(is_enabled, std::memory_order_relaxed); }
+
+	StatementMetrics& get(const std::string& name);
+	void addRoundTrips(const std::uint64_t round_trips) { round_trips_.fetch_add(round_trips, std::memory_order_relaxed); }
+	std::uint64_t getRoundTrips() const { return round_trips_.load(std::memory_order_relaxed); }
+	std::vector<StatementSummary> getStatementSummaries() const;
+	std::string renderPrometheus() const;
+
+	// Rewrites the file with renderPrometheus() every interval, e.g. for node_exporter's textfile collector. Stop it
+	// before the database and queue singletons go away.
+	void startDump(const std::string& path, std::chrono::seconds interval);
+	void stopDump();
+
+	// Runs one statement, recording its latency, or an error if it throws.
+	template<typename Fn>
+	static auto time(StatementMetrics& metrics, Fn&& fn) -> decltype(fn()) {
+		if (!isEnabled()) {
+			return fn();
+		}
+		const auto started_at = std::chrono::steady_clock::now();
+		getInstance().addRoundTrips(1);
+		try {
+			auto result = fn();
+			metrics.statements.record(std::chrono::steady_clock::now() - started_at);
+			return result;
+		}
+		catch (...) {
+			metrics.errors.fetch_add(1, std::memory_order_relaxed);
+			throw;
+		}
+	}
+
+	QueryMetrics(const QueryMetrics&) = delete;
+	QueryMetrics& operator=(const QueryMetrics&) = delete;
+	~QueryMetrics();
+
+private:
+	static std::atomic<bool> is_enabled_;
+
+	mutable std::shared_mutex mutex_;
+	std::map<std::string, std::unique_ptr<StatementMetrics>, std::less<>> statements_;
+	std::atomic<std::uint64_t> round_trips_{ 0 };
+
+	std::mutex dump_mutex_;
+	std::condition_variable dump_wakeup_;
+	std::thread dump_thread_;
+	bool is_dump_stopping_ = false;
+
+	QueryMetrics() = default;
+	void writeDump(const std::string& path) const;
+};
+
+// A pqxx transaction whose statements, duration and outcome are recorded under its call site's name. BEGIN and
+// COMMIT count as round trips for transactions; a nontransaction only pays for its statements.
+template<typename Transaction>
+class TracedTransaction {
+public:
+	TracedTransaction(pqxx::connection& conn, const std::string& name)
+		: metrics_(QueryMetrics::isEnabled() ? &QueryMetrics::getInstance().get(name) : nullptr),
+		started_at_(metrics_ ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point()),
+		txn_(conn) {
+		if (metrics_ && IS_TRANSACTION) {
+			QueryMetrics::getInstance().addRoundTrips(1);
+		}
+	}
+
+	~TracedTransaction() {
+		if (metrics_ && IS_TRANSACTION) {
+			metrics_->transactions.record(std::chrono::steady_clock::now() - started_at_);
+			if (!is_committed_) {
+				metrics_->rollbacks.fetch_add(1, std::memory_order_relaxed);
+			}
+		}
+	}
+
+	TracedTransaction(const TracedTransaction&) = delete;
+	TracedTransaction& operator=(const TracedTransaction&) = delete;
+
+	pqxx::result exec(const std::string& query) {
+		return run([&]() { return txn_.exec(query); });
+	}
+
+	template<typename... Args>
+	pqxx::result exec_params(const std::string& query, Args&&... args) {
+		return run([&]() { return txn_.exec_params(query, std::forward<Args>(args)...); });
+	}
+
+	template<typename T>
+	std::string quote(const T& value) const { return txn_.quote(value); }
+
+	void commit() {
+		txn_.commit();
+		is_committed_ = true;
+		if (metrics_ && IS_TRANSACTION) {
+			QueryMetrics::getInstance().addRoundTrips(1);
+		}
+	}
+
+	// For PreparedStatements::exec and writes that take the pqxx transaction itself.
+	Transaction& get() { return txn_; }
+
+private:
+	static constexpr bool IS_TRANSACTION = !std::is_same<Transaction, pqxx::nontransaction>::value;
+
+	StatementMetrics* metrics_;
+	std::chrono::steady_clock::time_point started_at_;
+	Transaction txn_;
+	bool is_committed_ = false;
+
+	template<typename Fn>
+	pqxx::result run(Fn&& fn) {
+		return metrics_ ? QueryMetrics::time(*metrics_, fn) : fn();
+	}
+};
+
+using TracedWork = TracedTransaction<pqxx::work>;
+using TracedNontransaction = TracedTransaction<pqxx::nontransaction>;
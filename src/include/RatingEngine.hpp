@@ -0,0 +1,93 @@
+#pragma once
+#include <pqxx/pqxx>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <shared_mutex>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+struct RatingParameters {
+	double initial_rating = 1500;
+	double k_factor = 24;
+	// Used for a player's first provisional_matches results so new players settle quickly.
+	double provisional_k_factor = 40;
+	int provisional_matches = 20;
+};
+
+struct PlayerRating {
+	int player_id = 0;
+	std::string name;
+	double rating = 0;
+	int rated_matches = 0;
+};
+
+// Elo ratings for every player, kept in memory next to a rating-ordered index so the leaderboard never queries
+// public.players. Each finished match is rated inside the persistence queue's transaction from the locked database
+// rows, so several processes rating the same players never overwrite each other, and the cache is refreshed from what
+// was written once it commits. recompute() replays the whole history (e.g. after a parameter change), running independent matches in
+// parallel.
+class RatingEngine {
+public:
+	static constexpr std::size_t PARALLEL_THRESHOLD = 1024;
+
+	static RatingEngine& getInstance();
+
+	// Loads parameters, ratings and names with one query each.
+	bool warm();
+	// Queues the rating update behind the match's other writes; the cache changes once the queue runs it.
+	void recordResult(int match_id, int winner_id, int loser_id);
+	bool recompute(const RatingParameters& parameters, unsigned threads = 0);
+
+	std::vector<PlayerRating> top(std::size_t k) const;
+	std::optional<PlayerRating> get(int player_id) const;
+	RatingParameters getParameters() const;
+
+	static double expectedScore(double rating, double opponent_rating);
+
+	RatingEngine(const RatingEngine&) = delete;
+	RatingEngine& operator=(const RatingEngine&) = delete;
+
+private:
+	struct Entry {
+		std::string name;
+		double rating = 0;
+		int rated_matches = 0;
+	};
+
+	// Highest rating first; ties go to the lower player ID.
+	struct RankKey {
+		double rating;
+		int player_id;
+		bool operator<(const RankKey& other) const {
+			return rating != other.rating ? rating > other.rating : player_id < other.player_id;
+		}
+	};
+
+	struct HistoryMatch {
+		int winner;
+		int loser;
+	};
+
+	mutable std::shared_mutex mutex_;
+	RatingParameters parameters_;
+	std::unordered_map<int, Entry> players_;
+	std::set<RankKey> ranking_;
+
+	// Results recorded while recompute() is reading history, replayed on top of the new ratings unless already in it.
+	std::mutex recompute_mutex_;
+	bool is_recomputing_ = false;
+	std::vector<std::tuple<int, int, int>> recorded_during_recompute_;
+
+	RatingEngine() = default;
+	void enqueueResult(int match_id, int winner_id, int loser_id);
+	void applyResult(pqxx::work& txn, int winner_id, int loser_id, std::vector<PlayerRating>& rated);
+	void store(int player_id, double rating, int rated_matches);
+	static double kFactor(const RatingParameters& parameters, int rated_matches);
+	static std::optional<std::string> loadName(int player_id);
+	static void replay(const std::vector<HistoryMatch>& history, const RatingParameters& parameters,
+		std::vector<double>& ratings, std::vector<int>& counts, unsigned threads);
+};
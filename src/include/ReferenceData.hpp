@@ -0,0 +1,51 @@
+#pragma once
+#include <array>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+struct MatchStatusEntry {
+	int id;
+	const char* status;
+};
+
+struct TiebreakTypeEntry {
+	int type_id;
+	int min_points;
+};
+
+class ReferenceData {
+public:
+	// Seed rows from docker/init.sql, used until the first successful refresh().
+	static constexpr std::array<MatchStatusEntry, 5> DEFAULT_MATCH_STATUSES{ {
+		{ 1, "Started" }, { 2, "Suspended" }, { 3, "Finished" }, { 4, "Pending" }, { 5, "Delayed" }
+	} };
+	static constexpr std::array<TiebreakTypeEntry, 2> DEFAULT_TIEBREAK_TYPES{ {
+		{ 1, 7 }, { 2, 10 }
+	} };
+
+	static ReferenceData& getInstance();
+
+	bool refresh();
+	int getStatusId(const std::string& status_name) const;
+	std::optional<std::string> getStatusName(int status_id) const;
+	std::optional<int> getTiebreakTypeId(int min_points) const;
+
+	ReferenceData(const ReferenceData&) = delete;
+	ReferenceData& operator=(const ReferenceData&) = delete;
+
+private:
+	struct Snapshot {
+		std::vector<std::pair<int, std::string>> statuses;
+		std::vector<TiebreakTypeEntry> tiebreak_types;
+	};
+
+	mutable std::mutex mutex_;
+	std::shared_ptr<const Snapshot> snapshot_;
+
+	ReferenceData();
+	std::shared_ptr<const Snapshot> current() const;
+};
@@ -0,0 +1,45 @@
+#pragma once
+#include "DelimitedFile.hpp"
+#include <chrono>
+#include <cstddef>
+#include <istream>
+#include <string>
+#include <vector>
+
+struct ScheduledMatch {
+	std::size_t line;
+	int match_id;
+};
+
+struct ScheduleReport {
+	std::size_t rows_read = 0;
+	std::vector<ScheduledMatch> scheduled;
+	std::vector<ImportError> errors;
+	std::chrono::milliseconds elapsed{ 0 };
+	bool is_committed = false;
+};
+
+// Batch scheduling for tournament draws. Each record holds player_id1, player_id2, no_sets and predicted_start_time
+// (YYYY-MM-DD HH:MM[:SS]); a header row may reorder them. Player IDs are checked with one ANY() query and all valid
+// rows are inserted with one unnest() INSERT, so a draw costs two round trips. IDs are returned in file order.
+class ScheduleImporter {
+public:
+	static ScheduleReport importFile(const std::string& path);
+	static ScheduleReport importStream(std::istream& in);
+	static void printReport(const ScheduleReport& report, std::size_t max_rows = 20);
+
+private:
+	struct Row {
+		std::size_t line = 0;
+		int player_id1 = 0;
+		int player_id2 = 0;
+		int no_sets = 0;
+		std::string predicted_start_time;
+		int status_id = 0;
+		std::string error;
+	};
+
+	static void parse(const std::vector<std::string>& fields, const std::size_t (&columns)[4], Row& row);
+	static bool parseStartTime(const std::string& value, std::string& normalized, bool& is_future);
+	static bool insert(std::vector<Row>& rows, ScheduleReport& report);
+};
@@ -0,0 +1,59 @@
+#pragma once
+#include "CourtServer.hpp"
+#include "HttpServer.hpp"
+#include "LiveScoreCache.hpp"
+#include "ScoreEventBus.hpp"
+#include <chrono>
+#include <optional>
+#include <string>
+#include <vector>
+
+// JSON routes over a CourtServer. Reads are served from the LiveScoreCache, so polling never touches the database.
+//   GET  /matches                          every cached match, including suspended ones and those scored elsewhere
+//   GET  /matches/{id}                     one cached match
+//   POST /matches/{id}/start[?server=1|2][&takeover=1]  open the match (replaying its point log); takeover=1 is
+//                                          required for a match another scorer left Started
+//   POST /matches/{id}/points?player=1|2   score a point
+//   POST /matches/{id}/suspend             park the match as Suspended
+//   POST /matches/{id}/finish?winner=1|2   end the match early (retirement, walkover)
+//   GET  /events, /matches/{id}/events     server-sent score deltas from the ScoreEventBus
+//   GET  /leaderboard[?limit=n]            top rated players from the RatingEngine's in-memory index
+//   GET  /players?q=name[&limit=n]          ranked name matches from the PlayerSearchIndex
+//   GET  /players/{id}/matches[?opponent=id]  finished matches from the MatchHistoryIndex, optionally head-to-head
+//   GET  /metrics                          database latency, queue and pool metrics in the Prometheus text format
+class ScoreApi {
+public:
+	static constexpr std::chrono::milliseconds POLL_INTERVAL{ 1000 };
+	static constexpr std::chrono::seconds HEARTBEAT_INTERVAL{ 15 };
+	static constexpr std::size_t DEFAULT_LEADERBOARD_SIZE = 10;
+
+	explicit ScoreApi(CourtServer& court_server) : court_server_(court_server) {}
+
+	HttpResponse handle(const HttpRequest& request);
+
+	static std::string toJson(int match_id, const CompactScore& score);
+	static std::string toJson(const PointAck& ack);
+	static std::string toJson(const ScoreDelta& delta);
+	static std::string toJson(const LiveMatch& match);
+
+private:
+	CourtServer& court_server_;
+
+	HttpResponse listMatches() const;
+	HttpResponse getMatch(int match_id) const;
+	HttpResponse getLeaderboard(const HttpRequest& request) const;
+	HttpResponse searchPlayers(const HttpRequest& request) const;
+	HttpResponse getPlayerHistory(const std::string& player, const HttpRequest& request) const;
+	HttpResponse startMatch(int match_id, const HttpRequest& request);
+	HttpResponse scorePoint(int match_id, const HttpRequest& request);
+	HttpResponse suspendMatch(int match_id);
+	HttpResponse finishMatch(int match_id, const HttpRequest& request);
+	static HttpResponse streamEvents(int match_id);
+	static HttpResponse getMetrics();
+
+	static std::string quote(const std::string& value);
+	static std::vector<std::string> splitPath(const std::string& path);
+	static std::optional<std::string> bodyParam(const std::string& body, const std::string& name);
+	static int playerParam(const HttpRequest& request, const std::string& name);
+	static HttpResponse fromAck(const PointAck& ack);
+};
@@ -0,0 +1,63 @@
+#pragma once
+#include "CompactScore.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+struct ScoreDelta {
+	int match_id = 0;
+	std::uint64_t version = 0;
+	CompactScore score;
+	std::uint8_t events = NO_EVENT;
+};
+
+// One viewer's queue. It holds at most one pending delta per match, so a consumer that falls behind
+// skips straight to the latest score instead of buffering every point.
+class ScoreSubscription {
+public:
+	explicit ScoreSubscription(const int match_id) : match_id_(match_id) {}
+
+	bool wants(const int match_id) const { return match_id_ == 0 || match_id_ == match_id; }
+	void push(const ScoreDelta& delta);
+	// Returns the pending deltas in publish order, or nothing if none arrived within the timeout or the subscription was closed.
+	std::vector<ScoreDelta> wait(std::chrono::milliseconds timeout);
+	void close();
+	bool isClosed() const;
+	unsigned long long getCoalesced() const;
+
+private:
+	int match_id_;
+	mutable std::mutex mutex_;
+	std::condition_variable available_;
+	std::vector<ScoreDelta> pending_;
+	std::unordered_map<int, std::size_t> pending_index_;
+	unsigned long long coalesced_ = 0;
+	bool is_closed_ = false;
+};
+
+// In-process fan-out of score changes. Publishers never block on viewers: a publish costs one short lock per subscriber.
+class ScoreEventBus {
+public:
+	static ScoreEventBus& getInstance();
+
+	void publish(int match_id, const CompactScore& score, std::uint8_t events);
+	// Subscribes to one match, or to every match when match_id is 0. The subscription starts with the latest known scores.
+	std::shared_ptr<ScoreSubscription> subscribe(int match_id = 0);
+	std::size_t getSubscriberCount() const;
+	void closeAll();
+
+	ScoreEventBus(const ScoreEventBus&) = delete;
+	ScoreEventBus& operator=(const ScoreEventBus&) = delete;
+
+private:
+	mutable std::mutex mutex_;
+	std::vector<std::weak_ptr<ScoreSubscription>> subscribers_;
+	std::unordered_map<int, ScoreDelta> latest_;
+	std::uint64_t next_version_ = 1;
+
+	ScoreEventBus() = default;
+};
@@ -0,0 +1,176 @@
+#pragma once
+#include <cstdint>
+#include <utility>
+
+enum ScoringEvent : std::uint8_t {
+	NO_EVENT = 0,
+	GAME_WON = 1 << 0,
+	TIEBREAK_STARTED = 1 << 1,
+	SUPER_TIEBREAK_STARTED = 1 << 2,
+	TIEBREAK_WON = 1 << 3,
+	SET_WON = 1 << 4,
+	MATCH_WON = 1 << 5,
+	INVALID_POINT = 1 << 7
+};
+
+struct MatchScore {
+	int no_sets = 1;
+	int sets_player1 = 0;
+	int sets_player2 = 0;
+	int games_player1 = 0;
+	int games_player2 = 0;
+	int points_player1 = 0;
+	int points_player2 = 0;
+	bool is_tiebreak = false;
+	bool is_player_one_serving = true;
+	int winner = 0;
+
+	constexpr int getSetNum() const { return sets_player1 + sets_player2 + 1; }
+	constexpr bool isFinished() const { return winner != 0; }
+};
+
+struct PointResult {
+	std::uint8_t events = NO_EVENT;
+	int game_winner = 0;
+	int set_winner = 0;
+
+	constexpr bool has(const ScoringEvent event) const { return (events & event) != 0; }
+};
+
+// Tennis rules with no I/O: the same transitions Game, Tiebreak and Set apply, usable for simulation and replay.
+class ScoringEngine {
+public:
+	static constexpr int GAMES_TO_WIN_SET = 6;
+	static constexpr int TIEBREAK_POINTS = 7;
+	static constexpr int SUPER_TIEBREAK_POINTS = 10;
+
+	// Game points follow Game's encoding: 0, 15, 30, 40, A map to 0-4, and deuce returns to 3-3.
+	static constexpr std::pair<int, int> addGamePoint(int points_player1, int points_player2, const int player) {
+		int& winner_points = player == 1 ? points_player1 : points_player2;
+		int& loser_points = player == 1 ? points_player2 : points_player1;
+
+		if (winner_points == 3 && loser_points == 4) {
+			loser_points--;
+		}
+		else {
+			winner_points++;
+		}
+		return { points_player1, points_player2 };
+	}
+
+	static constexpr int gameWinner(const int points_player1, const int points_player2) {
+		if (points_player1 >= 4 && points_player1 >= points_player2 + 2) return 1;
+		if (points_player2 >= 4 && points_player2 >= points_player1 + 2) return 2;
+		return 0;
+	}
+
+	static constexpr int tiebreakWinner(const int points_player1, const int points_player2, const int max_points) {
+		if (points_player1 >= max_points && points_player1 - points_player2 >= 2) return 1;
+		if (points_player2 >= max_points && points_player2 - points_player1 >= 2) return 2;
+		return 0;
+	}
+
+	static constexpr int setWinner(const int games_player1, const int games_player2) {
+		if (games_player1 >= GAMES_TO_WIN_SET && games_player1 >= games_player2 + 2) return 1;
+		if (games_player2 >= GAMES_TO_WIN_SET && games_player2 >= games_player1 + 2) return 2;
+		return 0;
+	}
+
+	static constexpr bool isTiebreak(const int games_player1, const int games_player2) {
+		return games_player1 == GAMES_TO_WIN_SET && games_player2 == GAMES_TO_WIN_SET;
+	}
+
+	static constexpr int tiebreakPoints(const int set_num, const int no_sets) {
+		return (no_sets * 2 - 1 == set_num) ? SUPER_TIEBREAK_POINTS : TIEBREAK_POINTS;
+	}
+
+	static constexpr bool isPlayerOneServing(const int total_games, const bool is_first_player_starting) {
+		return (total_games % 2 == 0) ? is_first_player_starting : !is_first_player_starting;
+	}
+
+	// The tiebreak server changes after the first point and then after every two points.
+	static constexpr bool isTiebreakServerChange(const int points_played) {
+		return points_played % 2 == 1;
+	}
+
+	static constexpr PointResult scorePoint(MatchScore& score, const int player) {
+		PointResult result;
+		if (score.isFinished() || (player != 1 && player != 2)) {
+			result.events = INVALID_POINT;
+			return result;
+		}
+
+		if (score.is_tiebreak) {
+			return scoreTiebreakPoint(score, player);
+		}
+
+		const auto [points_player1, points_player2] = addGamePoint(score.points_player1, score.points_player2, player);
+		score.points_player1 = points_player1;
+		score.points_player2 = points_player2;
+
+		const int game_winner = gameWinner(points_player1, points_player2);
+		if (game_winner == 0) {
+			return result;
+		}
+
+		result.events |= GAME_WON;
+		result.game_winner = game_winner;
+		(game_winner == 1 ? score.games_player1 : score.games_player2)++;
+		score.points_player1 = 0;
+		score.points_player2 = 0;
+		score.is_player_one_serving = !score.is_player_one_serving;
+
+		if (const int set_winner = setWinner(score.games_player1, score.games_player2)) {
+			completeSet(score, result, set_winner);
+		}
+		else if (isTiebreak(score.games_player1, score.games_player2)) {
+			score.is_tiebreak = true;
+			result.events |= tiebreakPoints(score.getSetNum(), score.no_sets) == SUPER_TIEBREAK_POINTS
+				? SUPER_TIEBREAK_STARTED : TIEBREAK_STARTED;
+		}
+		return result;
+	}
+
+private:
+	static constexpr PointResult scoreTiebreakPoint(MatchScore& score, const int player) {
+		PointResult result;
+		(player == 1 ? score.points_player1 : score.points_player2)++;
+		const int points_played = score.points_player1 + score.points_player2;
+		const int max_points = tiebreakPoints(score.getSetNum(), score.no_sets);
+
+		const int tiebreak_winner = tiebreakWinner(score.points_player1, score.points_player2, max_points);
+		if (tiebreak_winner == 0) {
+			if (isTiebreakServerChange(points_played)) {
+				score.is_player_one_serving = !score.is_player_one_serving;
+			}
+			return result;
+		}
+
+		// The player who received first in the tiebreak serves first in the next set.
+		const bool is_first_server_player_one = ((points_played / 2) % 2 == 0)
+			? score.is_player_one_serving : !score.is_player_one_serving;
+		score.is_player_one_serving = !is_first_server_player_one;
+
+		result.events |= GAME_WON | TIEBREAK_WON;
+		result.game_winner = tiebreak_winner;
+		(tiebreak_winner == 1 ? score.games_player1 : score.games_player2)++;
+		score.points_player1 = 0;
+		score.points_player2 = 0;
+		score.is_tiebreak = false;
+		completeSet(score, result, tiebreak_winner);
+		return result;
+	}
+
+	static constexpr void completeSet(MatchScore& score, PointResult& result, const int set_winner) {
+		result.events |= SET_WON;
+		result.set_winner = set_winner;
+		(set_winner == 1 ? score.sets_player1 : score.sets_player2)++;
+		score.games_player1 = 0;
+		score.games_player2 = 0;
+
+		if (score.sets_player1 == score.no_sets || score.sets_player2 == score.no_sets) {
+			score.winner = set_winner;
+			result.events |= MATCH_WON;
+		}
+	}
+};
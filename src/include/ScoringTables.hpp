@@ -0,0 +1,270 @@
+#pragma once
+#include "ScoringEngine.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+struct GameTransition {
+	std::uint8_t points_player1 = 0;
+	std::uint8_t points_player2 = 0;
+	std::uint8_t winner = 0;
+};
+
+struct SetTransition {
+	std::uint8_t games_player1 = 0;
+	std::uint8_t games_player2 = 0;
+	std::uint8_t winner = 0;
+	std::uint8_t events = NO_EVENT;
+};
+
+class ScoringTableBuilder {
+public:
+	static constexpr int GAME_STATES = 5;
+	static constexpr int SET_STATES = ScoringEngine::GAMES_TO_WIN_SET + 1;
+	static constexpr int TIEBREAK_STATES = ScoringEngine::SUPER_TIEBREAK_POINTS + 1;
+
+	static constexpr std::size_t gameIndex(const int points_player1, const int points_player2, const int player) {
+		return (static_cast<std::size_t>(points_player1) * GAME_STATES + points_player2) * 2 + (player - 1);
+	}
+
+	static constexpr std::size_t setIndex(const bool is_final_set, const int games_player1, const int games_player2, const int player) {
+		return ((static_cast<std::size_t>(is_final_set) * SET_STATES + games_player1) * SET_STATES + games_player2) * 2 + (player - 1);
+	}
+
+	// Past max_points - 1 all, only the lead matters, so long tiebreaks fold back onto the table.
+	static constexpr std::size_t tiebreakIndex(const bool is_super, int points_player1, int points_player2, const int player) {
+		const int max_points = is_super ? ScoringEngine::SUPER_TIEBREAK_POINTS : ScoringEngine::TIEBREAK_POINTS;
+		const int lowest = points_player1 < points_player2 ? points_player1 : points_player2;
+		const int excess = lowest > max_points - 1 ? lowest - (max_points - 1) : 0;
+		points_player1 -= excess;
+		points_player2 -= excess;
+		return ((static_cast<std::size_t>(is_super) * TIEBREAK_STATES + points_player1) * TIEBREAK_STATES + points_player2) * 2 + (player - 1);
+	}
+
+	static constexpr auto buildGameTable() {
+		std::array<GameTransition, GAME_STATES * GAME_STATES * 2> table{};
+		for (int points_player1 = 0; points_player1 < GAME_STATES; ++points_player1) {
+			for (int points_player2 = 0; points_player2 < GAME_STATES; ++points_player2) {
+				for (int player = 1; player <= 2; ++player) {
+					const auto next = ScoringEngine::addGamePoint(points_player1, points_player2, player);
+					GameTransition& entry = table[gameIndex(points_player1, points_player2, player)];
+					entry.points_player1 = static_cast<std::uint8_t>(next.first);
+					entry.points_player2 = static_cast<std::uint8_t>(next.second);
+					entry.winner = static_cast<std::uint8_t>(ScoringEngine::gameWinner(next.first, next.second));
+				}
+			}
+		}
+		return table;
+	}
+
+	static constexpr auto buildSetTable() {
+		std::array<SetTransition, 2 * SET_STATES * SET_STATES * 2> table{};
+		for (int is_final_set = 0; is_final_set <= 1; ++is_final_set) {
+			for (int games_player1 = 0; games_player1 < SET_STATES; ++games_player1) {
+				for (int games_player2 = 0; games_player2 < SET_STATES; ++games_player2) {
+					for (int player = 1; player <= 2; ++player) {
+						const int next_games_player1 = games_player1 + (player == 1 ? 1 : 0);
+						const int next_games_player2 = games_player2 + (player == 2 ? 1 : 0);
+						SetTransition& entry = table[setIndex(is_final_set != 0, games_player1, games_player2, player)];
+						entry.games_player1 = static_cast<std::uint8_t>(next_games_player1);
+						entry.games_player2 = static_cast<std::uint8_t>(next_games_player2);
+						entry.winner = static_cast<std::uint8_t>(ScoringEngine::setWinner(next_games_player1, next_games_player2));
+						if (entry.winner == 0 && ScoringEngine::isTiebreak(next_games_player1, next_games_player2)) {
+							entry.events = is_final_set ? SUPER_TIEBREAK_STARTED : TIEBREAK_STARTED;
+						}
+					}
+				}
+			}
+		}
+		return table;
+	}
+
+	static constexpr auto buildTiebreakTable() {
+		std::array<std::uint8_t, 2 * TIEBREAK_STATES * TIEBREAK_STATES * 2> table{};
+		for (int is_super = 0; is_super <= 1; ++is_super) {
+			const int max_points = is_super ? ScoringEngine::SUPER_TIEBREAK_POINTS : ScoringEngine::TIEBREAK_POINTS;
+			for (int points_player1 = 0; points_player1 <= max_points; ++points_player1) {
+				for (int points_player2 = 0; points_player2 <= max_points; ++points_player2) {
+					for (int player = 1; player <= 2; ++player) {
+						table[tiebreakIndex(is_super != 0, points_player1, points_player2, player)] = static_cast<std::uint8_t>(
+							ScoringEngine::tiebreakWinner(points_player1 + (player == 1 ? 1 : 0), points_player2 + (player == 2 ? 1 : 0), max_points));
+					}
+				}
+			}
+		}
+		return table;
+	}
+
+};
+
+// ScoringEngine's rules precomputed into constexpr lookup tables, indexed by the score before a point and its winner.
+class ScoringTables : public ScoringTableBuilder {
+public:
+	static constexpr auto GAME_TABLE = buildGameTable();
+	static constexpr auto SET_TABLE = buildSetTable();
+	static constexpr auto TIEBREAK_TABLE = buildTiebreakTable();
+
+	static constexpr bool isFinalSet(const MatchScore& score) {
+		return ScoringEngine::tiebreakPoints(score.getSetNum(), score.no_sets) == ScoringEngine::SUPER_TIEBREAK_POINTS;
+	}
+
+	// Same results as ScoringEngine::scorePoint, driven by the tables.
+	static constexpr PointResult scorePoint(MatchScore& score, const int player) {
+		if (score.isFinished() || (player != 1 && player != 2)) {
+			PointResult result;
+			result.events = INVALID_POINT;
+			return result;
+		}
+
+		if (score.is_tiebreak) {
+			return scoreTiebreakPoint(score, player);
+		}
+
+		const GameTransition& game = GAME_TABLE[gameIndex(score.points_player1, score.points_player2, player)];
+		score.points_player1 = game.points_player1;
+		score.points_player2 = game.points_player2;
+		if (game.winner == 0) {
+			return PointResult();
+		}
+		return scoreGame(score, game.winner);
+	}
+
+	// Awards the current regular game outright, for callers that decide whole games at once.
+	static constexpr PointResult scoreGame(MatchScore& score, const int game_winner) {
+		PointResult result;
+		score.is_player_one_serving = !score.is_player_one_serving;
+		score.points_player1 = 0;
+		score.points_player2 = 0;
+
+		const SetTransition& set = SET_TABLE[setIndex(isFinalSet(score), score.games_player1, score.games_player2, game_winner)];
+		result.events |= GAME_WON | set.events;
+		result.game_winner = game_winner;
+		score.games_player1 = set.games_player1;
+		score.games_player2 = set.games_player2;
+		score.is_tiebreak = set.events != NO_EVENT;
+
+		if (set.winner != 0) {
+			completeSet(score, result, set.winner);
+		}
+		return result;
+	}
+
+	// Replays every game position of an opening game, every game-deciding point of each set score and every
+	// tiebreak position, in a first set and in a deciding set, through both implementations.
+	static constexpr bool matchesEngine() {
+		for (int sets_played = 0; sets_played <= 2; sets_played += 2) {
+			for (int games_player1 = 0; games_player1 < SET_STATES; ++games_player1) {
+				for (int games_player2 = 0; games_player2 < SET_STATES; ++games_player2) {
+					if (ScoringEngine::setWinner(games_player1, games_player2) != 0 ||
+						(games_player1 == 6 && games_player2 < 5) || (games_player2 == 6 && games_player1 < 5)) {
+						continue;
+					}
+					if (ScoringEngine::isTiebreak(games_player1, games_player2)) {
+						const int max_points = ScoringEngine::tiebreakPoints(sets_played + 1, 2);
+						for (int points_player1 = 0; points_player1 <= max_points + 1; ++points_player1) {
+							for (int points_player2 = 0; points_player2 <= max_points + 1; ++points_player2) {
+								if (ScoringEngine::tiebreakWinner(points_player1, points_player2, max_points) == 0 &&
+									!samePosition(sets_played, games_player1, games_player2, points_player1, points_player2)) {
+									return false;
+								}
+							}
+						}
+					}
+					else if (games_player1 == 0 && games_player2 == 0) {
+						for (int points_player1 = 0; points_player1 < GAME_STATES; ++points_player1) {
+							for (int points_player2 = 0; points_player2 < GAME_STATES; ++points_player2) {
+								if (ScoringEngine::gameWinner(points_player1, points_player2) == 0 &&
+									!samePosition(sets_played, 0, 0, points_player1, points_player2)) {
+									return false;
+								}
+							}
+						}
+					}
+					else if (!samePosition(sets_played, games_player1, games_player2, 3, 2) ||
+						!samePosition(sets_played, games_player1, games_player2, 2, 3)) {
+						return false;
+					}
+				}
+			}
+		}
+		return true;
+	}
+
+private:
+	static constexpr PointResult scoreTiebreakPoint(MatchScore& score, const int player) {
+		PointResult result;
+		const int tiebreak_winner = TIEBREAK_TABLE[tiebreakIndex(isFinalSet(score), score.points_player1, score.points_player2, player)];
+		(player == 1 ? score.points_player1 : score.points_player2)++;
+		const int points_played = score.points_player1 + score.points_player2;
+		if (tiebreak_winner == 0) {
+			if (ScoringEngine::isTiebreakServerChange(points_played)) {
+				score.is_player_one_serving = !score.is_player_one_serving;
+			}
+			return result;
+		}
+
+		const bool is_first_server_player_one = ((points_played / 2) % 2 == 0)
+			? score.is_player_one_serving : !score.is_player_one_serving;
+		score.is_player_one_serving = !is_first_server_player_one;
+		score.is_tiebreak = false;
+		score.points_player1 = 0;
+		score.points_player2 = 0;
+		result.events |= GAME_WON | TIEBREAK_WON;
+		result.game_winner = tiebreak_winner;
+		completeSet(score, result, tiebreak_winner);
+		return result;
+	}
+
+	static constexpr void completeSet(MatchScore& score, PointResult& result, const int set_winner) {
+		result.events |= SET_WON;
+		result.set_winner = set_winner;
+		(set_winner == 1 ? score.sets_player1 : score.sets_player2)++;
+		score.games_player1 = 0;
+		score.games_player2 = 0;
+		if (score.sets_player1 == score.no_sets || score.sets_player2 == score.no_sets) {
+			score.winner = set_winner;
+			result.events |= MATCH_WON;
+		}
+	}
+
+	static constexpr bool samePosition(const int sets_played, const int games_player1, const int games_player2,
+		const int points_player1, const int points_player2) {
+		for (int player = 1; player <= 2; ++player) {
+			MatchScore table_score;
+			table_score.no_sets = 2;
+			table_score.sets_player1 = sets_played / 2;
+			table_score.sets_player2 = sets_played / 2;
+			table_score.games_player1 = games_player1;
+			table_score.games_player2 = games_player2;
+			table_score.points_player1 = points_player1;
+			table_score.points_player2 = points_player2;
+			table_score.is_tiebreak = ScoringEngine::isTiebreak(games_player1, games_player2);
+			table_score.is_player_one_serving = (points_player1 + games_player2) % 2 == 0;
+			MatchScore engine_score = table_score;
+			if (!sameResult(table_score, engine_score, player)) return false;
+		}
+		return true;
+	}
+
+	static constexpr bool sameResult(MatchScore& table_score, MatchScore& engine_score, const int player) {
+		const PointResult table_result = scorePoint(table_score, player);
+		const PointResult engine_result = ScoringEngine::scorePoint(engine_score, player);
+		return table_result.events == engine_result.events &&
+			table_result.game_winner == engine_result.game_winner &&
+			table_result.set_winner == engine_result.set_winner &&
+			table_score.points_player1 == engine_score.points_player1 &&
+			table_score.points_player2 == engine_score.points_player2 &&
+			table_score.games_player1 == engine_score.games_player1 &&
+			table_score.games_player2 == engine_score.games_player2 &&
+			table_score.sets_player1 == engine_score.sets_player1 &&
+			table_score.sets_player2 == engine_score.sets_player2 &&
+			table_score.is_tiebreak == engine_score.is_tiebreak &&
+			table_score.is_player_one_serving == engine_score.is_player_one_serving &&
+			table_score.winner == engine_score.winner;
+	}
+};
+
+static_assert(ScoringTables::GAME_TABLE[ScoringTables::gameIndex(3, 4, 1)].points_player2 == 3, "Advantage must return to deuce.");
+static_assert(ScoringTables::SET_TABLE[ScoringTables::setIndex(false, 6, 5, 2)].events == TIEBREAK_STARTED, "6-6 must start a tiebreak.");
+static_assert(ScoringTables::SET_TABLE[ScoringTables::setIndex(true, 6, 5, 2)].events == SUPER_TIEBREAK_STARTED, "6-6 in the final set must start a super tiebreak.");
+static_assert(ScoringTables::matchesEngine(), "Scoring tables must agree with ScoringEngine.");
@@ -1,8 +1,11 @@
 #pragma once
 #include <chrono>
+#include <functional>
 #include <iostream>
 #include "Game.hpp"
+#include "ScoringEngine.hpp"
 #include "Timer.hpp"
+#include "UnitOfWork.hpp"
 
 class Set {
 private:
@@ -15,11 +18,14 @@ private:
     bool is_player_one_winner;
     bool is_player_one_serving;
     bool is_resumed_tiebreak = false;
+    std::optional<bool> resumed_tiebreak_server;
+    std::optional<std::pair<int, int>> resumed_tiebreak_points;
 
     Timer timer;
     std::chrono::seconds duration;
 
-	void updateMatchSetRecordWithoutServingPlayerId();
+	void updateMatchSetRecordWithoutServingPlayerId(UnitOfWork& uow);
+    long long takeElapsedSeconds();
     std::pair<int, int> getTieBreakScores() const;
     static int convertScore(const std::string& db_score);
     void randomizeFirstServer() {
@@ -31,6 +37,9 @@ private:
     std::string getGameLabel() const { return games_player1 + games_player2 == 1 ? " game: \t" : " games: \t"; }
     
 public:
+    // Supplies the tiebreak menu choice: 1 or 2 for a point, 3 to suspend, 4 to finish.
+    using TiebreakInput = std::function<int()>;
+
     Set(int match_id, int no_sets, int set_num = 1);
     Set(int match_id, int no_sets, int set_num, int games_player1, int games_player2, bool is_first_player_serving);
 
@@ -40,24 +49,31 @@ public:
     bool getIsPlayerOneServing() const { return this->is_player_one_serving; }
     void setIsResumedTiebreak(const bool is_resumed_tiebreak_p) { this->is_resumed_tiebreak = is_resumed_tiebreak_p; }
     bool getIsResumedTiebreak() const { return is_resumed_tiebreak; }
+    void setResumedTiebreakServer(const std::optional<bool>& is_player_one_serving_p) { resumed_tiebreak_server = is_player_one_serving_p; }
+    void setResumedTiebreakPoints(const std::optional<std::pair<int, int>>& points) { resumed_tiebreak_points = points; }
     int getSetNum() const { return set_num; }
     void setSetNum(const int set_num_p) { this->set_num = set_num_p; }
     std::optional<Game>& getCurrentGame() { return current_game; }
+    const std::optional<Game>& getCurrentGame() const { return current_game; }
     void setCurrentGame(const std::optional<Game>& game) { current_game = game; }
+    int getGamesPlayerOne() const { return games_player1; }
     void setGamesPlayerOne(const int games) { games_player1 = games; }
+    int getGamesPlayerTwo() const { return games_player2; }
     void setGamesPlayerTwo(const int games) { games_player2 = games; }
 
     void updateTiebreakStatus() const;
-    int getTiebreakPoints() const { return ((no_sets * 2 - 1) == set_num) ? 10 : 7; }
+    int getTiebreakPoints() const { return ScoringEngine::tiebreakPoints(set_num, no_sets); }
     bool isTieBreak() const;
 
     void resumeCurrentGame(bool is_serving);
-    int addGameResult(int winning_player_id);
+    void resumeCurrentGame(int points_player1, int points_player2, bool is_serving);
+    // A tiebreak reached here is played out with tiebreak_input, or the console when it is empty.
+    int addGameResult(int winning_player_id, UnitOfWork& uow, const TiebreakInput& tiebreak_input = nullptr);
     int getNumberOfGames() const { return games_player1 + games_player2; }
-    void changeGame()
+    void changeGame(UnitOfWork& uow)
 	{
         if (current_game.has_value()) {
-            current_game->resetGame(match_id, set_num);
+            current_game->resetGame(match_id, set_num, uow);
         }
         else {
             std::cerr << "Error: No current game to reset." << '\n';
@@ -65,9 +81,9 @@ public:
         }
     }
 
-    void addMatchSetRecord();
-    void updateMatchSetRecord();
-    void saveSetRecordToDatabase(bool is_new_record) const;
+    void addMatchSetRecord(UnitOfWork& uow);
+    void updateMatchSetRecord(UnitOfWork& uow);
+    void saveSetRecordToDatabase(bool is_new_record, UnitOfWork& uow) const;
 
     void printGameInfo() const
     {
@@ -75,30 +91,22 @@ public:
         std::cout << "Score after " << num_of_games << getGameLabel() << games_player1 << " - " << games_player2 << '\n';
     }
 
-    bool isWonSet() const
-	{
-        return (games_player1 >= 6 && games_player1 >= games_player2 + 2) ||
-            (games_player2 >= 6 && games_player2 >= games_player1 + 2);
-    }
-
-    int determineWinner() const
-	{
-        if (games_player1 >= 6 && games_player1 >= games_player2 + 2) return 1;
-        if (games_player2 >= 6 && games_player2 >= games_player1 + 2) return 2;
-        return 0;
-    }
+    bool isWonSet() const { return determineWinner() != 0; }
+    int determineWinner() const { return ScoringEngine::setWinner(games_player1, games_player2); }
 
-    void initializeCurrentGame(const bool is_serving)
+    void initializeCurrentGame(const bool is_serving, UnitOfWork& uow)
 	{
         if (!current_game.has_value()) {
             current_game = Game();
+            current_game->printGameInfo();
             current_game->setIsPlayerOneServing(is_serving);
             std::cout << "  Player " << (is_serving ? "1" : "2") << " is serving.\n";
             current_game->printCurScore();
-            current_game->saveGameRecord(match_id, set_num);
+            current_game->saveGameRecord(match_id, set_num, uow);
         }
     }
 
     void printSetInfo() const { std::cout << "Set: " << set_num << '\n'; }
 	void updateTime();
+	void updateTime(UnitOfWork& uow);
 };
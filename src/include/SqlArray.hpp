@@ -0,0 +1,33 @@
+#pragma once
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Array literals for binding whole columns as one parameter, e.g. "= ANY($1::int[])" or "unnest($1::int[], $2::float8[])".
+template<typename T>
+std::string toSqlArray(const std::vector<T>& values) {
+	std::ostringstream literal;
+	literal << std::setprecision(17) << '{';
+	for (std::size_t i = 0; i < values.size(); ++i) {
+		literal << (i == 0 ? "" : ",") << values[i];
+	}
+	literal << '}';
+	return literal.str();
+}
+
+// Elements are quoted and escaped, so any text (timestamps, names) can be bound.
+inline std::string toSqlArray(const std::vector<std::string>& values) {
+	std::string literal = "{";
+	for (std::size_t i = 0; i < values.size(); ++i) {
+		literal += i == 0 ? "\"" : ",\"";
+		for (const char c : values[i]) {
+			if (c == '"' || c == '\\') {
+				literal += '\\';
+			}
+			literal += c;
+		}
+		literal += '"';
+	}
+	return literal + "}";
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <pqxx/pqxx>
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+enum TableFormat {
+	TABLE_TEXT,
+	TABLE_CSV,
+	TABLE_JSON
+};
+
+struct TableColumn {
+	std::string title;
+	std::size_t width;
+	bool is_numeric = false;
+};
+
+// Writes rows as they arrive instead of building a whole table first: memory stays at one row and the first row
+// appears as soon as it is read. Text output uses fixed column widths, so no row needs to be seen in advance.
+class TableWriter {
+public:
+	static constexpr std::size_t DEFAULT_FETCH_SIZE = 500;
+
+	TableWriter(std::ostream& out, std::vector<TableColumn> columns, TableFormat format = TABLE_TEXT);
+
+	void writeRow(const std::vector<std::string>& cells);
+	void writeRow(const pqxx::row& row);
+	// Closes the JSON array and flushes. Safe to call more than once.
+	void finish();
+	std::size_t getRowCount() const { return rows_; }
+
+	// Runs query through a server-side cursor, fetching fetch_size rows at a time. Returns the number of rows written.
+	static std::size_t streamQuery(pqxx::work& txn, const std::string& query, TableWriter& writer, std::size_t fetch_size = DEFAULT_FETCH_SIZE);
+
+private:
+	std::ostream& out_;
+	std::vector<TableColumn> columns_;
+	std::vector<std::string> keys_;
+	TableFormat format_;
+	std::size_t rows_ = 0;
+	bool is_finished_ = false;
+
+	void writeHeader();
+	void writeText(const std::vector<std::string>& cells);
+	void writeCsv(const std::vector<std::string>& cells);
+	void writeJson(const std::vector<std::string>& cells);
+	static std::string fit(const std::string& cell, std::size_t width);
+	static std::string escapeCsv(const std::string& cell);
+	static std::string escapeJson(const std::string& cell);
+};
@@ -0,0 +1,50 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of workers, each with its own task deque. A worker runs its own tasks in submission order and steals
+// from the far end of a sibling's deque when it runs dry, so a burst on one worker spreads across the pool.
+class ThreadPool {
+public:
+	using Task = std::function<void()>;
+
+	explicit ThreadPool(unsigned threads = 0);
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	void submit(Task task);
+	std::size_t getThreadCount() const { return queues_.size(); }
+	unsigned long long getSteals() const { return steals_.load(std::memory_order_relaxed); }
+
+private:
+	struct WorkQueue {
+		std::mutex mutex;
+		std::deque<Task> tasks;
+	};
+
+	std::vector<std::unique_ptr<WorkQueue>> queues_;
+	std::vector<std::thread> workers_;
+	std::atomic<std::size_t> next_queue_{ 0 };
+	std::atomic<std::size_t> pending_{ 0 };
+	std::atomic<unsigned long long> steals_{ 0 };
+
+	std::mutex sleep_mutex_;
+	std::condition_variable work_available_;
+	bool is_stopping_ = false;
+
+	void run(std::size_t index);
+	bool popLocal(std::size_t index, Task& task);
+	bool steal(std::size_t index, Task& task);
+
+	static thread_local ThreadPool* current_pool_;
+	static thread_local std::size_t current_index_;
+};
@@ -1,25 +1,47 @@
 #pragma once
 #include "DatabaseConnection.hpp"
+#include "TableWriter.hpp"
+#include "UnitOfWork.hpp"
 #include <string>
+#include <vector>
 
 class Match;
+struct MatchRecord;
 
 int getNumericInput(const std::string& prompt);
+// Accepts a numeric ID or a name to search for; returns 0 when nothing was chosen.
+int getPlayerInput(const std::string& prompt);
 
 class UIManager {
-private:
+public:
     static constexpr int MAX_SETS_TO_WIN = 3;
 
+private:
+    static inline const std::vector<TableColumn> MATCH_SUMMARY_COLUMNS{
+        { "ID", 6, true }, { "Status", 10 }, { "Player 1", 24 }, { "Player 2", 24 }, { "Winner", 24 }, { "Score in Sets", 13 }, { "Duration", 8 } };
+    static inline const std::vector<TableColumn> MATCH_HISTORY_COLUMNS{
+        { "ID", 6, true }, { "Player 1", 24 }, { "Player 2", 24 }, { "Winner", 24 }, { "Score in Sets", 13 }, { "Duration", 8 } };
+
     static void addPlayer();
     static void showPlayers();
     static void addMatch();
     static void showMatches();
     static void showAllMatches();
     static void showMatchDetails();
+    static void showLiveScores();
+    static void exportMatches();
+    static void importPlayers();
+    static void importSchedule();
+    static void showLeaderboard();
+    static void recomputeRatings();
     static void showMatchesResultsForPlayer();
+    static void showHeadToHead();
+    static void showPlayerHistory();
+    static void searchPlayers();
+    static std::vector<std::string> toHistoryRow(const MatchRecord& match);
     static void handleMatchSuspension(Match& match);
     static void handleMatchFinishing(Match& match);
-    static void handleSetContinuation(Match& match, int game_status);
+    static void handleSetContinuation(Match& match, int game_status, UnitOfWork& uow);
     static void updateMatchStatus(Match& match);
 
     void startMatch();
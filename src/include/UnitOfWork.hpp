@@ -0,0 +1,29 @@
+#pragma once
+#include "PersistenceQueue.hpp"
+#include <exception>
+#include <vector>
+
+class UnitOfWork {
+private:
+	int match_id_;
+	std::vector<PersistenceQueue::Write> writes_;
+	long long duration_seconds_ = 0;
+	int uncaught_exceptions_;
+
+public:
+	explicit UnitOfWork(int match_id) : match_id_(match_id), uncaught_exceptions_(std::uncaught_exceptions()) {}
+	// Writes that were never committed are dropped, so a scoring event cut short by an exception leaves no trace.
+	~UnitOfWork();
+
+	UnitOfWork(const UnitOfWork&) = delete;
+	UnitOfWork& operator=(const UnitOfWork&) = delete;
+
+	int getMatchId() const { return match_id_; }
+	bool empty() const { return writes_.empty() && duration_seconds_ == 0; }
+
+	void add(PersistenceQueue::Write write) { writes_.push_back(std::move(write)); }
+	void addDuration(const long long seconds) { duration_seconds_ += seconds; }
+
+	// Hands every gathered write to the persistence queue as one entry, so they commit in a single transaction.
+	void commit();
+};
@@ -1,7 +1,11 @@
 #pragma once
 #include <string>
+#include <cstddef>
 #include <ctime>
 
+// Matches the width of players.first_name and players.last_name.
+constexpr std::size_t MAX_NAME_LENGTH = 25;
+
 std::string formatName(const std::string& str);
 bool isAlpha(const std::string& str);
 
@@ -0,0 +1,209 @@
+#include "ConnectionPool.hpp"
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+
+ConnectionPool::ConnectionPool(Factory factory, const std::size_t size, const std::chrono::milliseconds checkout_timeout)
+    : factory_(std::move(factory)), size_(std::max<std::size_t>(size, 1)), checkout_timeout_(checkout_timeout) {
+    connections_.reserve(size_);
+    idle_.reserve(size_);
+}
+
+ConnectionPool::~ConnectionPool() {
+    close();
+}
+
+ConnectionLease ConnectionPool::acquire() {
+    const auto started = std::chrono::steady_clock::now();
+    const auto deadline = started + checkout_timeout_;
+    bool was_blocked = false;
+    pqxx::connection* conn = nullptr;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!conn) {
+        if (is_closed_) {
+            throw std::runtime_error("Connection pool is closed.");
+        }
+
+        if (!idle_.empty()) {
+            conn = idle_.back();
+            idle_.pop_back();
+        }
+        else if (connections_.size() + opening_ < size_) {
+            ++opening_;
+            lock.unlock();
+            conn = open();
+            lock.lock();
+            --opening_;
+
+            if (!conn) {
+                available_.notify_one();
+                throw std::runtime_error("Failed to open database connection.");
+            }
+        }
+        else {
+            was_blocked = true;
+            if (available_.wait_until(lock, deadline) == std::cv_status::timeout &&
+                idle_.empty() && connections_.size() + opening_ >= size_) {
+                ++metrics_.timeouts;
+                throw std::runtime_error("Timed out waiting for a database connection.");
+            }
+        }
+    }
+    recordWait(std::chrono::steady_clock::now() - started, was_blocked);
+    lock.unlock();
+
+    if (!conn->is_open()) {
+        conn = replace(conn);
+    }
+
+    return ConnectionLease(conn, [this](pqxx::connection* leased) { release(leased); });
+}
+
+void ConnectionPool::release(pqxx::connection* conn) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        idle_.push_back(conn);
+    }
+    available_.notify_one();
+}
+
+pqxx::connection* ConnectionPool::open() {
+    std::unique_ptr<pqxx::connection> fresh;
+    try {
+        fresh = factory_();
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Exception while opening pooled connection: " << e.what() << '\n';
+    }
+
+    if (!fresh || !fresh->is_open()) {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    connections_.push_back(std::move(fresh));
+    return connections_.back().get();
+}
+
+pqxx::connection* ConnectionPool::replace(pqxx::connection* conn) {
+    std::unique_ptr<pqxx::connection> fresh;
+    try {
+        fresh = factory_();
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Exception while reconnecting pooled connection: " << e.what() << '\n';
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = std::find_if(connections_.begin(), connections_.end(),
+        [conn](const std::unique_ptr<pqxx::connection>& owned) { return owned.get() == conn; });
+
+    if (!fresh || !fresh->is_open()) {
+        if (it != connections_.end()) {
+            connections_.erase(it);
+        }
+        available_.notify_one();
+        throw std::runtime_error("Failed to reconnect to the database.");
+    }
+
+    ++metrics_.reconnects;
+    pqxx::connection* replacement = fresh.get();
+    if (it != connections_.end()) {
+        *it = std::move(fresh);
+    }
+    else {
+        connections_.push_back(std::move(fresh));
+    }
+    return replacement;
+}
+
+bool ConnectionPool::isHealthy(pqxx::connection& conn) {
+    if (!conn.is_open()) {
+        return false;
+    }
+
+    try {
+        pqxx::nontransaction nt(conn);
+        nt.exec("SELECT 1;");
+        return true;
+    }
+    catch (const std::exception&) {
+        return false;
+    }
+}
+
+std::size_t ConnectionPool::healthCheck() {
+    std::vector<pqxx::connection*> to_check;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        to_check.swap(idle_);
+    }
+
+    std::size_t healthy = 0;
+    std::vector<pqxx::connection*> checked;
+    checked.reserve(to_check.size());
+
+    for (pqxx::connection* conn : to_check) {
+        if (isHealthy(*conn)) {
+            ++healthy;
+            checked.push_back(conn);
+            continue;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++metrics_.failed_health_checks;
+        }
+
+        try {
+            checked.push_back(replace(conn));
+            ++healthy;
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Health check could not restore connection: " << e.what() << '\n';
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        idle_.insert(idle_.end(), checked.begin(), checked.end());
+    }
+    available_.notify_all();
+    return healthy;
+}
+
+PoolMetrics ConnectionPool::getMetrics() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    PoolMetrics snapshot = metrics_;
+    snapshot.size = size_;
+    snapshot.open = connections_.size();
+    snapshot.idle = idle_.size();
+    return snapshot;
+}
+
+void ConnectionPool::close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (is_closed_) {
+        return;
+    }
+    is_closed_ = true;
+
+    for (const auto& conn : connections_) {
+        if (conn && conn->is_open()) {
+            conn->close();
+        }
+    }
+    available_.notify_all();
+}
+
+void ConnectionPool::recordWait(const std::chrono::steady_clock::duration waited, const bool was_blocked) {
+    const auto waited_us = std::chrono::duration_cast<std::chrono::microseconds>(waited);
+    ++metrics_.checkouts;
+    if (was_blocked) {
+        ++metrics_.blocked_checkouts;
+    }
+    metrics_.total_wait += waited_us;
+    metrics_.max_wait = std::max(metrics_.max_wait, waited_us);
+}
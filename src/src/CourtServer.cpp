@@ -0,0 +1,352 @@
+#include "CourtServer.hpp"
+#include "DatabaseConnection.hpp"
+#include "LiveScoreCache.hpp"
+#include "PersistenceQueue.hpp"
+#include "PointLog.hpp"
+#include "PreparedStatements.hpp"
+#include "ReferenceData.hpp"
+#include "ScoreEventBus.hpp"
+#include <condition_variable>
+#include <mutex>
+#include <sstream>
+#include <string>
+
+CourtServer::CourtServer(const unsigned threads, const bool is_persistent)
+    : pool_(threads), is_persistent_(is_persistent) {
+    if (is_persistent_) {
+        PointLog::getInstance();
+    }
+}
+
+bool CourtServer::openMatch(const int match_id, const bool is_player_one_serving, const bool is_takeover) {
+    if (findMatch(match_id)) {
+        return true;
+    }
+
+    const std::optional<MatchInfo> info = loadMatch(match_id, is_player_one_serving);
+    if (!info) {
+        return false;
+    }
+    if (info->score.isFinished() || !isOpenable(info->status_id, is_takeover)) {
+        std::cerr << "Match " << match_id << " cannot be opened from status "
+            << ReferenceData::getInstance().getStatusName(info->status_id).value_or("unknown")
+            << (is_takeover ? ".\n" : " without a takeover.\n");
+        return false;
+    }
+
+    // Losing the race to a concurrent open still leaves the match open here.
+    insertMatch(*info, true);
+    return true;
+}
+
+bool CourtServer::openMatch(const MatchInfo& info) {
+    return insertMatch(info, false);
+}
+
+// The Started write is queued and the opening score cached and published before the actor becomes reachable, so none
+// of them can overtake the first point. Returns false if the match was already open.
+bool CourtServer::insertMatch(const MatchInfo& info, const bool is_marking_started) {
+    const int started_status_id = ReferenceData::getInstance().getStatusId("Started");
+    std::unique_lock<std::shared_mutex> lock(matches_mutex_);
+    if (!matches_.emplace(info.match_id, std::make_shared<MatchActor>(info, pool_, is_persistent_)).second) {
+        return false;
+    }
+    if (is_marking_started) {
+        const int match_id = info.match_id;
+        PersistenceQueue::getInstance().enqueue(match_id, [=](pqxx::work& txn) {
+            PreparedStatements::exec<UpdateMatchStatusQuery>(txn, started_status_id, match_id);
+        });
+    }
+    LiveScoreCache::getInstance().upsert(LiveMatch{ info.match_id, started_status_id,
+        info.player_id1, info.player_id2, info.player1_name, info.player2_name, CompactScore::fromMatchScore(info.score) });
+    ScoreEventBus::getInstance().publish(info.match_id, CompactScore::fromMatchScore(info.score), NO_EVENT);
+    return true;
+}
+
+// Pending, delayed and suspended matches can be opened; started ones only as a takeover; finished ones never.
+bool CourtServer::isOpenable(const int status_id, const bool is_takeover) {
+    const ReferenceData& reference = ReferenceData::getInstance();
+    if (status_id == reference.getStatusId("Started")) {
+        return is_takeover;
+    }
+    for (const char* status : { "Pending", "Delayed", "Suspended" }) {
+        if (status_id == reference.getStatusId(status)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void CourtServer::closeMatch(const int match_id) {
+    takeMatch(match_id);
+}
+
+std::shared_ptr<MatchActor> CourtServer::takeMatch(const int match_id) {
+    std::unique_lock<std::shared_mutex> lock(matches_mutex_);
+    const auto found = matches_.find(match_id);
+    if (found == matches_.end()) {
+        return nullptr;
+    }
+    std::shared_ptr<MatchActor> actor = std::move(found->second);
+    matches_.erase(found);
+    return actor;
+}
+
+// Parks the match in the Suspended state and drops it from this server; reopening it replays the point log. The actor
+// is stopped through its mailbox first, so every point it accepted is queued ahead of the status write.
+SuspendResult CourtServer::suspendMatch(const int match_id) {
+    const std::shared_ptr<MatchActor> actor = takeMatch(match_id);
+    if (!actor) {
+        return SuspendResult::NOT_LIVE;
+    }
+    actor->stop().wait();
+
+    const int suspended_status_id = ReferenceData::getInstance().getStatusId("Suspended");
+    LiveScoreCache::getInstance().setStatus(match_id, suspended_status_id);
+    PersistenceQueue& queue = PersistenceQueue::getInstance();
+    queue.addDuration(match_id, actor->getSessionSeconds());
+    queue.enqueue(match_id, [=](pqxx::work& txn) {
+        PreparedStatements::exec<UpdateMatchStatusQuery>(txn, suspended_status_id, match_id);
+    });
+    return queue.flush() ? SuspendResult::SUSPENDED : SuspendResult::NOT_SAVED;
+}
+
+std::future<PointAck> CourtServer::submitPoint(const int match_id, const int player) {
+    const std::shared_ptr<MatchActor> actor = findMatch(match_id);
+    return actor ? actor->post(player) : rejected(match_id);
+}
+
+std::future<PointAck> CourtServer::finishMatch(const int match_id, const int winner) {
+    const std::shared_ptr<MatchActor> actor = findMatch(match_id);
+    return actor ? actor->finish(winner) : rejected(match_id);
+}
+
+void CourtServer::submitPoint(const int match_id, const int player, MatchActor::AckCallback on_ack) {
+    const std::shared_ptr<MatchActor> actor = findMatch(match_id);
+    if (actor) {
+        actor->post(player, std::move(on_ack));
+    }
+    else {
+        on_ack(rejectedAck(match_id));
+    }
+}
+
+void CourtServer::finishMatch(const int match_id, const int winner, MatchActor::AckCallback on_ack) {
+    const std::shared_ptr<MatchActor> actor = findMatch(match_id);
+    if (actor) {
+        actor->finish(winner, std::move(on_ack));
+    }
+    else {
+        on_ack(rejectedAck(match_id));
+    }
+}
+
+PointAck CourtServer::rejectedAck(const int match_id) {
+    PointAck ack;
+    ack.match_id = match_id;
+    ack.received_at = std::chrono::steady_clock::now();
+    ack.acked_at = ack.received_at;
+    return ack;
+}
+
+std::future<PointAck> CourtServer::rejected(const int match_id) {
+    std::promise<PointAck> promise;
+    promise.set_value(rejectedAck(match_id));
+    return promise.get_future();
+}
+
+std::optional<CompactScore> CourtServer::getScore(const int match_id) const {
+    const std::shared_ptr<MatchActor> actor = findMatch(match_id);
+    if (!actor) {
+        return std::nullopt;
+    }
+    return actor->getScore();
+}
+
+std::vector<int> CourtServer::getMatchIds() const {
+    std::shared_lock<std::shared_mutex> lock(matches_mutex_);
+    std::vector<int> ids;
+    ids.reserve(matches_.size());
+    for (const auto& [match_id, actor] : matches_) {
+        ids.push_back(match_id);
+    }
+    return ids;
+}
+
+std::shared_ptr<MatchActor> CourtServer::findMatch(const int match_id) const {
+    std::shared_lock<std::shared_mutex> lock(matches_mutex_);
+    const auto found = matches_.find(match_id);
+    return found == matches_.end() ? nullptr : found->second;
+}
+
+// Rebuilds a match from its row and its point log, so a court can be reopened on any server after a restart.
+std::optional<MatchInfo> CourtServer::loadMatch(const int match_id, const bool is_player_one_serving) {
+    MatchInfo info;
+    info.match_id = match_id;
+    int no_sets = 0;
+
+    try {
+        ConnectionLease lease = DatabaseConnection::getInstance().acquire();
+        pqxx::nontransaction nt(*lease);
+        const pqxx::result r = nt.exec(
+            "SELECT m.status_id, m.player_id1, m.player_id2, m.no_sets, EXTRACT(EPOCH FROM m.duration)::int AS duration_seconds, "
+            "p1.first_name || ' ' || p1.last_name AS player1_name, p2.first_name || ' ' || p2.last_name AS player2_name "
+            "FROM public.matches m "
+            "JOIN public.players p1 ON m.player_id1 = p1.id "
+            "JOIN public.players p2 ON m.player_id2 = p2.id "
+            "WHERE m.id = " + nt.quote(match_id) + ";");
+        if (r.empty()) {
+            std::cerr << "No match found with ID: " << match_id << '\n';
+            return std::nullopt;
+        }
+        info.status_id = r[0]["status_id"].as<int>();
+        info.player_id1 = r[0]["player_id1"].as<int>();
+        info.player_id2 = r[0]["player_id2"].as<int>();
+        info.player1_name = r[0]["player1_name"].as<std::string>();
+        info.player2_name = r[0]["player2_name"].as<std::string>();
+        no_sets = r[0]["no_sets"].as<int>();
+        info.duration_seconds = r[0]["duration_seconds"].as<int>();
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Exception while loading match " << match_id << ": " << e.what() << '\n';
+        return std::nullopt;
+    }
+
+    PersistenceQueue::getInstance().flush();
+    const std::vector<PointEvent> events = PointLog::load(match_id);
+    info.score = PointLog::replay(no_sets, events);
+    if (events.empty()) {
+        info.score.is_player_one_serving = is_player_one_serving;
+    }
+    PointLog::getInstance().setLastSeq(match_id, events.empty() ? 0 : events.back().seq);
+    return info;
+}
+
+// One client's output: replies to the reader and acks from pool workers interleave line by line, and the client is only
+// let go once every ack it is owed has been written.
+class CourtServer::AckWriter {
+public:
+    explicit AckWriter(std::ostream& out) : out_(out) {}
+
+    void write(const std::string& line) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        out_ << line << '\n';
+        out_.flush();
+    }
+
+    void writeAck(const PointAck& ack) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        printAck(out_, ack);
+        out_.flush();
+    }
+
+    MatchActor::AckCallback track() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++pending_;
+        }
+        return [this](const PointAck& ack) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                printAck(out_, ack);
+                out_.flush();
+                --pending_;
+            }
+            drained_.notify_all();
+        };
+    }
+
+    void waitForAcks() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        drained_.wait(lock, [this]() { return pending_ == 0; });
+    }
+
+private:
+    std::ostream& out_;
+    std::mutex mutex_;
+    std::condition_variable drained_;
+    std::size_t pending_ = 0;
+};
+
+void CourtServer::run(std::istream& in, std::ostream& out) {
+    AckWriter writer(out);
+    std::string line;
+    while (std::getline(in, line)) {
+        std::istringstream command(line);
+        std::string verb;
+        int match_id = 0;
+        if (!(command >> verb)) {
+            continue;
+        }
+        if (verb == "quit") {
+            break;
+        }
+        if (!(command >> match_id)) {
+            writer.write("error missing match id");
+            continue;
+        }
+
+        const std::string id = std::to_string(match_id);
+        if (verb == "open") {
+            int server = 1;
+            std::string takeover;
+            command >> server >> takeover;
+            writer.write((openMatch(match_id, server != 2, takeover == "takeover") ? "ok " : "error ") + id);
+        }
+        else if (verb == "point") {
+            int player = 0;
+            command >> player;
+            submitPoint(match_id, player, writer.track());
+        }
+        else if (verb == "score") {
+            const std::optional<CompactScore> score = getScore(match_id);
+            if (score) {
+                PointAck ack;
+                ack.match_id = match_id;
+                ack.is_accepted = true;
+                ack.score = *score;
+                writer.writeAck(ack);
+            }
+            else {
+                writer.write("error unknown match " + id);
+            }
+        }
+        else if (verb == "suspend") {
+            // Points already sent for the match are applied and logged before it is parked.
+            writer.waitForAcks();
+            writer.write((suspendMatch(match_id) == SuspendResult::SUSPENDED ? "ok " : "error ") + id);
+        }
+        else if (verb == "finish") {
+            int winner = 0;
+            command >> winner;
+            finishMatch(match_id, winner, writer.track());
+        }
+        else if (verb == "close") {
+            writer.waitForAcks();
+            closeMatch(match_id);
+            writer.write("ok " + id);
+        }
+        else {
+            writer.write("error unknown command " + verb);
+        }
+    }
+    writer.waitForAcks();
+}
+
+void CourtServer::printAck(std::ostream& out, const PointAck& ack) {
+    if (!ack.is_accepted) {
+        out << "error rejected " << ack.match_id << '\n';
+        return;
+    }
+    const CompactScore& score = ack.score;
+    out << "ok " << ack.match_id
+        << " sets " << score.getSetsPlayerOne() << '-' << score.getSetsPlayerTwo()
+        << " games " << score.getGamesPlayerOne() << '-' << score.getGamesPlayerTwo()
+        << " points " << score.getPointsPlayerOne() << '-' << score.getPointsPlayerTwo()
+        << " serving " << (score.getIsPlayerOneServing() ? 1 : 2)
+        << " events " << static_cast<int>(ack.events);
+    if (score.isFinished()) {
+        out << " winner " << score.getWinner();
+    }
+    out << '\n';
+}
@@ -1,33 +1,42 @@
 #include "DatabaseConnection.hpp"
+#include "PreparedStatements.hpp"
 #include <iostream>
 
+std::size_t DatabaseConnection::pool_size_ = DatabaseConnection::DEFAULT_POOL_SIZE;
+
 DatabaseConnection& DatabaseConnection::getInstance() {
     static DatabaseConnection instance;
     return instance;
 }
 
-pqxx::connection* DatabaseConnection::getConnection() {
-    return conn_.get();
+void DatabaseConnection::setPoolSize(const std::size_t size) {
+    pool_size_ = size;
 }
 
-DatabaseConnection::DatabaseConnection() {
-    initializeConnection();
+ConnectionLease DatabaseConnection::acquire() {
+    return pool_->acquire();
 }
 
+DatabaseConnection::DatabaseConnection()
+    : pool_(std::make_unique<ConnectionPool>(&DatabaseConnection::initializeConnection, pool_size_)) {}
+
 DatabaseConnection::~DatabaseConnection() {
     closeConnection();
 }
 
-void DatabaseConnection::initializeConnection() {
+std::unique_ptr<pqxx::connection> DatabaseConnection::initializeConnection() {
     try {
-        conn_ = std::make_unique<pqxx::connection>("host=localhost dbname=postgres user=postgres password=password");
-        if (!conn_->is_open()) {
+        auto conn = std::make_unique<pqxx::connection>("host=localhost dbname=postgres user=postgres password=password");
+        if (!conn->is_open()) {
             std::cerr << "Database connection failed.\n";
             throw std::runtime_error("Failed to open database connection.");
         }
+        PreparedStatements::prepareAll(*conn);
+        return conn;
     }
     catch (const std::exception& e) {
         handleException(e);
+        return nullptr;
     }
 }
 
@@ -36,8 +45,8 @@ void DatabaseConnection::handleException(const std::exception& e) {
 }
 
 void DatabaseConnection::closeConnection() const {
-    if (conn_ && conn_->is_open()) {
-        conn_->close();
+    if (pool_) {
+        pool_->close();
         std::cout << "Database connection closed.\n";
     }
 }
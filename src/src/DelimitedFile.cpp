@@ -0,0 +1,91 @@
+#include "DelimitedFile.hpp"
+#include <algorithm>
+#include <cctype>
+
+std::vector<DelimitedRecord> DelimitedFile::read(std::istream& in) {
+    std::vector<DelimitedRecord> records;
+    std::string line;
+    std::size_t line_number = 0;
+    char delimiter = 0;
+
+    while (std::getline(in, line)) {
+        ++line_number;
+        if (line_number == 1 && line.compare(0, 3, "\xEF\xBB\xBF") == 0) {
+            line.erase(0, 3);
+        }
+        if (trim(line).empty()) {
+            continue;
+        }
+        if (delimiter == 0) {
+            delimiter = detectDelimiter(line);
+        }
+
+        std::vector<std::string> fields = splitRecord(line, delimiter);
+        for (auto& field : fields) {
+            field = trim(field);
+        }
+        records.push_back(DelimitedRecord{ line_number, std::move(fields) });
+    }
+    return records;
+}
+
+std::optional<std::size_t> DelimitedFile::findColumn(const std::vector<std::string>& header, const std::initializer_list<const char*> names) {
+    for (std::size_t i = 0; i < header.size(); ++i) {
+        std::string field = header[i];
+        std::transform(field.begin(), field.end(), field.begin(), [](const unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        for (const char* name : names) {
+            if (field == name) {
+                return i;
+            }
+        }
+    }
+    return std::nullopt;
+}
+
+std::string DelimitedFile::trim(const std::string& value) {
+    const std::size_t begin = value.find_first_not_of(" \t\r\n");
+    if (begin == std::string::npos) {
+        return "";
+    }
+    return value.substr(begin, value.find_last_not_of(" \t\r\n") - begin + 1);
+}
+
+char DelimitedFile::detectDelimiter(const std::string& line) {
+    if (line.find('\t') != std::string::npos) {
+        return '\t';
+    }
+    if (line.find(';') != std::string::npos && line.find(',') == std::string::npos) {
+        return ';';
+    }
+    return ',';
+}
+
+std::vector<std::string> DelimitedFile::splitRecord(const std::string& line, const char delimiter) {
+    std::vector<std::string> fields(1);
+    bool is_quoted = false;
+    for (std::size_t i = 0; i < line.size(); ++i) {
+        const char c = line[i];
+        if (is_quoted) {
+            if (c == '"' && i + 1 < line.size() && line[i + 1] == '"') {
+                fields.back() += '"';
+                ++i;
+            }
+            else if (c == '"') {
+                is_quoted = false;
+            }
+            else {
+                fields.back() += c;
+            }
+        }
+        else if (c == '"') {
+            is_quoted = true;
+        }
+        else if (c == delimiter) {
+            fields.emplace_back();
+        }
+        else {
+            fields.back() += c;
+        }
+    }
+    return fields;
+}
@@ -2,13 +2,17 @@
 #include <iostream>
 #include <string>
 #include <DatabaseConnection.hpp>
+#include "PersistenceQueue.hpp"
+#include "PointLog.hpp"
+#include "PreparedStatements.hpp"
+#include "ScoringEngine.hpp"
+#include <tuple>
 
 Game::Game()
 {
     this->points_player1 = 0;
     this->points_player2 = 0;
     this->game_num = 1;
-    printGameInfo();
 }
 
 Game::Game(const int points_player1, const int points_player2, const int game_num)
@@ -16,49 +20,18 @@ Game::Game(const int points_player1, const int points_player2, const int game_nu
     this->points_player1 = points_player1;
     this->points_player2 = points_player2;
     this->game_num = game_num;
-    printGameInfo();
 }
 
 void Game::addPoint(const int player, const int match_id, const int set_num) {
-    if (player == 1) {
-        if (points_player1 >= 3 && points_player2 >= 3) {
-            if (points_player1 == 4) {
-                points_player1++;
-            }
-            else if (points_player1 == 3 && points_player2 == 4) {
-                points_player2--;
-            }
-            else {
-                points_player1++;
-            }
-        }
-        else {
-            points_player1++;
-        }
-        std::cout << "Point for player 1.\n";
-    }
-    else if (player == 2) {
-        if (points_player1 >= 3 && points_player2 >= 3) { 
-            if (points_player2 == 4) {
-                points_player2++;
-            }
-            else if (points_player2 == 3 && points_player1 == 4) { 
-                points_player1--;
-            }
-            else {
-                points_player2++;
-            }
-        }
-        else {
-            points_player2++;
-        }
-        std::cout << "Point for player 2.\n";
-    }
-    else {
+    if (player != 1 && player != 2) {
         std::cerr << "Invalid player number: " << player << '\n';
         return;
     }
 
+    PointLog::getInstance().record(match_id, player, is_player_one_serving);
+    std::tie(points_player1, points_player2) = ScoringEngine::addGamePoint(points_player1, points_player2, player);
+    std::cout << "Point for player " << player << ".\n";
+
     if (!isWonGame()) {
         updateGameRecord(match_id, set_num);
         printCurScore();
@@ -66,17 +39,16 @@ void Game::addPoint(const int player, const int match_id, const int set_num) {
 }
 
 int Game::determineWinner() const {
-    if (points_player1 >= 4 && points_player1 >= points_player2 + 2) {
+    const int winner = ScoringEngine::gameWinner(points_player1, points_player2);
+    if (winner == 1) {
         std::cout << "Player 1 wins the " << game_num << " game with a score of " << getScoreString(points_player1 - 1)
             << " - " << getScoreString(points_player2) << '\n';
-        return 1;
     }
-    if (points_player2 >= 4 && points_player2 >= points_player1 + 2) {
+    else if (winner == 2) {
         std::cout << "Player 2 wins the " << game_num << " game with a score of " << getScoreString(points_player1)
             << " - " << getScoreString(points_player2 - 1) << '\n';
-        return 2;
     }
-    return 0;
+    return winner;
 }
 
 
@@ -93,52 +65,37 @@ std::string Game::getScoreString(const int points) {
     }
 }
 
-void Game::saveGameRecordToDatabase(const bool is_new_record, const int match_id, const int set_num) const {
-    DatabaseConnection& db = DatabaseConnection::getInstance();
-
-    try {
-        pqxx::work txn(*db.getConnection());
-        std::string query;
+PersistenceQueue::Write Game::gameRecordWrite(const bool is_new_record, const int match_id, const int set_num) const {
+    const int game_number = game_num;
+    const std::string player1_points = getScoreString(points_player1);
+    const std::string player2_points = getScoreString(points_player2);
 
-        if (is_new_record) {
-            query = "INSERT INTO game_points (match_id, set_number, game_number, player1_points, player2_points) VALUES (" +
-                txn.quote(match_id) + ", " +
-                txn.quote(set_num) + ", " +
-                txn.quote(game_num) + ", " +
-                txn.quote(getScoreString(points_player1)) + ", " +
-                txn.quote(getScoreString(points_player2)) + ")";
-        }
-        else {
-            query = "UPDATE game_points SET player1_points = " + txn.quote(getScoreString(points_player1)) + ", " +
-                "player2_points = " + txn.quote(getScoreString(points_player2)) +
-                " WHERE match_id = " + txn.quote(match_id) +
-                " AND set_number = " + txn.quote(set_num) +
-                " AND game_number = " + txn.quote(game_num);
-        }
-        txn.exec(query);
-        txn.commit();
-    }
-    catch (const std::exception& e) {
-        std::cerr << (is_new_record ? "Error saving game record to database: " : "Error updating game record in database: ") << e.what() << std::endl;
-        throw std::runtime_error(is_new_record ? "Failed to save game record" : "Failed to update game record");
+    if (is_new_record) {
+        return [=](pqxx::work& txn) {
+            PreparedStatements::exec<InsertGamePointsQuery>(txn, match_id, set_num, game_number, player1_points, player2_points);
+        };
     }
+    return [=](pqxx::work& txn) {
+        PreparedStatements::exec<UpdateGamePointsQuery>(txn, player1_points, player2_points, match_id, set_num, game_number);
+    };
 }
 
-void Game::saveGameRecord(const int match_id, const int set_num) const {
-    saveGameRecordToDatabase(true, match_id, set_num);
+void Game::saveGameRecord(const int match_id, const int set_num, UnitOfWork& uow) const {
+    uow.add(gameRecordWrite(true, match_id, set_num));
 }
 
 void Game::updateGameRecord(const int match_id, const int set_num) const {
-    saveGameRecordToDatabase(false, match_id, set_num);
+    PersistenceQueue::getInstance().enqueue(match_id, "game:" + std::to_string(set_num) + ':' + std::to_string(game_num),
+        gameRecordWrite(false, match_id, set_num));
 }
 
-void Game::resetGame(const int match_id, const int set_num) {
+void Game::resetGame(const int match_id, const int set_num, UnitOfWork& uow) {
     points_player1 = 0;
     points_player2 = 0;
     game_num++;
     printGameInfo();
     checkServer();
-    saveGameRecord(match_id, set_num);
+    saveGameRecord(match_id, set_num, uow);
     printCurScore();
 }
 
@@ -0,0 +1,388 @@
+#include "HttpServer.hpp"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "Ws2_32.lib")
+using SocketHandle = SOCKET;
+static constexpr SocketHandle NO_SOCKET = INVALID_SOCKET;
+static void closeSocket(const SocketHandle socket) { closesocket(socket); }
+static void shutdownSocket(const SocketHandle socket) { shutdown(socket, SD_BOTH); }
+static constexpr int SEND_FLAGS = 0;
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+using SocketHandle = int;
+static constexpr SocketHandle NO_SOCKET = -1;
+static void closeSocket(const SocketHandle socket) { close(socket); }
+static void shutdownSocket(const SocketHandle socket) { shutdown(socket, SHUT_RDWR); }
+static constexpr int SEND_FLAGS = MSG_NOSIGNAL;
+#endif
+
+static SocketHandle toSocket(const std::intptr_t handle) { return static_cast<SocketHandle>(handle); }
+
+static bool sendAll(const SocketHandle socket, const std::string& data) {
+    std::size_t sent = 0;
+    while (sent < data.size()) {
+        const int chunk = static_cast<int>(std::min<std::size_t>(data.size() - sent, 1 << 20));
+        const int result = send(socket, data.data() + sent, chunk, SEND_FLAGS);
+        if (result <= 0) {
+            return false;
+        }
+        sent += static_cast<std::size_t>(result);
+    }
+    return true;
+}
+
+HttpResponse HttpResponse::error(const int status, const std::string& message) {
+    std::string escaped;
+    for (const char c : message) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+        }
+        escaped += c;
+    }
+    return json(status, "{\"error\":\"" + escaped + "\"}");
+}
+
+HttpResponse HttpResponse::eventStream(std::function<void(HttpStream&)> stream) {
+    return HttpResponse{ 200, "text/event-stream", "", std::move(stream) };
+}
+
+bool HttpStream::write(const std::string& data) {
+    if (is_open_ && !sendAll(toSocket(socket_), data)) {
+        is_open_ = false;
+    }
+    return is_open_;
+}
+
+HttpServer::HttpServer(const unsigned short port, Handler handler, const std::size_t max_connections, std::string bind_address)
+    : port_(port), handler_(std::move(handler)), max_connections_(max_connections), bind_address_(std::move(bind_address)) {
+}
+
+HttpServer::~HttpServer() {
+    stop();
+}
+
+bool HttpServer::start() {
+#ifdef _WIN32
+    WSADATA wsa_data;
+    if (WSAStartup(MAKEWORD(2, 2), &wsa_data) != 0) {
+        std::cerr << "WSAStartup failed.\n";
+        return false;
+    }
+#endif
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port_);
+    if (inet_pton(AF_INET, bind_address_.c_str(), &address.sin_addr) != 1) {
+        std::cerr << "Invalid HTTP bind address: " << bind_address_ << '\n';
+        return false;
+    }
+
+    const SocketHandle listener = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (listener == NO_SOCKET) {
+        std::cerr << "Failed to create HTTP listening socket.\n";
+        return false;
+    }
+
+    const int reuse = 1;
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+
+    if (bind(listener, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 || listen(listener, SOMAXCONN) != 0) {
+        std::cerr << "Failed to listen for HTTP on " << bind_address_ << ':' << port_ << ".\n";
+        closeSocket(listener);
+        return false;
+    }
+
+    listen_socket_ = static_cast<std::intptr_t>(listener);
+    is_running_ = true;
+    acceptor_ = std::thread(&HttpServer::acceptLoop, this);
+    return true;
+}
+
+void HttpServer::stop() {
+    if (!is_running_.exchange(false)) {
+        return;
+    }
+
+    shutdownSocket(toSocket(listen_socket_));
+    closeSocket(toSocket(listen_socket_));
+    if (acceptor_.joinable()) {
+        acceptor_.join();
+    }
+
+    std::unique_lock<std::mutex> lock(connections_mutex_);
+    for (const std::intptr_t client : open_clients_) {
+        shutdownSocket(toSocket(client));
+    }
+    connections_done_.wait(lock, [this] { return active_connections_ == 0; });
+    lock.unlock();
+
+#ifdef _WIN32
+    WSACleanup();
+#endif
+}
+
+// A failing accept (e.g. out of file descriptors) is retried with a growing pause instead of spinning.
+void HttpServer::acceptLoop() {
+    std::chrono::milliseconds backoff{ 0 };
+    while (is_running_) {
+        const SocketHandle client = accept(toSocket(listen_socket_), nullptr, nullptr);
+        if (client == NO_SOCKET) {
+            if (!is_running_) {
+                break;
+            }
+            backoff = std::min<std::chrono::milliseconds>(std::max<std::chrono::milliseconds>(backoff * 2, MIN_ACCEPT_BACKOFF), MAX_ACCEPT_BACKOFF);
+            std::cerr << "Failed to accept an HTTP connection; retrying in " << backoff.count() << " ms.\n";
+            std::this_thread::sleep_for(backoff);
+            continue;
+        }
+        backoff = std::chrono::milliseconds(0);
+
+        const int no_delay = 1;
+        setsockopt(client, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&no_delay), sizeof(no_delay));
+
+        {
+            std::lock_guard<std::mutex> lock(connections_mutex_);
+            if (active_connections_ >= max_connections_ || !is_running_) {
+                sendAll(client, serialize(HttpResponse::error(503, "Too many connections."), false));
+                closeSocket(client);
+                continue;
+            }
+            ++active_connections_;
+            open_clients_.insert(static_cast<std::intptr_t>(client));
+        }
+
+        std::thread(&HttpServer::serveConnection, this, static_cast<std::intptr_t>(client)).detach();
+    }
+}
+
+void HttpServer::serveConnection(const std::intptr_t handle) {
+    const SocketHandle client = toSocket(handle);
+
+#ifdef _WIN32
+    const DWORD timeout = IDLE_TIMEOUT_SECONDS * 1000;
+#else
+    timeval timeout{};
+    timeout.tv_sec = IDLE_TIMEOUT_SECONDS;
+#endif
+    setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char*>(&timeout), sizeof(timeout));
+
+    std::string buffer;
+    std::vector<char> chunk(8192);
+    bool is_keep_alive = true;
+
+    while (is_keep_alive && is_running_) {
+        std::size_t head_end = buffer.find("\r\n\r\n");
+        while (head_end == std::string::npos && buffer.size() < MAX_REQUEST_BYTES) {
+            const int received = recv(client, chunk.data(), static_cast<int>(chunk.size()), 0);
+            if (received <= 0) {
+                is_keep_alive = false;
+                break;
+            }
+            buffer.append(chunk.data(), static_cast<std::size_t>(received));
+            head_end = buffer.find("\r\n\r\n");
+        }
+        if (head_end == std::string::npos) {
+            if (is_keep_alive) {
+                sendAll(client, serialize(HttpResponse::error(431, "Request too large."), false));
+            }
+            break;
+        }
+
+        HttpRequest request;
+        if (!parseRequest(buffer.substr(0, head_end), request)) {
+            sendAll(client, serialize(HttpResponse::error(400, "Malformed request."), false));
+            break;
+        }
+
+        const std::size_t content_length = request.content_length;
+        if (content_length > MAX_REQUEST_BYTES) {
+            sendAll(client, serialize(HttpResponse::error(413, "Body too large."), false));
+            break;
+        }
+
+        const std::size_t body_start = head_end + 4;
+        while (buffer.size() < body_start + content_length) {
+            const int received = recv(client, chunk.data(), static_cast<int>(chunk.size()), 0);
+            if (received <= 0) {
+                is_keep_alive = false;
+                break;
+            }
+            buffer.append(chunk.data(), static_cast<std::size_t>(received));
+        }
+        if (buffer.size() < body_start + content_length) {
+            break;
+        }
+        request.body = buffer.substr(body_start, content_length);
+        buffer.erase(0, body_start + content_length);
+
+        const auto connection_header = request.headers.find("connection");
+        if (connection_header != request.headers.end() && connection_header->second == "close") {
+            is_keep_alive = false;
+        }
+
+        HttpResponse response;
+        try {
+            response = handler_(request);
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Exception handling " << request.method << ' ' << request.path << ": " << e.what() << '\n';
+            response = HttpResponse::error(500, "Internal server error.");
+        }
+        requests_.fetch_add(1, std::memory_order_relaxed);
+
+        if (response.stream) {
+            if (sendAll(client, streamHeader(response))) {
+                HttpStream stream(handle, is_running_);
+                try {
+                    response.stream(stream);
+                }
+                catch (const std::exception& e) {
+                    std::cerr << "Exception in stream " << request.path << ": " << e.what() << '\n';
+                }
+            }
+            break;
+        }
+
+        if (!sendAll(client, serialize(response, is_keep_alive))) {
+            break;
+        }
+    }
+
+    closeSocket(client);
+
+    std::lock_guard<std::mutex> lock(connections_mutex_);
+    open_clients_.erase(handle);
+    --active_connections_;
+    connections_done_.notify_all();
+}
+
+bool HttpServer::parseRequest(const std::string& head, HttpRequest& request) {
+    std::istringstream lines(head);
+    std::string request_line;
+    if (!std::getline(lines, request_line)) {
+        return false;
+    }
+    if (!request_line.empty() && request_line.back() == '\r') {
+        request_line.pop_back();
+    }
+
+    std::istringstream request_parts(request_line);
+    std::string target;
+    std::string version;
+    if (!(request_parts >> request.method >> target >> version)) {
+        return false;
+    }
+
+    const std::size_t query_start = target.find('?');
+    request.path = urlDecode(target.substr(0, query_start));
+    if (query_start != std::string::npos) {
+        std::istringstream query(target.substr(query_start + 1));
+        std::string pair;
+        while (std::getline(query, pair, '&')) {
+            const std::size_t equals = pair.find('=');
+            request.query[urlDecode(pair.substr(0, equals))] = equals == std::string::npos ? "" : urlDecode(pair.substr(equals + 1));
+        }
+    }
+
+    std::string header;
+    while (std::getline(lines, header)) {
+        if (!header.empty() && header.back() == '\r') {
+            header.pop_back();
+        }
+        const std::size_t colon = header.find(':');
+        if (colon == std::string::npos) {
+            continue;
+        }
+        std::string name = header.substr(0, colon);
+        for (char& c : name) {
+            c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        }
+        const std::size_t value_start = header.find_first_not_of(' ', colon + 1);
+        request.headers[name] = value_start == std::string::npos ? "" : header.substr(value_start);
+    }
+
+    if (version == "HTTP/1.0" && request.headers["connection"] != "keep-alive") {
+        request.headers["connection"] = "close";
+    }
+
+    const auto length_header = request.headers.find("content-length");
+    if (length_header != request.headers.end()) {
+        try {
+            request.content_length = std::stoul(length_header->second);
+        }
+        catch (const std::exception&) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string HttpServer::serialize(const HttpResponse& response, const bool is_keep_alive) {
+    std::string out;
+    out.reserve(response.body.size() + 160);
+    out += "HTTP/1.1 " + std::to_string(response.status) + ' ' + reasonPhrase(response.status) + "\r\n";
+    out += "Content-Type: " + response.content_type + "\r\n";
+    out += "Content-Length: " + std::to_string(response.body.size()) + "\r\n";
+    out += "Cache-Control: no-store\r\n";
+    out += is_keep_alive ? "Connection: keep-alive\r\n\r\n" : "Connection: close\r\n\r\n";
+    out += response.body;
+    return out;
+}
+
+std::string HttpServer::streamHeader(const HttpResponse& response) {
+    return "HTTP/1.1 " + std::to_string(response.status) + ' ' + reasonPhrase(response.status) + "\r\n"
+        "Content-Type: " + response.content_type + "\r\n"
+        "Cache-Control: no-store\r\n"
+        "X-Accel-Buffering: no\r\n"
+        "Connection: close\r\n\r\n";
+}
+
+const char* HttpServer::reasonPhrase(const int status) {
+    switch (status) {
+    case 200: return "OK";
+    case 201: return "Created";
+    case 400: return "Bad Request";
+    case 404: return "Not Found";
+    case 405: return "Method Not Allowed";
+    case 409: return "Conflict";
+    case 413: return "Payload Too Large";
+    case 431: return "Request Header Fields Too Large";
+    case 500: return "Internal Server Error";
+    case 503: return "Service Unavailable";
+    default: return "Unknown";
+    }
+}
+
+std::string HttpServer::urlDecode(const std::string& value) {
+    std::string decoded;
+    decoded.reserve(value.size());
+    for (std::size_t i = 0; i < value.size(); ++i) {
+        if (value[i] == '+') {
+            decoded += ' ';
+        }
+        else if (value[i] == '%' && i + 2 < value.size() &&
+            std::isxdigit(static_cast<unsigned char>(value[i + 1])) && std::isxdigit(static_cast<unsigned char>(value[i + 2]))) {
+            decoded += static_cast<char>(std::stoi(value.substr(i + 1, 2), nullptr, 16));
+            i += 2;
+        }
+        else {
+            decoded += value[i];
+        }
+    }
+    return decoded;
+}
@@ -0,0 +1,59 @@
+#include "KeysetPager.hpp"
+#include "DatabaseConnection.hpp"
+#include <iostream>
+
+KeysetPager::KeysetPager(std::string select, std::string key_column, std::string filter, const int page_size)
+    : page_size_(page_size) {
+    query_ = std::move(select) + " WHERE ";
+    if (!filter.empty()) {
+        query_ += "(" + filter + ") AND ";
+    }
+    query_ += key_column + " > $1 ORDER BY " + key_column + " ASC LIMIT $2";
+}
+
+pqxx::result KeysetPager::fetch(pqxx::transaction_base& txn, const long long after) const {
+    return txn.exec_params(query_, after, page_size_);
+}
+
+std::size_t KeysetPager::run(const RenderPage& render, const WantsMore& wants_more) const {
+    std::size_t shown = 0;
+    long long after = 0;
+
+    while (true) {
+        pqxx::result page;
+        try {
+            ConnectionLease lease = DatabaseConnection::getInstance().acquire();
+            pqxx::nontransaction nt(*lease);
+            page = fetch(nt, after);
+        }
+        catch (const pqxx::sql_error& e) {
+            std::cerr << "SQL error: " << e.what() << " Query: " << e.query() << '\n';
+            break;
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Exception while paging: " << e.what() << '\n';
+            break;
+        }
+
+        if (page.empty()) {
+            break;
+        }
+        render(page);
+        shown += page.size();
+
+        if (page.size() < static_cast<std::size_t>(page_size_)) {
+            break;
+        }
+        after = page[page.size() - 1][0].as<long long>();
+        if (!wants_more()) {
+            break;
+        }
+    }
+    return shown;
+}
+
+bool KeysetPager::promptForMore() {
+    std::cout << "-- Press Enter for the next page, or q to stop --";
+    std::string line;
+    return std::getline(std::cin, line) && line != "q" && line != "Q";
+}
@@ -0,0 +1,247 @@
+#include "LiveScoreCache.hpp"
+#include "DatabaseConnection.hpp"
+#include "PointLog.hpp"
+#include "ReferenceData.hpp"
+#include <iostream>
+#include <thread>
+
+LiveScoreCache& LiveScoreCache::getInstance() {
+    static LiveScoreCache instance;
+    return instance;
+}
+
+LiveScoreCache::LiveScoreCache() : slots_(std::make_unique<Slot[]>(CAPACITY)) {
+}
+
+std::size_t LiveScoreCache::home(const int match_id) {
+    return static_cast<std::size_t>((static_cast<std::uint64_t>(static_cast<std::uint32_t>(match_id)) * 0x9E3779B97F4A7C15ULL) >> 32) & (CAPACITY - 1);
+}
+
+// Linear probing; slots are never emptied again once claimed, only handed to another match, so an empty slot ends
+// the search.
+LiveScoreCache::Slot* LiveScoreCache::find(const int match_id) const {
+    if (match_id <= 0) {
+        return nullptr;
+    }
+    for (std::size_t i = 0, index = home(match_id); i < CAPACITY; ++i, index = (index + 1) & (CAPACITY - 1)) {
+        Slot& slot = slots_[index];
+        const int id = slot.match_id.load(std::memory_order_acquire);
+        if (id == match_id) {
+            return &slot;
+        }
+        if (id == 0) {
+            return nullptr;
+        }
+    }
+    return nullptr;
+}
+
+// Takes the match's existing slot, else the first empty one on its probe path, else the first one on the path
+// that holds a finished match. The slot is published with its players, score and status in one seqlock write.
+LiveScoreCache::Slot* LiveScoreCache::claim(const LiveMatch& match) {
+    const int finished_status_id = ReferenceData::getInstance().getStatusId("Finished");
+    std::lock_guard<std::mutex> guard(claim_mutex_);
+    Slot* target = nullptr;
+    Slot* reusable = nullptr;
+    for (std::size_t i = 0, index = home(match.match_id); i < CAPACITY; ++i, index = (index + 1) & (CAPACITY - 1)) {
+        Slot& slot = slots_[index];
+        const int id = slot.match_id.load(std::memory_order_acquire);
+        if (id == match.match_id) {
+            return &slot;
+        }
+        if (id == 0) {
+            target = &slot;
+            break;
+        }
+        if (!reusable && slot.status_id.load(std::memory_order_relaxed) == finished_status_id) {
+            reusable = &slot;
+        }
+    }
+    if (!target) {
+        target = reusable;
+    }
+    if (!target) {
+        return nullptr;
+    }
+
+    auto players = std::make_shared<Players>();
+    players->match_id = match.match_id;
+    players->player_id1 = match.player_id1;
+    players->player_id2 = match.player_id2;
+    players->player1_name = match.player1_name;
+    players->player2_name = match.player2_name;
+
+    const std::uint32_t seq = lock(*target);
+    const bool is_new = target->match_id.load(std::memory_order_relaxed) == 0;
+    target->match_id.store(match.match_id, std::memory_order_relaxed);
+    std::atomic_store(&target->players, std::shared_ptr<const Players>(std::move(players)));
+    target->score.store(match.score.getBits(), std::memory_order_relaxed);
+    target->status_id.store(match.status_id, std::memory_order_relaxed);
+    target->seq.store(seq + 2, std::memory_order_release);
+    if (is_new) {
+        size_.fetch_add(1, std::memory_order_relaxed);
+    }
+    return target;
+}
+
+bool LiveScoreCache::upsert(const LiveMatch& match) {
+    if (match.match_id <= 0) {
+        return false;
+    }
+    Slot* slot = find(match.match_id);
+    if (slot && write(*slot, match.match_id, match.score.getBits(), match.status_id)) {
+        return true;
+    }
+    slot = claim(match);
+    if (!slot) {
+        std::cerr << "Live score cache is full of unfinished matches; match " << match.match_id << " is not cached.\n";
+        return false;
+    }
+    write(*slot, match.match_id, match.score.getBits(), match.status_id);
+    return true;
+}
+
+bool LiveScoreCache::update(const int match_id, const CompactScore& score, const int status_id) {
+    Slot* slot = find(match_id);
+    return slot && write(*slot, match_id, score.getBits(), status_id);
+}
+
+bool LiveScoreCache::setStatus(const int match_id, const int status_id) {
+    Slot* slot = find(match_id);
+    return slot && write(*slot, match_id, std::nullopt, status_id);
+}
+
+std::optional<LiveMatch> LiveScoreCache::get(const int match_id) const {
+    const Slot* slot = find(match_id);
+    LiveMatch match;
+    if (!slot || !read(*slot, match_id, match)) {
+        return std::nullopt;
+    }
+    return match;
+}
+
+std::vector<LiveMatch> LiveScoreCache::getAll() const {
+    std::vector<LiveMatch> matches;
+    matches.reserve(size());
+    for (std::size_t i = 0; i < CAPACITY; ++i) {
+        const Slot& slot = slots_[i];
+        LiveMatch match;
+        if (read(slot, 0, match)) {
+            matches.push_back(std::move(match));
+        }
+    }
+    return matches;
+}
+
+// Writers take the slot by making seq odd; readers retry if seq was odd or moved while they copied the fields.
+std::uint32_t LiveScoreCache::lock(Slot& slot) {
+    std::uint32_t seq = slot.seq.load(std::memory_order_relaxed);
+    do {
+        while (seq & 1) {
+            std::this_thread::yield();
+            seq = slot.seq.load(std::memory_order_relaxed);
+        }
+    } while (!slot.seq.compare_exchange_weak(seq, seq + 1, std::memory_order_acquire, std::memory_order_relaxed));
+    std::atomic_thread_fence(std::memory_order_release);
+    return seq;
+}
+
+// Returns false without writing if the slot has since been handed to another match.
+bool LiveScoreCache::write(Slot& slot, const int match_id, const std::optional<std::uint64_t> score, const int status_id) {
+    const std::uint32_t seq = lock(slot);
+    const bool is_owner = slot.match_id.load(std::memory_order_relaxed) == match_id;
+    if (is_owner) {
+        if (score) {
+            slot.score.store(*score, std::memory_order_relaxed);
+        }
+        if (status_id != 0) {
+            slot.status_id.store(status_id, std::memory_order_relaxed);
+        }
+    }
+    slot.seq.store(seq + 2, std::memory_order_release);
+    return is_owner;
+}
+
+// A match_id of 0 accepts whichever match the slot holds.
+bool LiveScoreCache::read(const Slot& slot, const int match_id, LiveMatch& match) {
+    int id = 0;
+    std::uint64_t score = 0;
+    int status_id = 0;
+    while (true) {
+        const std::uint32_t before = slot.seq.load(std::memory_order_acquire);
+        if (before & 1) {
+            std::this_thread::yield();
+            continue;
+        }
+        id = slot.match_id.load(std::memory_order_relaxed);
+        score = slot.score.load(std::memory_order_relaxed);
+        status_id = slot.status_id.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.seq.load(std::memory_order_relaxed) == before) {
+            break;
+        }
+    }
+    if (id == 0 || status_id == 0 || (match_id != 0 && id != match_id)) {
+        return false;
+    }
+
+    const std::shared_ptr<const Players> players = std::atomic_load(&slot.players);
+    if (!players || players->match_id != id) {
+        return false;
+    }
+    match.match_id = id;
+    match.status_id = status_id;
+    match.player_id1 = players->player_id1;
+    match.player_id2 = players->player_id2;
+    match.player1_name = players->player1_name;
+    match.player2_name = players->player2_name;
+    match.score = CompactScore::fromBits(score);
+    return true;
+}
+
+bool LiveScoreCache::warm() {
+    const int started_status_id = ReferenceData::getInstance().getStatusId("Started");
+    const int suspended_status_id = ReferenceData::getInstance().getStatusId("Suspended");
+    std::vector<std::pair<LiveMatch, int>> matches;
+
+    try {
+        ConnectionLease lease = DatabaseConnection::getInstance().acquire();
+        pqxx::nontransaction nt(*lease);
+        const pqxx::result r = nt.exec(
+            "SELECT m.id, m.status_id, m.no_sets, m.player_id1, m.player_id2, "
+            "p1.first_name || ' ' || p1.last_name AS player1_name, p2.first_name || ' ' || p2.last_name AS player2_name "
+            "FROM public.matches m "
+            "JOIN public.players p1 ON m.player_id1 = p1.id "
+            "JOIN public.players p2 ON m.player_id2 = p2.id "
+            "WHERE m.status_id IN (" + nt.quote(started_status_id) + ", " + nt.quote(suspended_status_id) + ");");
+
+        matches.reserve(r.size());
+        for (const auto& row : r) {
+            LiveMatch match;
+            match.match_id = row["id"].as<int>();
+            match.status_id = row["status_id"].as<int>();
+            match.player_id1 = row["player_id1"].as<int>();
+            match.player_id2 = row["player_id2"].as<int>();
+            match.player1_name = row["player1_name"].as<std::string>();
+            match.player2_name = row["player2_name"].as<std::string>();
+            matches.emplace_back(std::move(match), row["no_sets"].as<int>());
+        }
+    }
+    catch (const pqxx::sql_error& e) {
+        std::cerr << "SQL error while warming live score cache: " << e.what() << '\n';
+        std::cerr << "Query was: " << e.query() << '\n';
+        return false;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Exception while warming live score cache: " << e.what() << '\n';
+        return false;
+    }
+
+    const std::unordered_map<int, CompactScore> scores = PointLog::replayAll();
+    for (auto& [match, no_sets] : matches) {
+        const auto replayed = scores.find(match.match_id);
+        match.score = replayed != scores.end() ? replayed->second : CompactScore::start(no_sets, true);
+        upsert(match);
+    }
+    return true;
+}
@@ -0,0 +1,379 @@
+#include "LoadGenerator.hpp"
+#include "DatabaseConnection.hpp"
+#include "Match.hpp"
+#include "ReferenceData.hpp"
+#include "ScoringEngine.hpp"
+#include "SqlArray.hpp"
+#include "UnitOfWork.hpp"
+#include <algorithm>
+#include <atomic>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <streambuf>
+#include <thread>
+
+// The console path reports every point on std::cout; while matches are played the text is formatted and dropped.
+class DiscardBuffer : public std::streambuf {
+protected:
+    int overflow(const int c) override { return traits_type::not_eof(c); }
+    std::streamsize xsputn(const char*, const std::streamsize count) override { return count; }
+};
+
+// Backends publish their transaction counts to pg_stat_database about once a second while idle.
+static constexpr std::chrono::milliseconds STATS_SETTLE_TIME{ 1500 };
+
+LoadTestReport LoadGenerator::run(const LoadTestParams& params) {
+    LoadTestReport report;
+    report.matches_planned = params.matches;
+
+    const std::vector<PlannedMatch> planned = createMatches(params);
+    if (planned.empty()) {
+        return report;
+    }
+
+    PersistenceQueue& queue = PersistenceQueue::getInstance();
+    queue.flush();
+    std::this_thread::sleep_for(STATS_SETTLE_TIME);
+    const ServerCounters server_before = readServerCounters();
+    const QueueMetrics queue_before = queue.getMetrics();
+    const PoolMetrics pool_before = DatabaseConnection::getInstance().getPool().getMetrics();
+    const std::uint64_t round_trips_before = QueryMetrics::getInstance().getRoundTrips();
+
+    const double serve_win = std::clamp(params.serve_win, 0.0, 1.0);
+    const std::uint64_t server_threshold = serve_win >= 1.0
+        ? std::numeric_limits<std::uint64_t>::max() : static_cast<std::uint64_t>(serve_win * 18446744073709551616.0);
+    const auto started_at = std::chrono::steady_clock::now();
+    const std::uint64_t seed = params.seed != 0 ? params.seed : static_cast<std::uint64_t>(started_at.time_since_epoch().count());
+
+    report.threads = static_cast<unsigned>(std::min<std::size_t>(std::max(1u, params.concurrency), planned.size()));
+    std::vector<WorkerTally> tallies(report.threads);
+    std::atomic<std::size_t> next_match{ 0 };
+
+    DiscardBuffer discard;
+    std::streambuf* const console = std::cout.rdbuf(&discard);
+    std::vector<std::thread> workers;
+    workers.reserve(report.threads);
+    for (unsigned i = 0; i < report.threads; ++i) {
+        workers.emplace_back([&, i]() {
+            WorkerTally& tally = tallies[i];
+            std::uint64_t worker_seed = seed + i * 0xD1B54A32D192ED03ULL;
+            for (std::size_t index = next_match++; index < planned.size(); index = next_match++) {
+                try {
+                    if (playMatch(planned[index], server_threshold, worker_seed, tally)) {
+                        tally.matches_played++;
+                    }
+                }
+                catch (const std::exception& e) {
+                    std::cerr << "Exception while playing match " << planned[index].match_id << ": " << e.what() << '\n';
+                }
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    const auto scored_at = std::chrono::steady_clock::now();
+    std::cout.rdbuf(console);
+
+    if (!queue.flush()) {
+        std::cerr << "Some load test writes could not be saved to the database.\n";
+    }
+    const auto finished_at = std::chrono::steady_clock::now();
+
+    std::vector<long long> latencies;
+    for (auto& tally : tallies) {
+        report.matches_played += tally.matches_played;
+        report.score_mismatches += tally.score_mismatches;
+        report.tiebreak_points += tally.tiebreak_points;
+        latencies.insert(latencies.end(), tally.latencies.begin(), tally.latencies.end());
+        std::vector<long long>().swap(tally.latencies);
+    }
+    report.points = latencies.size();
+    report.latency = summarize(latencies);
+    report.scoring_elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(scored_at - started_at);
+    report.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(finished_at - started_at);
+
+    const QueueMetrics queue_after = queue.getMetrics();
+    report.queue = queue_after;
+    report.queue.enqueued = queue_after.enqueued - queue_before.enqueued;
+    report.queue.coalesced = queue_after.coalesced - queue_before.coalesced;
+    report.queue.statements = queue_after.statements - queue_before.statements;
+    report.queue.batches = queue_after.batches - queue_before.batches;
+    report.queue.failed_batches = queue_after.failed_batches - queue_before.failed_batches;
+
+    const PoolMetrics pool_after = DatabaseConnection::getInstance().getPool().getMetrics();
+    report.blocked_checkouts = pool_after.blocked_checkouts - pool_before.blocked_checkouts;
+    report.max_checkout_wait = pool_after.max_wait;
+
+    report.client_round_trips = QueryMetrics::getInstance().getRoundTrips() - round_trips_before;
+    report.top_statements = QueryMetrics::getInstance().getStatementSummaries();
+    std::sort(report.top_statements.begin(), report.top_statements.end(),
+        [](const StatementSummary& a, const StatementSummary& b) { return a.total > b.total; });
+    if (report.top_statements.size() > TOP_STATEMENTS) {
+        report.top_statements.resize(TOP_STATEMENTS);
+    }
+
+    std::this_thread::sleep_for(STATS_SETTLE_TIME);
+    const ServerCounters server_after = readServerCounters();
+    if (server_before.commits && server_after.commits) {
+        report.commits = *server_after.commits - *server_before.commits;
+        report.rollbacks = *server_after.rollbacks - *server_before.rollbacks;
+    }
+    if (server_before.statements && server_after.statements) {
+        report.statements = *server_after.statements - *server_before.statements;
+    }
+
+    if (!params.is_keeping_data) {
+        removeMatches(planned);
+    }
+    return report;
+}
+
+// Players and matches in one statement: each match pairs two consecutive new players, so matches never share a row.
+std::vector<LoadGenerator::PlannedMatch> LoadGenerator::createMatches(const LoadTestParams& params) {
+    std::vector<PlannedMatch> planned;
+    if (params.matches == 0) {
+        return planned;
+    }
+
+    try {
+        const int pending_status_id = ReferenceData::getInstance().getStatusId("Pending");
+        ConnectionLease lease = DatabaseConnection::getInstance().acquire();
+        pqxx::work txn(*lease);
+        const pqxx::result r = txn.exec_params(R"(
+            WITH new_players AS (
+                INSERT INTO public.players (first_name, last_name)
+                SELECT 'Load', 'Test ' || g FROM generate_series(1, $1::int * 2) AS g
+                RETURNING id
+            ), numbered AS (
+                SELECT id, row_number() OVER (ORDER BY id) - 1 AS n FROM new_players
+            )
+            INSERT INTO public.matches (status_id, player_id1, player_id2, predicted_start_time, duration, no_sets)
+            SELECT $2, p1.id, p2.id, now(), interval '0 minutes', $3
+            FROM numbered p1
+            JOIN numbered p2 ON p2.n = p1.n + 1
+            WHERE p1.n % 2 = 0
+            ORDER BY p1.n
+            RETURNING id, player_id1, player_id2;
+        )", static_cast<int>(params.matches), pending_status_id, params.no_sets);
+        txn.commit();
+
+        planned.reserve(r.size());
+        for (const auto& row : r) {
+            planned.push_back(PlannedMatch{ row[0].as<int>(), row[1].as<int>(), row[2].as<int>() });
+        }
+    }
+    catch (const pqxx::sql_error& e) {
+        std::cerr << "SQL error while creating load test matches: " << e.what() << '\n';
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Exception while creating load test matches: " << e.what() << '\n';
+    }
+    return planned;
+}
+
+void LoadGenerator::removeMatches(const std::vector<PlannedMatch>& matches) {
+    std::vector<int> match_ids;
+    std::vector<int> player_ids;
+    match_ids.reserve(matches.size());
+    player_ids.reserve(matches.size() * 2);
+    for (const auto& planned : matches) {
+        match_ids.push_back(planned.match_id);
+        player_ids.push_back(planned.player_id1);
+        player_ids.push_back(planned.player_id2);
+    }
+
+    try {
+        ConnectionLease lease = DatabaseConnection::getInstance().acquire();
+        pqxx::work txn(*lease);
+        const std::string ids = toSqlArray(match_ids);
+        for (const char* table : { "point_events", "game_points", "tie_breaks", "matches_sets" }) {
+            txn.exec_params(std::string("DELETE FROM public.") + table + " WHERE match_id = ANY($1::int[]);", ids);
+        }
+        txn.exec_params("DELETE FROM public.matches WHERE id = ANY($1::int[]);", ids);
+        txn.exec_params("DELETE FROM public.players WHERE id = ANY($1::int[]);", toSqlArray(player_ids));
+        txn.commit();
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Exception while removing load test matches: " << e.what() << '\n';
+    }
+}
+
+// Same calls as UIManager::startMatch. The points are also scored by ScoringEngine, which tells who is serving
+// (the server wins a point with the configured chance) and must end with the same result as the objects.
+bool LoadGenerator::playMatch(const PlannedMatch& planned, const std::uint64_t server_threshold, std::uint64_t& seed,
+    WorkerTally& tally) {
+    std::optional<Match> optional_match = Match::getMatchById(planned.match_id, { "Pending" });
+    if (!optional_match) {
+        return false;
+    }
+    Match& match = *optional_match;
+    match.startMatch(planned.match_id);
+    if (!match.getCurrentSet() || !match.getCurrentSet()->getCurrentGame()) {
+        return false;
+    }
+
+    MatchScore expected;
+    expected.no_sets = match.getNoSets();
+    expected.is_player_one_serving = match.getCurrentSet()->getCurrentGame()->getIsPlayerOneServing();
+    const auto nextPoint = [&]() {
+        const bool is_server_winning = nextRandom(seed) < server_threshold;
+        const int player = is_server_winning == expected.is_player_one_serving ? 1 : 2;
+        ScoringEngine::scorePoint(expected, player);
+        return player;
+    };
+
+    // A tiebreak is played inside Set::addGameResult; each request for its next point ends the previous point.
+    auto point_started_at = std::chrono::steady_clock::now();
+    const Set::TiebreakInput tiebreak_input = [&]() {
+        const auto now = std::chrono::steady_clock::now();
+        tally.latencies.push_back((now - point_started_at).count());
+        tally.tiebreak_points++;
+        const int player = nextPoint();
+        point_started_at = std::chrono::steady_clock::now();
+        return player;
+    };
+
+    while (!match.isMatchWinner()) {
+        const int player = nextPoint();
+        point_started_at = std::chrono::steady_clock::now();
+        match.getCurrentSet()->getCurrentGame()->addPoint(player, planned.match_id, match.getCurrentSet()->getSetNum());
+        if (completeGame(match, tiebreak_input) < 0) {
+            return false;
+        }
+        tally.latencies.push_back((std::chrono::steady_clock::now() - point_started_at).count());
+    }
+
+    if (!expected.isFinished() || match.getSetsPlayerOne() != expected.sets_player1 || match.getSetsPlayerTwo() != expected.sets_player2) {
+        tally.score_mismatches++;
+    }
+    return true;
+}
+
+// The same steps as UIManager::processGameEnd and updateMatchStatus, with tiebreak points drawn from tiebreak_input.
+int LoadGenerator::completeGame(Match& match, const std::function<int()>& tiebreak_input) {
+    const int game_winner = match.getCurrentSet()->getCurrentGame()->determineWinner();
+    if (game_winner == 0) {
+        return 0;
+    }
+
+    UnitOfWork uow(match.getId());
+    const int game_status = match.recordGame(game_winner, uow, tiebreak_input);
+    uow.commit();
+    match.endIfWon();
+    return game_status == 0 || game_status == 1 || game_status == 2 ? game_status : -1;
+}
+
+LoadGenerator::ServerCounters LoadGenerator::readServerCounters() {
+    ServerCounters counters;
+    try {
+        ConnectionLease lease = DatabaseConnection::getInstance().acquire();
+        pqxx::nontransaction nt(*lease);
+        const pqxx::result r = nt.exec(
+            "SELECT xact_commit, xact_rollback FROM pg_stat_database WHERE datname = current_database();");
+        if (!r.empty()) {
+            counters.commits = r[0][0].as<long long>();
+            counters.rollbacks = r[0][1].as<long long>();
+        }
+
+        try {
+            counters.statements = nt.exec(
+                "SELECT coalesce(sum(calls), 0)::bigint FROM pg_stat_statements "
+                "WHERE dbid = (SELECT oid FROM pg_database WHERE datname = current_database());")[0][0].as<long long>();
+        }
+        catch (const pqxx::sql_error&) {
+            // pg_stat_statements is not installed; round trips are reported as unavailable.
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Exception while reading database statistics: " << e.what() << '\n';
+    }
+    return counters;
+}
+
+LatencySummary LoadGenerator::summarize(std::vector<long long>& latencies) {
+    LatencySummary summary;
+    if (latencies.empty()) {
+        return summary;
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    const auto at = [&latencies](const double quantile) {
+        const std::size_t index = static_cast<std::size_t>(quantile * static_cast<double>(latencies.size() - 1));
+        return std::chrono::nanoseconds(latencies[index]);
+    };
+    summary.p50 = at(0.50);
+    summary.p90 = at(0.90);
+    summary.p99 = at(0.99);
+    summary.p999 = at(0.999);
+    summary.max = std::chrono::nanoseconds(latencies.back());
+    return summary;
+}
+
+void LoadGenerator::printReport(const LoadTestReport& report) {
+    const auto per_point = [&report](const long long count) {
+        return report.points == 0 ? 0.0 : static_cast<double>(count) / static_cast<double>(report.points);
+    };
+    const auto per_second = [&report](const std::chrono::milliseconds elapsed) {
+        return elapsed.count() == 0 ? 0.0 : static_cast<double>(report.points) * 1000.0 / static_cast<double>(elapsed.count());
+    };
+    const auto micros = [](const std::chrono::nanoseconds latency) { return static_cast<double>(latency.count()) / 1000.0; };
+
+    const std::ios::fmtflags flags = std::cout.flags();
+    const std::streamsize precision = std::cout.precision();
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "Played " << report.matches_played << " of " << report.matches_planned << " matches on " << report.threads
+        << " threads in " << report.elapsed.count() << " ms";
+    if (report.score_mismatches > 0) {
+        std::cout << "; " << report.score_mismatches << " ended with a score that disagrees with ScoringEngine";
+    }
+    std::cout << ".\n";
+    std::cout << "Points: " << report.points << " (" << report.tiebreak_points << " in tiebreaks), "
+        << per_second(report.scoring_elapsed) << " points/s while scoring, "
+        << per_second(report.elapsed) << " points/s including the final flush.\n";
+    std::cout << "Point latency (us): p50 " << micros(report.latency.p50) << ", p90 " << micros(report.latency.p90)
+        << ", p99 " << micros(report.latency.p99) << ", p99.9 " << micros(report.latency.p999)
+        << ", max " << micros(report.latency.max) << '\n';
+
+    std::cout << std::setprecision(3);
+    if (report.commits) {
+        std::cout << "Commits: " << *report.commits << " (" << per_point(*report.commits) << " per point), "
+            << *report.rollbacks << " rollbacks.\n";
+    }
+    else {
+        std::cout << "Commits: unavailable.\n";
+    }
+    if (report.statements) {
+        std::cout << "Round trips: " << *report.statements << " statements (" << per_point(*report.statements) << " per point).\n";
+    }
+    else {
+        std::cout << "Round trips: unavailable, install the pg_stat_statements extension to count them.\n";
+    }
+    if (QueryMetrics::isEnabled()) {
+        std::cout << "Client round trips: " << report.client_round_trips << " (" << per_point(static_cast<long long>(report.client_round_trips))
+            << " per point).\n";
+        for (const auto& statement : report.top_statements) {
+            std::cout << "  " << statement.name << ": " << statement.count << " calls, " << statement.total.count() / 1000 << " ms total, p50 "
+                << statement.p50.count() << " us, p99 " << statement.p99.count() << " us";
+            if (statement.errors > 0) {
+                std::cout << ", " << statement.errors << " errors";
+            }
+            std::cout << '\n';
+        }
+    }
+    std::cout << "Persistence queue: " << report.queue.enqueued << " writes, " << report.queue.coalesced << " coalesced, "
+        << report.queue.statements << " statements in " << report.queue.batches << " batches ("
+        << report.queue.failed_batches << " failed), max depth " << report.queue.max_depth << ".\n";
+    std::cout << "Connection pool: " << report.blocked_checkouts << " blocked checkouts, max wait "
+        << report.max_checkout_wait.count() / 1000 << " ms.\n";
+    std::cout.flags(flags);
+    std::cout.precision(precision);
+}
+
+std::uint64_t LoadGenerator::nextRandom(std::uint64_t& state) {
+    std::uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
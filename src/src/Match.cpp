@@ -1,6 +1,13 @@
 #include "Match.hpp"
+#include "MatchHistoryIndex.hpp"
 #include "MatchState.hpp"
 #include "Player.hpp"
+#include "PersistenceQueue.hpp"
+#include "PointLog.hpp"
+#include "PreparedStatements.hpp"
+#include "QueryMetrics.hpp"
+#include "RatingEngine.hpp"
+#include "ReferenceData.hpp"
 #include <tabulate/table.hpp>
 #include <iostream>
 #include <chrono>
@@ -38,9 +45,9 @@ Match::~Match() {
 
 bool Match::playerExists(const int player_id) {
     DatabaseConnection& db = DatabaseConnection::getInstance();
-    pqxx::nontransaction nt(*db.getConnection());
-    
     try {
+        ConnectionLease lease = db.acquire();
+        TracedNontransaction nt(*lease, "Match::playerExists");
         const std::string query = "SELECT COUNT(*) FROM public.players WHERE id = " + nt.quote(player_id) + ";";
         pqxx::result r = nt.exec(query);
 
@@ -71,7 +78,8 @@ void Match::startMatch(const int match_id) {
 
     DatabaseConnection& db = DatabaseConnection::getInstance();
     try {
-        pqxx::work w(*db.getConnection());
+        ConnectionLease lease = db.acquire();
+        TracedWork w(*lease, "Match::startMatch");
         const std::string match_query = "UPDATE public.matches SET actual_start_time = '" + actual_start_time +
             "', status_id = " + std::to_string(status_id) + " WHERE id = " + std::to_string(id) + ";";
         w.exec(match_query);
@@ -91,8 +99,8 @@ void Match::startMatch(const int match_id) {
 
 void Match::endMatch(int winning_player_id) {
     std::cout << "Winner is player with ID " << winning_player_id << '\n';
-    const long long elapsed_minutes = timer.stop();
-    duration += std::chrono::minutes(elapsed_minutes);
+    const long long elapsed_seconds = timer.stop();
+    duration += std::chrono::seconds(elapsed_seconds);
 
     winner_id = winning_player_id;
     changeState(new FinishedState());
@@ -103,35 +111,31 @@ void Match::endMatch(int winning_player_id) {
         return;
     }
 
-    DatabaseConnection& db = DatabaseConnection::getInstance();
-    try {
-        pqxx::work w(*db.getConnection());
-
-        const int duration_minutes = std::chrono::duration_cast<std::chrono::minutes>(duration).count();
-
-        const std::string match_query = "UPDATE public.matches SET "
-            "winner_id = " + w.quote(winner_id) + ", "
-            "status_id = 3, "
-            "duration = duration + interval '" + std::to_string(duration_minutes) + " minutes' "
-            "WHERE id = " + w.quote(id) + ";";
+    UnitOfWork uow(id);
+    updateMatchInDatabase(uow);
+    uow.commit();
+    std::cout << "Match with ID " << id << " is finishing.\n";
 
-        w.exec(match_query);
-        w.commit();
-        std::cout << "Match with ID " << id << " is finishing.\n";
-    }
-    catch (const pqxx::sql_error& e) {
-        std::cerr << "SQL error in endMatch: " << e.what() << '\n';
-    }
-    catch (const std::exception& e) {
-        std::cerr << "Exception in endMatch: " << e.what() << '\n';
-    }
+    recordResult();
+    flushPendingWrites();
+}
 
-    if (winner_id == player_id1) {
-        Player::updateMatchResults(player_id1, player_id2);
-    }
-    else {
-        Player::updateMatchResults(player_id2, player_id1);
-    }
+void Match::recordResult() const {
+    const int winning_id = winner_id == player_id1 ? player_id1 : player_id2;
+    const int losing_id = winning_id == player_id1 ? player_id2 : player_id1;
+    Player::updateMatchResults(winning_id, losing_id);
+    RatingEngine::getInstance().recordResult(id, winning_id, losing_id);
+
+    MatchRecord record;
+    record.match_id = id;
+    record.player_id1 = player_id1;
+    record.player_id2 = player_id2;
+    record.winner_id = winning_id;
+    record.duration_seconds = static_cast<int>(duration.count());
+    record.no_sets = static_cast<std::uint8_t>(no_sets);
+    record.sets_player1 = static_cast<std::uint8_t>(sets_player1);
+    record.sets_player2 = static_cast<std::uint8_t>(sets_player2);
+    MatchHistoryIndex::getInstance().record(record);
 }
 
 void Match::suspendMatch() {
@@ -139,13 +143,21 @@ void Match::suspendMatch() {
     current_state->handle(this);
     updateStatusInDatabase();
     getCurrentSet()->updateTime();
+    flushPendingWrites();
     std::cout << "Match is suspended.\n";
 }
 
+void Match::flushPendingWrites() {
+    if (!PersistenceQueue::getInstance().flush()) {
+        std::cerr << "Some score updates could not be saved to the database.\n";
+    }
+}
+
 void Match::saveToDatabase(const std::string& predicted_start_time) {
     DatabaseConnection& db = DatabaseConnection::getInstance();
     try {
-        pqxx::work w(*db.getConnection());
+        ConnectionLease lease = db.acquire();
+        TracedWork w(*lease, "Match::saveToDatabase");
         const int duration_minutes = std::chrono::duration_cast<std::chrono::minutes>(duration).count();
         const std::string query = "INSERT INTO public.matches (status_id, player_id1, player_id2, predicted_start_time, duration, no_sets) "
             "VALUES ($1, $2, $3, $4, interval '" + std::to_string(duration_minutes) + " minutes', $5) RETURNING id;";
@@ -174,19 +186,9 @@ void Match::updateStatusInDatabase() const {
         return;
     }
 
-    DatabaseConnection& db = DatabaseConnection::getInstance();
-    try {
-        pqxx::work w(*db.getConnection());
-        const std::string match_query = "UPDATE public.matches SET status_id = $1 WHERE id = $2;";
-        w.exec_params(match_query, status_id, id);
-        w.commit();
-    }
-    catch (const pqxx::sql_error& e) {
-        std::cerr << "SQL error in updateStatusInDatabase: " << e.what() << '\n';
-    }
-    catch (const std::exception& e) {
-        std::cerr << "Exception in updateStatusInDatabase: " << e.what() << '\n';
-    }
+    PersistenceQueue::getInstance().enqueue(id, [match_id = id, status = status_id](pqxx::work& txn) {
+        PreparedStatements::exec<UpdateMatchStatusQuery>(txn, status, match_id);
+    });
 }
 
 std::string Match::getCurrentTime() {
@@ -220,22 +222,8 @@ bool Match::isLaterThanNow(const std::string& date_time_str) {
 }
 
 int Match::getStatusId(const std::string& status_name) {
-    DatabaseConnection& db = DatabaseConnection::getInstance();
     try {
-        pqxx::nontransaction nt(*db.getConnection());
-
-        const std::string query = "SELECT id FROM public.match_status WHERE status = $1;";
-        const pqxx::result r = nt.exec_params(query, status_name);
-
-        if (r.empty()) {
-            throw std::runtime_error("Status not found.");
-        }
-
-        return r[0][0].as<int>();
-    }
-    catch (const pqxx::sql_error& e) {
-        std::cerr << "SQL error in getStatusId: " << e.what() << '\n';
-        throw;
+        return ReferenceData::getInstance().getStatusId(status_name);
     }
     catch (const std::exception& e) {
         std::cerr << "Exception in getStatusId: " << e.what() << '\n';
@@ -267,7 +255,8 @@ std::optional<Match> Match::getMatchById(const int id, const std::vector<std::st
 
     pqxx::result r;
     try {
-        pqxx::nontransaction nt(*db.getConnection());
+        ConnectionLease lease = db.acquire();
+        TracedNontransaction nt(*lease, "Match::getMatchById");
         const std::string query =
             "SELECT id, player_id1, player_id2, no_sets, status_id, EXTRACT(EPOCH FROM duration) AS duration_seconds "
             "FROM public.matches "
@@ -320,83 +309,125 @@ void Match::changeState(MatchState* state) {
 
 void Match::initializeCurrentSet(const int match_id) {
     if (!current_set.has_value()) {
+        UnitOfWork uow(match_id);
         current_set = Set(match_id, no_sets);
-        current_set->addMatchSetRecord();
-        current_set->initializeCurrentGame(current_set->getIsPlayerOneServing());
+        current_set->addMatchSetRecord(uow);
+        current_set->initializeCurrentGame(current_set->getIsPlayerOneServing(), uow);
+        uow.commit();
     }
 }
 
 void Match::resumeCurrentSet(const int match_id) {
     if (!current_set.has_value()) {
-        DatabaseConnection& db = DatabaseConnection::getInstance();
-        try {
-            pqxx::work txn(*db.getConnection());
+        const std::optional<MatchScore> replayed = PointLog::replayMatch(match_id, no_sets);
+        if (replayed.has_value()) {
+            resumeFromPointLog(match_id, *replayed);
+        }
+        else {
+            resumeFromSetRecord(match_id);
+        }
+    }
+}
+
+// The point log is the source of truth: sets, games, the current game or tiebreak and the server all come from it.
+void Match::resumeFromPointLog(const int match_id, const MatchScore& score) {
+    sets_player1 = score.sets_player1;
+    sets_player2 = score.sets_player2;
+
+    // During a tiebreak the server changes after the first point and then every two; its first server opened the set.
+    const int tiebreak_points_played = score.points_player1 + score.points_player2;
+    const bool is_first_server_serving = !score.is_tiebreak || ((tiebreak_points_played + 1) / 2) % 2 == 0;
+    const bool is_game_server_player_one = is_first_server_serving ? score.is_player_one_serving : !score.is_player_one_serving;
+    const bool is_first_player_serving = isPlayerOneServing(score.games_player1 + score.games_player2, is_game_server_player_one);
+
+    current_set = Set(match_id, no_sets, score.getSetNum(), score.games_player1, score.games_player2, is_first_player_serving);
+    current_set->setIsResumedTiebreak(score.is_tiebreak);
+    if (score.is_tiebreak) {
+        current_set->setResumedTiebreakServer(score.is_player_one_serving);
+        current_set->setResumedTiebreakPoints(std::make_pair(score.points_player1, score.points_player2));
+    }
+    else {
+        current_set->resumeCurrentGame(score.points_player1, score.points_player2, score.is_player_one_serving);
+    }
+}
+
+// Matches recorded before the point log: the set comes from matches_sets and the game from game_points.
+void Match::resumeFromSetRecord(const int match_id) {
+    DatabaseConnection& db = DatabaseConnection::getInstance();
+    try {
+        // The lease is returned before the set and game below read their own state.
+        pqxx::result r;
+        {
+            ConnectionLease lease = db.acquire();
+            TracedNontransaction nt(*lease, "Match::resumeFromSetRecord");
             const std::string query = "SELECT match_id, set_number, games_won_player1, games_won_player2, "
                 "is_tie_break, is_first_player_serving "
-                "FROM matches_sets WHERE match_id = " + txn.quote(match_id) + " "
+                "FROM matches_sets WHERE match_id = " + nt.quote(match_id) + " "
                 "ORDER BY set_number DESC LIMIT 1;";
-            pqxx::result r = txn.exec(query);
-
-            if (r.size() == 1) {
-                const int set_number = r[0]["set_number"].as<int>();
-                const int games_player1 = r[0]["games_won_player1"].as<int>();
-                const int games_player2 = r[0]["games_won_player2"].as<int>();
-                const bool is_first_player_serving = r[0]["is_first_player_serving"].as<bool>();
-                const bool is_tiebreak = r[0]["is_tie_break"].as<bool>();
-	            txn.commit();
-                current_set = Set(match_id, no_sets, set_number, games_player1, games_player2, is_first_player_serving);
-
-                if (is_tiebreak)
-                {
-                    current_set->setIsResumedTiebreak(true);
-                }
-                else
-                {
-                    current_set->setIsResumedTiebreak(false);
-                	current_set->setIsPlayerOneServing(is_first_player_serving);
-
-                    if ((games_player1 + games_player2) % 2 == 0) {
-                        current_set->resumeCurrentGame(is_first_player_serving);
-                    }
-                    else
-                    {
-                        current_set->resumeCurrentGame(!is_first_player_serving);
-                    }
-                }
-                txn.commit();
-            }
-            else {
-                std::cerr << "No sets found for match_id: " << match_id << '\n';
-                std::cerr << "You have to start the match.\n";
+            r = nt.exec(query);
+        }
+
+        if (r.size() == 1) {
+            const int set_number = r[0]["set_number"].as<int>();
+            const int games_player1 = r[0]["games_won_player1"].as<int>();
+            const int games_player2 = r[0]["games_won_player2"].as<int>();
+            const bool is_first_player_serving = r[0]["is_first_player_serving"].as<bool>();
+            const bool is_tiebreak = r[0]["is_tie_break"].as<bool>();
+            current_set = Set(match_id, no_sets, set_number, games_player1, games_player2, is_first_player_serving);
+            current_set->setIsResumedTiebreak(is_tiebreak);
+
+            if (!is_tiebreak) {
+                current_set->resumeCurrentGame(isPlayerOneServing(games_player1 + games_player2, is_first_player_serving));
             }
         }
-        catch (const std::exception& e) {
-            std::cerr << "Exception in resumeCurSet: " << e.what() << '\n';
+        else {
+            std::cerr << "No sets found for match_id: " << match_id << '\n';
+            std::cerr << "You have to start the match.\n";
         }
     }
+    catch (const std::exception& e) {
+        std::cerr << "Exception in resumeCurSet: " << e.what() << '\n';
+    }
 }
 
-void Match::updateCurrentSet(const int match_id) {
+void Match::updateCurrentSet(const int match_id, UnitOfWork& uow) {
     const int number_of_games = current_set->getNumberOfGames();
     const bool is_player_one_serving = isPlayerOneServing(number_of_games, current_set->getIsPlayerOneServing());
     current_set = Set(match_id, no_sets, current_set->getSetNum() + 1);
     current_set->setIsPlayerOneServing(is_player_one_serving);
-    current_set->addMatchSetRecord();
-    current_set->initializeCurrentGame(current_set->getIsPlayerOneServing());
+    current_set->addMatchSetRecord(uow);
+    current_set->initializeCurrentGame(current_set->getIsPlayerOneServing(), uow);
 }
 
+CompactScore Match::getCompactScore() const {
+    MatchScore score;
+    score.no_sets = no_sets;
+    score.sets_player1 = sets_player1;
+    score.sets_player2 = sets_player2;
+    if (winner_id) {
+        score.winner = (*winner_id == player_id1) ? 1 : 2;
+    }
+    if (current_set.has_value()) {
+        score.games_player1 = current_set->getGamesPlayerOne();
+        score.games_player2 = current_set->getGamesPlayerTwo();
+        score.is_tiebreak = ScoringEngine::isTiebreak(score.games_player1, score.games_player2);
+        score.is_player_one_serving = isPlayerOneServing(current_set->getNumberOfGames(), current_set->getIsPlayerOneServing());
+        if (!score.is_tiebreak && current_set->getCurrentGame().has_value()) {
+            const Game& game = *current_set->getCurrentGame();
+            score.points_player1 = game.getPointsPlayerOne();
+            score.points_player2 = game.getPointsPlayerTwo();
+        }
+    }
+    return CompactScore::fromMatchScore(score);
+}
 
 void Match::finishMatch() {
     changeState(new FinishedState());
     current_state->handle(this);
     updateStatusInDatabase();
     updateWinnerInDatabase();
-    if (winner_id == player_id1) {
-        Player::updateMatchResults(player_id1, player_id2);
-    }
-    else {
-        Player::updateMatchResults(player_id2, player_id1);
-    }
+    recordResult();
+    flushPendingWrites();
     std::cout << "Match is finished.\n";
 }
 
@@ -406,21 +437,9 @@ void Match::updateWinnerInDatabase() const {
         return;
     }
 
-    DatabaseConnection& db = DatabaseConnection::getInstance();
-    try {
-        pqxx::work w(*db.getConnection());
-        const std::string update_query = "UPDATE public.matches SET "
-            "winner_id = " + (winner_id.has_value() ? std::to_string(winner_id.value()) : "NULL") +
-            " WHERE id = " + std::to_string(id) + ";";
-        w.exec(update_query);
-        w.commit();
-    }
-    catch (const pqxx::sql_error& e) {
-        std::cerr << "SQL error in updateWinnerInDatabase: " << e.what() << '\n';
-    }
-    catch (const std::exception& e) {
-        std::cerr << "Exception in updateWinnerInDatabase: " << e.what() << '\n';
-    }
+    PersistenceQueue::getInstance().enqueue(id, [match_id = id, winner = winner_id](pqxx::work& txn) {
+        PreparedStatements::exec<UpdateMatchWinnerQuery>(txn, winner, match_id);
+    });
 }
 
 void Match::resumeMatch(const int match_id) {
@@ -435,7 +454,8 @@ void Match::resumeMatch(const int match_id) {
 
     DatabaseConnection& db = DatabaseConnection::getInstance();
     try {
-        pqxx::work w(*db.getConnection());
+        ConnectionLease lease = db.acquire();
+        TracedWork w(*lease, "Match::resumeMatch");
         const std::string match_query = "UPDATE public.matches SET status_id = " + std::to_string(status_id) + " WHERE id = " + std::to_string(id) + ";";
         w.exec(match_query);
         w.commit();
@@ -452,7 +472,35 @@ void Match::resumeMatch(const int match_id) {
     resumeCurrentSet(match_id);
 }
 
-void Match::updateMatchInDatabase() {
+int Match::recordGame(const int game_winner, UnitOfWork& uow, const Set::TiebreakInput& tiebreak_input) {
+    const int game_status = current_set->addGameResult(game_winner, uow, tiebreak_input);
+    if (game_status == 0) {
+        current_set->changeGame(uow);
+    }
+    else if (game_status == 1 || game_status == 2) {
+        if (game_status == 1) {
+            updateSetsPlayerOne();
+        }
+        else {
+            updateSetsPlayerTwo();
+        }
+        updateMatchInDatabase(uow);
+        if (!isMatchWinner()) {
+            updateCurrentSet(id, uow);
+        }
+    }
+    return game_status;
+}
+
+bool Match::endIfWon() {
+    if (sets_player1 < no_sets && sets_player2 < no_sets) {
+        return false;
+    }
+    endMatch(sets_player1 > sets_player2 ? player_id1 : player_id2);
+    return true;
+}
+
+void Match::updateMatchInDatabase(UnitOfWork& uow) {
     if (id == -1) {
         std::cerr << "Match ID not set. Cannot update match.\n";
         return;
@@ -462,58 +510,25 @@ void Match::updateMatchInDatabase() {
     duration += std::chrono::seconds(elapsed_seconds);
     timer.start();
 
-    DatabaseConnection& db = DatabaseConnection::getInstance();
-    try {
-        pqxx::work w(*db.getConnection());
-        const int duration_minutes = std::chrono::duration_cast<std::chrono::minutes>(duration).count();
-        const std::string update_query = "UPDATE public.matches SET "
-            "duration = duration + interval '" + std::to_string(duration_minutes) + " minutes', "
-            "status_id = " + std::to_string(status_id) + ", "
-            "winner_id = " + (winner_id.has_value() ? std::to_string(winner_id.value()) : "NULL") +
-            " WHERE id = " + std::to_string(id) + ";";
-
-        w.exec(update_query);
-        w.commit();
-    }
-    catch (const pqxx::sql_error& e) {
-        std::cerr << "SQL error in updateMatchInDatabase: " << e.what() << '\n';
-    }
-    catch (const std::exception& e) {
-        std::cerr << "Exception in updateMatchInDatabase: " << e.what() << '\n';
-    }
+    const long long duration_minutes = std::chrono::duration_cast<std::chrono::minutes>(duration).count();
+    uow.add([match_id = id, duration_minutes, status = status_id, winner = winner_id](pqxx::work& txn) {
+        PreparedStatements::exec<UpdateMatchProgressQuery>(txn, duration_minutes, status, winner, match_id);
+    });
 }
 
 std::string Match::getStatusById(const int status_id) {
-    DatabaseConnection& db = DatabaseConnection::getInstance();
-    pqxx::result r;
-
-    try {
-        pqxx::nontransaction nt(*db.getConnection());
-        const std::string query = "SELECT status FROM match_status WHERE id = " + nt.quote(status_id) + ";";
-        r = nt.exec(query);
-
-        if (!r.empty()) {
-            return r[0]["status"].as<std::string>();
-        }
-        else {
-            std::cerr << "Status ID " << status_id << " not found.\n";
-            return "Unknown Status";
-        }
-    }
-    catch (const pqxx::sql_error& e) {
-        std::cerr << "SQL error while retrieving status name: " << e.what() << '\n';
-        return "Unknown Status";
-    }
-    catch (const std::exception& e) {
-        std::cerr << "Error while retrieving status name: " << e.what() << '\n';
-        return "Unknown Status";
+    if (const auto status = ReferenceData::getInstance().getStatusName(status_id)) {
+        return *status;
     }
+    std::cerr << "Status ID " << status_id << " not found.\n";
+    return "Unknown Status";
 }
 
 void Match::displayPlayerInfo() const {
     DatabaseConnection& db = DatabaseConnection::getInstance();
     try {
-        pqxx::work w(*db.getConnection());
+        ConnectionLease lease = db.acquire();
+        TracedWork w(*lease, "Match::displayPlayerInfo");
 
         const std::string player_query = "SELECT id, first_name, last_name, matches_won, matches_lost "
             "FROM public.players WHERE id IN (" + std::to_string(player_id1) + ", " + std::to_string(player_id2) + ");";
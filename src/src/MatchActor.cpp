@@ -0,0 +1,193 @@
+#include "MatchActor.hpp"
+#include "LiveScoreCache.hpp"
+#include "MatchHistoryIndex.hpp"
+#include "PersistenceQueue.hpp"
+#include "PointLog.hpp"
+#include "PreparedStatements.hpp"
+#include "RatingEngine.hpp"
+#include "ReferenceData.hpp"
+#include "ScoreEventBus.hpp"
+#include "ScoringTables.hpp"
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+MatchActor::MatchActor(const MatchInfo& info, ThreadPool& pool, const bool is_persistent)
+    : info_(info), pool_(pool), is_persistent_(is_persistent), opened_at_(std::chrono::steady_clock::now()),
+    snapshot_(CompactScore::fromMatchScore(info.score).getBits()) {
+}
+
+long long MatchActor::getSessionSeconds() const {
+    return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - opened_at_).count();
+}
+
+std::future<PointAck> MatchActor::post(const int player) {
+    Command command{ player, false, std::chrono::steady_clock::now(), std::promise<PointAck>(), nullptr };
+    std::future<PointAck> ack = command.ack.get_future();
+    enqueue(std::move(command));
+    return ack;
+}
+
+// Ends the match early, e.g. on retirement, with the given player (1 or 2) as winner.
+std::future<PointAck> MatchActor::finish(const int winner) {
+    Command command{ winner, true, std::chrono::steady_clock::now(), std::promise<PointAck>(), nullptr };
+    std::future<PointAck> ack = command.ack.get_future();
+    enqueue(std::move(command));
+    return ack;
+}
+
+void MatchActor::post(const int player, AckCallback on_ack) {
+    enqueue(Command{ player, false, std::chrono::steady_clock::now(), std::promise<PointAck>(), std::move(on_ack) });
+}
+
+void MatchActor::finish(const int winner, AckCallback on_ack) {
+    enqueue(Command{ winner, true, std::chrono::steady_clock::now(), std::promise<PointAck>(), std::move(on_ack) });
+}
+
+std::future<PointAck> MatchActor::stop() {
+    Command command{ 0, false, std::chrono::steady_clock::now(), std::promise<PointAck>(), nullptr, true };
+    std::future<PointAck> ack = command.ack.get_future();
+    enqueue(std::move(command));
+    return ack;
+}
+
+void MatchActor::enqueue(Command command) {
+    bool is_scheduling = false;
+    {
+        std::lock_guard<std::mutex> lock(mailbox_mutex_);
+        mailbox_.push_back(std::move(command));
+        if (!is_scheduled_) {
+            is_scheduled_ = true;
+            is_scheduling = true;
+        }
+    }
+
+    if (is_scheduling) {
+        pool_.submit([self = shared_from_this()] { self->drain(); });
+    }
+}
+
+// Handles at most MAX_BATCH points per turn and then yields the worker, so a flood on one court cannot hog a thread.
+void MatchActor::drain() {
+    std::vector<Command> batch;
+    {
+        std::lock_guard<std::mutex> lock(mailbox_mutex_);
+        const std::size_t count = std::min(MAX_BATCH, mailbox_.size());
+        batch.reserve(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            batch.push_back(std::move(mailbox_.front()));
+            mailbox_.pop_front();
+        }
+    }
+
+    for (auto& command : batch) {
+        PointAck ack;
+        ack.match_id = info_.match_id;
+        ack.received_at = command.received_at;
+
+        const MatchScore before = info_.score;
+        PointResult result;
+        if (is_stopped_) {
+            result.events = INVALID_POINT;
+        }
+        else if (command.is_stopping) {
+            is_stopped_ = true;
+        }
+        else if (!command.is_finishing) {
+            result = ScoringTables::scorePoint(info_.score, command.player);
+        }
+        else if (info_.score.isFinished() || (command.player != 1 && command.player != 2)) {
+            result.events = INVALID_POINT;
+        }
+        else {
+            info_.score.winner = command.player;
+            result.events = MATCH_WON;
+        }
+        ack.events = result.events;
+        ack.is_accepted = !result.has(INVALID_POINT);
+        ack.score = CompactScore::fromMatchScore(info_.score);
+
+        if (ack.is_accepted && !command.is_stopping) {
+            snapshot_.store(ack.score.getBits(), std::memory_order_release);
+            const int status_id = ack.score.isFinished() ? ReferenceData::getInstance().getStatusId("Finished") : 0;
+            LiveScoreCache::getInstance().update(info_.match_id, ack.score, status_id);
+            ScoreEventBus::getInstance().publish(info_.match_id, ack.score, ack.events);
+            if (is_persistent_ && command.is_finishing) {
+                persistResult();
+            }
+            else if (is_persistent_) {
+                persist(before, command.player, result);
+            }
+        }
+
+        ack.acked_at = std::chrono::steady_clock::now();
+        if (command.on_ack) {
+            command.on_ack(ack);
+        }
+        else {
+            command.ack.set_value(ack);
+        }
+    }
+
+    bool is_rescheduling = false;
+    {
+        std::lock_guard<std::mutex> lock(mailbox_mutex_);
+        if (mailbox_.empty()) {
+            is_scheduled_ = false;
+        }
+        else {
+            is_rescheduling = true;
+        }
+    }
+
+    if (is_rescheduling) {
+        pool_.submit([self = shared_from_this()] { self->drain(); });
+    }
+}
+
+// Completed sets are also written to matches_sets, which keeps match_summary and the set reports in step with the console path.
+void MatchActor::persist(const MatchScore& before, const int player, const PointResult& result) const {
+    const int match_id = info_.match_id;
+    PointLog::getInstance().record(match_id, player, before.is_player_one_serving);
+
+    if (result.has(SET_WON)) {
+        const int set_num = before.getSetNum();
+        const int games_player1 = before.games_player1 + (player == 1 ? 1 : 0);
+        const int games_player2 = before.games_player2 + (player == 2 ? 1 : 0);
+        const bool is_tiebreak = before.is_tiebreak;
+        PersistenceQueue::getInstance().enqueue(match_id, [=](pqxx::work& txn) {
+            PreparedStatements::exec<UpsertSetResultQuery>(txn, match_id, set_num, games_player1, games_player2, is_tiebreak);
+        });
+    }
+    if (result.has(MATCH_WON)) {
+        persistResult();
+    }
+}
+
+void MatchActor::persistResult() const {
+    const int match_id = info_.match_id;
+    const int finished_status_id = ReferenceData::getInstance().getStatusId("Finished");
+    const int winner_id = info_.score.winner == 1 ? info_.player_id1 : info_.player_id2;
+    const int loser_id = info_.score.winner == 1 ? info_.player_id2 : info_.player_id1;
+    const long long session_seconds = getSessionSeconds();
+
+    PersistenceQueue::getInstance().addDuration(match_id, session_seconds);
+    PersistenceQueue::getInstance().enqueue(match_id, [=](pqxx::work& txn) {
+        PreparedStatements::exec<UpdateMatchStatusQuery>(txn, finished_status_id, match_id);
+        PreparedStatements::exec<UpdateMatchWinnerQuery>(txn, std::optional<int>(winner_id), match_id);
+        PreparedStatements::exec<RecordPlayerWinQuery>(txn, winner_id);
+        PreparedStatements::exec<RecordPlayerLossQuery>(txn, loser_id);
+    });
+    RatingEngine::getInstance().recordResult(match_id, winner_id, loser_id);
+
+    MatchRecord record;
+    record.match_id = match_id;
+    record.player_id1 = info_.player_id1;
+    record.player_id2 = info_.player_id2;
+    record.winner_id = winner_id;
+    record.duration_seconds = info_.duration_seconds + static_cast<int>(session_seconds);
+    record.no_sets = static_cast<std::uint8_t>(info_.score.no_sets);
+    record.sets_player1 = static_cast<std::uint8_t>(info_.score.sets_player1);
+    record.sets_player2 = static_cast<std::uint8_t>(info_.score.sets_player2);
+    MatchHistoryIndex::getInstance().record(record);
+}
@@ -0,0 +1,136 @@
+#include "MatchHistoryIndex.hpp"
+#include "DatabaseConnection.hpp"
+#include "ReferenceData.hpp"
+#include <algorithm>
+#include <iostream>
+#include <mutex>
+#include <utility>
+
+MatchHistoryIndex& MatchHistoryIndex::getInstance() {
+    static MatchHistoryIndex instance;
+    return instance;
+}
+
+bool MatchHistoryIndex::build(const std::size_t fetch_size) {
+    std::vector<MatchRecord> records;
+
+    try {
+        ConnectionLease lease = DatabaseConnection::getInstance().acquire();
+        pqxx::work txn(*lease);
+        txn.exec(
+            "DECLARE match_history_cursor NO SCROLL CURSOR FOR "
+            "SELECT s.match_id, s.player_id1, s.player_id2, COALESCE(m.winner_id, 0) AS winner_id, "
+            "EXTRACT(EPOCH FROM s.duration)::int AS duration_seconds, s.no_sets, s.sets_won_player1, s.sets_won_player2 "
+            "FROM public.match_summary s JOIN public.matches m ON m.id = s.match_id "
+            "WHERE m.status_id = " + txn.quote(ReferenceData::getInstance().getStatusId("Finished")) + " ORDER BY s.match_id");
+
+        const std::string fetch = "FETCH FORWARD " + std::to_string(fetch_size) + " FROM match_history_cursor";
+        while (true) {
+            const pqxx::result batch = txn.exec(fetch);
+            for (const auto& row : batch) {
+                MatchRecord match;
+                match.match_id = row["match_id"].as<int>();
+                match.player_id1 = row["player_id1"].as<int>();
+                match.player_id2 = row["player_id2"].as<int>();
+                match.winner_id = row["winner_id"].as<int>();
+                match.duration_seconds = row["duration_seconds"].as<int>();
+                match.no_sets = static_cast<std::uint8_t>(row["no_sets"].as<int>());
+                match.sets_player1 = static_cast<std::uint8_t>(row["sets_won_player1"].as<int>());
+                match.sets_player2 = static_cast<std::uint8_t>(row["sets_won_player2"].as<int>());
+                records.push_back(match);
+            }
+            if (static_cast<std::size_t>(batch.size()) < fetch_size) {
+                break;
+            }
+        }
+
+        txn.exec("CLOSE match_history_cursor");
+        txn.commit();
+    }
+    catch (const pqxx::sql_error& e) {
+        std::cerr << "SQL error while building match history index: " << e.what() << '\n';
+        return false;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Exception while building match history index: " << e.what() << '\n';
+        return false;
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    records_.clear();
+    by_match_.clear();
+    by_player_.clear();
+    by_pair_.clear();
+    records_.reserve(records.size());
+    by_match_.reserve(records.size());
+    for (const auto& match : records) {
+        insert(match);
+    }
+    return true;
+}
+
+void MatchHistoryIndex::record(const MatchRecord& match) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    const auto existing = by_match_.find(match.match_id);
+    if (existing != by_match_.end()) {
+        records_[existing->second] = match;
+        return;
+    }
+    insert(match);
+}
+
+// Caller holds mutex_ exclusively. Records never move, so positions stay valid.
+void MatchHistoryIndex::insert(const MatchRecord& match) {
+    const auto position = static_cast<std::uint32_t>(records_.size());
+    records_.push_back(match);
+    by_match_.emplace(match.match_id, position);
+    link(by_player_[match.player_id1], position);
+    link(by_player_[match.player_id2], position);
+    link(by_pair_[pairKey(match.player_id1, match.player_id2)], position);
+}
+
+// Matches normally finish in ID order, so this is an append; an older match finishing late is placed by ID.
+void MatchHistoryIndex::link(std::vector<std::uint32_t>& positions, const std::uint32_t position) const {
+    const int match_id = records_[position].match_id;
+    if (positions.empty() || records_[positions.back()].match_id < match_id) {
+        positions.push_back(position);
+        return;
+    }
+    const auto at = std::upper_bound(positions.begin(), positions.end(), match_id,
+        [this](const int id, const std::uint32_t other) { return id < records_[other].match_id; });
+    positions.insert(at, position);
+}
+
+std::vector<MatchRecord> MatchHistoryIndex::collect(const std::vector<std::uint32_t>* positions) const {
+    std::vector<MatchRecord> matches;
+    if (positions != nullptr) {
+        matches.reserve(positions->size());
+        for (const std::uint32_t position : *positions) {
+            matches.push_back(records_[position]);
+        }
+    }
+    return matches;
+}
+
+std::vector<MatchRecord> MatchHistoryIndex::getPlayerHistory(const int player_id) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    const auto it = by_player_.find(player_id);
+    return collect(it != by_player_.end() ? &it->second : nullptr);
+}
+
+std::vector<MatchRecord> MatchHistoryIndex::getHeadToHead(const int player_a, const int player_b) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    const auto it = by_pair_.find(pairKey(player_a, player_b));
+    return collect(it != by_pair_.end() ? &it->second : nullptr);
+}
+
+std::size_t MatchHistoryIndex::size() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return records_.size();
+}
+
+std::uint64_t MatchHistoryIndex::pairKey(const int player_a, const int player_b) {
+    const auto low = static_cast<std::uint32_t>(std::min(player_a, player_b));
+    const auto high = static_cast<std::uint32_t>(std::max(player_a, player_b));
+    return (static_cast<std::uint64_t>(low) << 32) | high;
+}
@@ -0,0 +1,180 @@
+#include "MatchSimulator.hpp"
+#include "Match.hpp"
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <thread>
+#include <vector>
+
+SimulationResult MatchSimulator::simulate(const Match& match, const SimulationParams& params) {
+    return simulate(match.getCompactScore(), params);
+}
+
+SimulationResult MatchSimulator::simulate(const CompactScore& start, const SimulationParams& params) {
+    const auto started_at = std::chrono::steady_clock::now();
+    SimulationResult result;
+
+    if (start.isFinished()) {
+        const double is_player_one_winner = start.getWinner() == 1 ? 1.0 : 0.0;
+        result.match_win_player1 = is_player_one_winner;
+        result.set_win_player1 = is_player_one_winner;
+        result.game_win_player1 = is_player_one_winner;
+        return result;
+    }
+
+    const unsigned hardware_threads = std::max(1u, std::thread::hardware_concurrency());
+    const unsigned thread_count = params.threads == 0 ? hardware_threads : params.threads;
+    const std::size_t quota = (params.simulations + thread_count - 1) / thread_count;
+    const auto deadline = started_at + params.budget;
+    const std::uint64_t seed = params.seed != 0
+        ? params.seed : static_cast<std::uint64_t>(started_at.time_since_epoch().count());
+
+    const MatchScore start_score = start.toMatchScore();
+    std::vector<Tally> tallies(thread_count);
+    std::vector<std::thread> workers;
+    workers.reserve(thread_count);
+    for (unsigned i = 0; i < thread_count; ++i) {
+        workers.emplace_back(&MatchSimulator::runWorker, std::cref(start_score), std::cref(params), quota,
+            seed + i * 0xD1B54A32D192ED03ULL, deadline, std::ref(tallies[i]));
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    Tally total;
+    for (const auto& tally : tallies) {
+        total.simulations += tally.simulations;
+        total.matches_won_player1 += tally.matches_won_player1;
+        total.sets_won_player1 += tally.sets_won_player1;
+        total.games_won_player1 += tally.games_won_player1;
+    }
+
+    result.simulations = total.simulations;
+    if (total.simulations > 0) {
+        const double simulations = static_cast<double>(total.simulations);
+        result.match_win_player1 = static_cast<double>(total.matches_won_player1) / simulations;
+        result.set_win_player1 = static_cast<double>(total.sets_won_player1) / simulations;
+        result.game_win_player1 = static_cast<double>(total.games_won_player1) / simulations;
+    }
+    result.is_budget_exceeded = total.simulations < params.simulations;
+    result.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - started_at);
+    return result;
+}
+
+// Matches run in batches of LANES side by side: random numbers for a whole batch are drawn in one tight loop,
+// then every unfinished lane advances. Regular games are decided with a single draw against the precomputed
+// chance of winning the game from its current score; tiebreaks are played point by point.
+void MatchSimulator::runWorker(const MatchScore& start, const SimulationParams& params, const std::size_t quota,
+    std::uint64_t seed, const std::chrono::steady_clock::time_point deadline, Tally& tally) {
+    const std::uint64_t threshold_player1 = toThreshold(params.serve_win_player1);
+    const std::uint64_t threshold_player2 = toThreshold(params.serve_win_player2);
+    const GameThresholds player_one_serving = gameThresholds(params.serve_win_player1);
+    const GameThresholds player_two_serving = gameThresholds(1.0 - params.serve_win_player2);
+
+    std::array<MatchScore, LANES> scores;
+    std::array<std::uint8_t, LANES> set_winners;
+    std::array<std::uint8_t, LANES> game_winners;
+    std::array<std::uint64_t, LANES> random;
+
+    std::size_t done = 0;
+    while (done < quota && std::chrono::steady_clock::now() < deadline) {
+        const std::size_t lanes = std::min(LANES, quota - done);
+        scores.fill(start);
+        set_winners.fill(0);
+        game_winners.fill(0);
+
+        std::size_t active = lanes;
+        while (active > 0) {
+            for (std::size_t lane = 0; lane < lanes; ++lane) {
+                random[lane] = nextRandom(seed);
+            }
+
+            active = 0;
+            for (std::size_t lane = 0; lane < lanes; ++lane) {
+                MatchScore& score = scores[lane];
+                if (score.isFinished()) {
+                    continue;
+                }
+
+                const bool is_player_one_serving = score.is_player_one_serving;
+                PointResult point;
+                if (score.is_tiebreak) {
+                    const bool is_server_winning = random[lane] < (is_player_one_serving ? threshold_player1 : threshold_player2);
+                    point = ScoringTables::scorePoint(score, (is_server_winning == is_player_one_serving) ? 1 : 2);
+                }
+                else {
+                    const GameThresholds& thresholds = is_player_one_serving ? player_one_serving : player_two_serving;
+                    const std::uint64_t threshold = thresholds[score.points_player1 * ScoringTables::GAME_STATES + score.points_player2];
+                    point = ScoringTables::scoreGame(score, random[lane] < threshold ? 1 : 2);
+                }
+                if (game_winners[lane] == 0) {
+                    game_winners[lane] = static_cast<std::uint8_t>(point.game_winner);
+                }
+                if (set_winners[lane] == 0) {
+                    set_winners[lane] = static_cast<std::uint8_t>(point.set_winner);
+                }
+                active += score.isFinished() ? 0 : 1;
+            }
+        }
+
+        for (std::size_t lane = 0; lane < lanes; ++lane) {
+            tally.matches_won_player1 += scores[lane].winner == 1 ? 1 : 0;
+            tally.sets_won_player1 += set_winners[lane] == 1 ? 1 : 0;
+            tally.games_won_player1 += game_winners[lane] == 1 ? 1 : 0;
+        }
+        done += lanes;
+    }
+    tally.simulations = done;
+}
+
+// Chance that player 1 wins the game from each score in GAME_TABLE, iterated until the deuce loop converges.
+MatchSimulator::GameThresholds MatchSimulator::gameThresholds(const double point_win_player1) {
+    constexpr int states = ScoringTables::GAME_STATES * ScoringTables::GAME_STATES;
+    std::array<double, states> win_player1{};
+
+    for (int iteration = 0; iteration < 200; ++iteration) {
+        for (int points_player1 = 0; points_player1 < ScoringTables::GAME_STATES; ++points_player1) {
+            for (int points_player2 = 0; points_player2 < ScoringTables::GAME_STATES; ++points_player2) {
+                const int state = points_player1 * ScoringTables::GAME_STATES + points_player2;
+                const int winner = ScoringEngine::gameWinner(points_player1, points_player2);
+                if (winner != 0) {
+                    win_player1[state] = winner == 1 ? 1.0 : 0.0;
+                    continue;
+                }
+
+                double chance = 0.0;
+                for (int player = 1; player <= 2; ++player) {
+                    const GameTransition& next = ScoringTables::GAME_TABLE[ScoringTables::gameIndex(points_player1, points_player2, player)];
+                    const double outcome = next.winner != 0
+                        ? (next.winner == 1 ? 1.0 : 0.0)
+                        : win_player1[next.points_player1 * ScoringTables::GAME_STATES + next.points_player2];
+                    chance += (player == 1 ? point_win_player1 : 1.0 - point_win_player1) * outcome;
+                }
+                win_player1[state] = chance;
+            }
+        }
+    }
+
+    GameThresholds thresholds{};
+    for (int state = 0; state < states; ++state) {
+        thresholds[state] = toThreshold(win_player1[state]);
+    }
+    return thresholds;
+}
+
+std::uint64_t MatchSimulator::toThreshold(const double probability) {
+    if (probability <= 0.0) {
+        return 0;
+    }
+    if (probability >= 1.0) {
+        return std::numeric_limits<std::uint64_t>::max();
+    }
+    return static_cast<std::uint64_t>(probability * 18446744073709551616.0);
+}
+
+std::uint64_t MatchSimulator::nextRandom(std::uint64_t& state) {
+    std::uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
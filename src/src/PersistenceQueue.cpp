@@ -0,0 +1,212 @@
+#include "PersistenceQueue.hpp"
+#include "DatabaseConnection.hpp"
+#include "PreparedStatements.hpp"
+#include <algorithm>
+#include <iostream>
+#include <iterator>
+
+PersistenceQueue& PersistenceQueue::getInstance() {
+    DatabaseConnection::getInstance();
+    static PersistenceQueue instance(DEFAULT_CAPACITY, DEFAULT_BATCH_SIZE, DEFAULT_FLUSH_INTERVAL);
+    return instance;
+}
+
+PersistenceQueue::PersistenceQueue(const std::size_t capacity, const std::size_t batch_size, const std::chrono::milliseconds flush_interval)
+    : capacity_(std::max<std::size_t>(capacity, 1)), batch_size_(std::max<std::size_t>(batch_size, 1)), flush_interval_(flush_interval) {
+    worker_ = std::thread(&PersistenceQueue::run, this);
+}
+
+PersistenceQueue::~PersistenceQueue() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        is_stopping_ = true;
+    }
+    work_available_.notify_all();
+    space_available_.notify_all();
+
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+void PersistenceQueue::enqueue(const int match_id, Write write) {
+    push(match_id, std::string(), std::move(write), 0);
+}
+
+void PersistenceQueue::enqueue(const int match_id, Write write, Committed on_committed) {
+    push(match_id, std::string(), std::move(write), 0, std::move(on_committed));
+}
+
+void PersistenceQueue::enqueue(const int match_id, const std::string& key, Write write) {
+    push(match_id, key, std::move(write), 0);
+}
+
+void PersistenceQueue::addDuration(const int match_id, const long long seconds) {
+    if (seconds <= 0) {
+        return;
+    }
+    push(match_id, "duration", nullptr, seconds);
+}
+
+void PersistenceQueue::push(const int match_id, const std::string& key, Write write, const long long duration_seconds,
+    Committed on_committed) {
+    const std::string full_key = key.empty() ? std::string() : makeKey(match_id, key);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    ++metrics_.enqueued;
+
+    while (true) {
+        if (!full_key.empty()) {
+            const auto found = pending_by_key_.find(full_key);
+            if (found != pending_by_key_.end()) {
+                ++metrics_.coalesced;
+                if (!write) {
+                    found->second->duration_seconds += duration_seconds;
+                    return;
+                }
+                pending_.erase(found->second);
+                pending_by_key_.erase(found);
+                break;
+            }
+        }
+
+        if (pending_.size() < capacity_ || is_stopping_) {
+            break;
+        }
+        space_available_.wait(lock);
+    }
+
+    if (pending_.empty()) {
+        oldest_pending_ = std::chrono::steady_clock::now();
+    }
+
+    pending_.push_back(PendingWrite{ next_seq_++, match_id, key, std::move(write), duration_seconds, std::move(on_committed) });
+    if (!full_key.empty()) {
+        pending_by_key_[full_key] = std::prev(pending_.end());
+    }
+
+    metrics_.max_depth = std::max(metrics_.max_depth, pending_.size());
+    if (pending_.size() >= batch_size_) {
+        work_available_.notify_one();
+    }
+}
+
+bool PersistenceQueue::flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    const std::uint64_t target = next_seq_ - 1;
+    flush_target_ = std::max(flush_target_, target);
+    work_available_.notify_one();
+
+    committed_.wait(lock, [this, target] { return committed_seq_ >= target; });
+
+    const bool is_ok = !has_failed_;
+    has_failed_ = false;
+    return is_ok;
+}
+
+QueueMetrics PersistenceQueue::getMetrics() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    QueueMetrics snapshot = metrics_;
+    snapshot.depth = pending_.size();
+    return snapshot;
+}
+
+void PersistenceQueue::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    while (true) {
+        if (pending_.empty()) {
+            if (is_stopping_) {
+                break;
+            }
+            work_available_.wait(lock, [this] { return !pending_.empty() || is_stopping_; });
+            continue;
+        }
+
+        work_available_.wait_until(lock, oldest_pending_ + flush_interval_, [this] {
+            return pending_.size() >= batch_size_ || flush_target_ > committed_seq_ || is_stopping_;
+        });
+
+        std::vector<PendingWrite> batch;
+        batch.reserve(pending_.size());
+        std::move(pending_.begin(), pending_.end(), std::back_inserter(batch));
+        pending_.clear();
+        pending_by_key_.clear();
+
+        lock.unlock();
+        space_available_.notify_all();
+
+        const bool is_ok = commitBatch(batch);
+
+        lock.lock();
+        for (const auto& write : batch) {
+            committed_seq_ = std::max(committed_seq_, write.seq);
+        }
+        ++metrics_.batches;
+        metrics_.statements += batch.size();
+        if (!is_ok) {
+            ++metrics_.failed_batches;
+            has_failed_ = true;
+        }
+        committed_.notify_all();
+    }
+}
+
+bool PersistenceQueue::commitBatch(const std::vector<PendingWrite>& batch) {
+    const auto apply = [](pqxx::work& txn, const PendingWrite& write) {
+        if (write.write) {
+            write.write(txn);
+        }
+        else {
+            PreparedStatements::exec<AddMatchDurationQuery>(txn, write.duration_seconds, write.match_id);
+        }
+    };
+
+    IDatabaseConnection* const override_database = database_;
+    IDatabaseConnection& database = override_database ? *override_database : DatabaseConnection::getInstance();
+
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        try {
+            database.runTransaction("PersistenceQueue::batch", [&batch, &apply](pqxx::work& txn) {
+                for (const auto& write : batch) {
+                    apply(txn, write);
+                }
+            });
+            for (const auto& write : batch) {
+                if (write.on_committed) {
+                    write.on_committed();
+                }
+            }
+            return true;
+        }
+        catch (const pqxx::sql_error& e) {
+            std::cerr << "SQL error in persistence batch, retrying writes one by one: " << e.what() << '\n';
+            break;
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Exception in persistence batch (attempt " << attempt + 1 << "): " << e.what() << '\n';
+        }
+    }
+
+    bool is_ok = true;
+    for (const auto& write : batch) {
+        try {
+            database.runTransaction("PersistenceQueue::retry", [&write, &apply](pqxx::work& txn) {
+                apply(txn, write);
+            });
+            if (write.on_committed) {
+                write.on_committed();
+            }
+        }
+        catch (const pqxx::sql_error& e) {
+            std::cerr << "SQL error persisting write for match " << write.match_id << ": " << e.what() << '\n';
+            std::cerr << "Query was: " << e.query() << '\n';
+            is_ok = false;
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Exception persisting write for match " << write.match_id << ": " << e.what() << '\n';
+            is_ok = false;
+        }
+    }
+    return is_ok;
+}
@@ -1,11 +1,15 @@
 #include "Player.hpp"
+#include "KeysetPager.hpp"
+#include "PlayerSearchIndex.hpp"
+#include "QueryMetrics.hpp"
+#include "TableWriter.hpp"
 #include "validate.hpp"
 #include <iostream>
-#include <tabulate/table.hpp>
 
 bool Player::exists(const int player_id) {
     DatabaseConnection& db = DatabaseConnection::getInstance();
-    pqxx::nontransaction nt(*db.getConnection());
+    ConnectionLease lease = db.acquire();
+    TracedNontransaction nt(*lease, "Player::exists");
     const pqxx::result r = nt.exec("SELECT 1 FROM public.players WHERE id = " + std::to_string(player_id));
     return !r.empty();
 }
@@ -15,8 +19,8 @@ void Player::addPlayer(const std::string& first_name, const std::string& last_na
         std::cout << "Names should contain only letters." << '\n';
         return;
     }
-    if (first_name.length() > 25 || last_name.length() > 25) {
-        std::cout << "Names should have maximum 25 letters." << '\n';
+    if (first_name.length() > MAX_NAME_LENGTH || last_name.length() > MAX_NAME_LENGTH) {
+        std::cout << "Names should have maximum " << MAX_NAME_LENGTH << " letters." << '\n';
         return;
     }
 
@@ -25,10 +29,12 @@ void Player::addPlayer(const std::string& first_name, const std::string& last_na
     DatabaseConnection& db = DatabaseConnection::getInstance();
 
     try {
-        std::string query = "INSERT INTO public.players (first_name, last_name) VALUES ('" + formatted_first_name + "', '" + formatted_last_name + "');";
-        pqxx::work w(*db.getConnection());
-        w.exec(query);
+        std::string query = "INSERT INTO public.players (first_name, last_name) VALUES ('" + formatted_first_name + "', '" + formatted_last_name + "') RETURNING id;";
+        ConnectionLease lease = db.acquire();
+        TracedWork w(*lease, "Player::addPlayer");
+        const int player_id = w.exec(query)[0][0].as<int>();
         w.commit();
+        PlayerSearchIndex::getInstance().add(player_id, formatted_first_name, formatted_last_name);
         std::cout << "Player added successfully.\n";
     } catch (const pqxx::sql_error& e) {
         std::cerr << "SQL error: " << e.what() << '\n';
@@ -39,35 +45,21 @@ void Player::addPlayer(const std::string& first_name, const std::string& last_na
 }
 
 void Player::showPlayerStatistics(const int player_id) {
-    DatabaseConnection& db = DatabaseConnection::getInstance();
-    std::string query = "SELECT * FROM public.players";
-
-    if (player_id != -1) {
-        query += " WHERE id = " + std::to_string(player_id);
-    }
+    const KeysetPager pager("SELECT id, first_name, last_name, matches_won, matches_lost FROM public.players", "id",
+        player_id != -1 ? "id = " + std::to_string(player_id) : "");
 
-    query += " ORDER BY id ASC";
-    pqxx::nontransaction nt(*db.getConnection());
-    pqxx::result r = nt.exec(query);
+    TableWriter writer(std::cout, {
+        { "Player ID", 9, true }, { "First Name", 25 }, { "Last Name", 25 }, { "Matches Won", 11, true }, { "Matches Lost", 12, true } });
 
-    if (r.empty()) {
-        std::cout << "No users found.\n";
-    }
-    else {
-        tabulate::Table table;
-        table.add_row({ "Player ID", "First Name", "Last Name", "Matches Won", "Matches Lost" });
-
-        for (const auto& row : r) {
-            table.add_row({
-                row[0].as<std::string>(),
-                row[1].as<std::string>(),
-                row[2].as<std::string>(),
-                std::to_string(row["matches_won"].as<int>()),
-	            std::to_string(row["matches_lost"].as<int>())
-            });
+    pager.run([&writer](const pqxx::result& page) {
+        for (const auto& row : page) {
+            writer.writeRow(row);
         }
+    });
+    writer.finish();
 
-        std::cout << table << '\n';
+    if (writer.getRowCount() == 0) {
+        std::cout << "No users found.\n";
     }
 }
 
@@ -75,7 +67,8 @@ void Player::updateMatchResults(const int winner_id, const int loser_id) {
     DatabaseConnection& db = DatabaseConnection::getInstance();
 
     try {
-        pqxx::work w(*db.getConnection());
+        ConnectionLease lease = db.acquire();
+        TracedWork w(*lease, "Player::updateMatchResults");
         std::string queryWinner = "UPDATE public.players SET matches_won = matches_won + 1 WHERE id = " + std::to_string(winner_id) + ";";
         w.exec(queryWinner);
         std::string queryLoser = "UPDATE public.players SET matches_lost = matches_lost + 1 WHERE id = " + std::to_string(loser_id) + ";";
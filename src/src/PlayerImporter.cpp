@@ -0,0 +1,163 @@
+#include "PlayerImporter.hpp"
+#include "DatabaseConnection.hpp"
+#include "DelimitedFile.hpp"
+#include "PlayerSearchIndex.hpp"
+#include "validate.hpp"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <thread>
+
+ImportReport PlayerImporter::importFile(const std::string& path, const unsigned threads) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        ImportReport report;
+        report.errors.push_back(ImportError{ 0, "Cannot open " + path + "." });
+        return report;
+    }
+    return importStream(file, threads);
+}
+
+ImportReport PlayerImporter::importStream(std::istream& in, const unsigned threads) {
+    const auto start = std::chrono::steady_clock::now();
+    ImportReport report;
+    std::vector<DelimitedRecord> records = DelimitedFile::read(in);
+
+    std::size_t first_column = 0;
+    std::size_t last_column = 1;
+    std::size_t begin = 0;
+    if (!records.empty()) {
+        const auto first = DelimitedFile::findColumn(records.front().fields, { "first_name", "first name", "first" });
+        const auto last = DelimitedFile::findColumn(records.front().fields, { "last_name", "last name", "last" });
+        if (first && last) {
+            first_column = *first;
+            last_column = *last;
+            begin = 1;
+        }
+    }
+
+    std::vector<Row> rows;
+    rows.reserve(records.size() - begin);
+    for (std::size_t i = begin; i < records.size(); ++i) {
+        std::vector<std::string>& fields = records[i].fields;
+        Row row;
+        row.line = records[i].line;
+        if (fields.size() <= std::max(first_column, last_column)) {
+            row.error = "Expected first and last name.";
+        }
+        else {
+            row.first_name = std::move(fields[first_column]);
+            row.last_name = std::move(fields[last_column]);
+        }
+        rows.push_back(std::move(row));
+    }
+
+    report.rows_read = rows.size();
+    validate(rows, threads);
+
+    for (const auto& row : rows) {
+        if (!row.error.empty()) {
+            report.errors.push_back(ImportError{ row.line, row.error });
+        }
+    }
+    if (report.errors.size() < rows.size()) {
+        report.is_committed = load(rows, report);
+    }
+
+    report.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    return report;
+}
+
+void PlayerImporter::printReport(const ImportReport& report, const std::size_t max_errors) {
+    for (std::size_t i = 0; i < report.errors.size() && i < max_errors; ++i) {
+        const ImportError& error = report.errors[i];
+        std::cout << (error.line == 0 ? std::string("Import") : "Line " + std::to_string(error.line)) << ": " << error.message << '\n';
+    }
+    if (report.errors.size() > max_errors) {
+        std::cout << "... and " << report.errors.size() - max_errors << " more rejected rows.\n";
+    }
+    std::cout << "Imported " << report.imported << " of " << report.rows_read << " players in " << report.elapsed.count() << " ms.\n";
+}
+
+// Same rules as Player::addPlayer: letters only, at most MAX_NAME_LENGTH, stored via formatName.
+std::string PlayerImporter::normalize(const std::string& name, const char* field, std::string& error) {
+    const std::string trimmed = DelimitedFile::trim(name);
+    if (trimmed.empty()) {
+        error = std::string(field) + " is empty.";
+    }
+    else if (!isAlpha(trimmed)) {
+        error = std::string(field) + " '" + trimmed + "' should contain only letters.";
+    }
+    else if (trimmed.length() > MAX_NAME_LENGTH) {
+        error = std::string(field) + " '" + trimmed + "' is longer than " + std::to_string(MAX_NAME_LENGTH) + " letters.";
+    }
+    return error.empty() ? formatName(trimmed) : "";
+}
+
+void PlayerImporter::validate(std::vector<Row>& rows, const unsigned threads) {
+    const unsigned hardware_threads = std::max(1u, std::thread::hardware_concurrency());
+    const std::size_t thread_count = std::min<std::size_t>(threads == 0 ? hardware_threads : threads, std::max<std::size_t>(1, rows.size() / 1024));
+    const std::size_t chunk = (rows.size() + thread_count - 1) / thread_count;
+
+    const auto validateRange = [&rows](const std::size_t begin, const std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            Row& row = rows[i];
+            if (!row.error.empty()) {
+                continue;
+            }
+            row.first_name = normalize(row.first_name, "First name", row.error);
+            if (row.error.empty()) {
+                row.last_name = normalize(row.last_name, "Last name", row.error);
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(thread_count);
+    for (std::size_t i = 1; i < thread_count; ++i) {
+        workers.emplace_back(validateRange, std::min(rows.size(), i * chunk), std::min(rows.size(), (i + 1) * chunk));
+    }
+    validateRange(0, std::min(rows.size(), chunk));
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+bool PlayerImporter::load(const std::vector<Row>& rows, ImportReport& report) {
+    try {
+        ConnectionLease lease = DatabaseConnection::getInstance().acquire();
+        pqxx::work txn(*lease);
+        txn.exec("CREATE TEMP TABLE players_import (first_name text, last_name text) ON COMMIT DROP");
+        pqxx::stream_to stream = pqxx::stream_to::table(txn, { "players_import" }, { "first_name", "last_name" });
+
+        std::size_t imported = 0;
+        for (const auto& row : rows) {
+            if (row.error.empty()) {
+                stream.write_values(row.first_name, row.last_name);
+                ++imported;
+            }
+        }
+        stream.complete();
+        // COPY cannot return the generated ids, so the rows are staged and moved over with RETURNING for the search index.
+        const pqxx::result added = txn.exec(
+            "INSERT INTO public.players (first_name, last_name) SELECT first_name, last_name FROM players_import "
+            "RETURNING id, first_name, last_name");
+        txn.commit();
+        report.imported = imported;
+
+        PlayerSearchIndex& search_index = PlayerSearchIndex::getInstance();
+        for (const auto& row : added) {
+            search_index.add(row[0].as<int>(), row[1].as<std::string>(), row[2].as<std::string>());
+        }
+        return true;
+    }
+    catch (const pqxx::sql_error& e) {
+        std::cerr << "SQL error while importing players: " << e.what() << '\n';
+        report.errors.push_back(ImportError{ 0, std::string("Database rejected the import: ") + e.what() });
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Exception while importing players: " << e.what() << '\n';
+        report.errors.push_back(ImportError{ 0, std::string("Import failed: ") + e.what() });
+    }
+    return false;
+}
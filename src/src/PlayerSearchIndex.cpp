@@ -0,0 +1,426 @@
+#include "PlayerSearchIndex.hpp"
+#include "DatabaseConnection.hpp"
+#include "validate.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <numeric>
+#include <tuple>
+#include <utility>
+
+PlayerSearchIndex& PlayerSearchIndex::getInstance() {
+    static PlayerSearchIndex instance;
+    return instance;
+}
+
+bool PlayerSearchIndex::load(const std::size_t fetch_size) {
+    std::vector<std::tuple<int, std::string, std::string>> players;
+
+    try {
+        ConnectionLease lease = DatabaseConnection::getInstance().acquire();
+        pqxx::work txn(*lease);
+        txn.exec("DECLARE player_search_cursor NO SCROLL CURSOR FOR SELECT id, first_name, last_name FROM public.players");
+
+        const std::string fetch = "FETCH FORWARD " + std::to_string(fetch_size) + " FROM player_search_cursor";
+        while (true) {
+            const pqxx::result batch = txn.exec(fetch);
+            for (const auto& row : batch) {
+                players.emplace_back(row["id"].as<int>(), row["first_name"].as<std::string>(), row["last_name"].as<std::string>());
+            }
+            if (static_cast<std::size_t>(batch.size()) < fetch_size) {
+                break;
+            }
+        }
+
+        txn.exec("CLOSE player_search_cursor");
+        txn.commit();
+    }
+    catch (const pqxx::sql_error& e) {
+        std::cerr << "SQL error while loading player search index: " << e.what() << '\n';
+        return false;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Exception while loading player search index: " << e.what() << '\n';
+        return false;
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    players_.clear();
+    by_id_.clear();
+    tokens_.clear();
+    tokens_by_length_.clear();
+    deletes_.clear();
+    pending_deletes_.clear();
+    // Inserting in rank order leaves every posting list sorted without per-insert shifting.
+    std::sort(players.begin(), players.end(), [](const auto& a, const auto& b) {
+        return std::tie(std::get<2>(a), std::get<1>(a), std::get<0>(a)) < std::tie(std::get<2>(b), std::get<1>(b), std::get<0>(b));
+    });
+    players_.reserve(players.size());
+    by_id_.reserve(players.size());
+    for (auto& [player_id, first_name, last_name] : players) {
+        insert(player_id, std::move(first_name), std::move(last_name));
+    }
+    mergePendingDeletes();
+    return true;
+}
+
+void PlayerSearchIndex::add(const int player_id, const std::string& first_name, const std::string& last_name) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    insert(player_id, formatName(first_name), formatName(last_name));
+    if (pending_deletes_.size() > MAX_PENDING_DELETES) {
+        mergePendingDeletes();
+    }
+}
+
+std::size_t PlayerSearchIndex::size() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return players_.size();
+}
+
+// Caller holds mutex_ exclusively.
+void PlayerSearchIndex::insert(const int player_id, std::string first_name, std::string last_name) {
+    if (by_id_.count(player_id) != 0) {
+        return;
+    }
+
+    const std::vector<std::string> first_tokens = tokenize(first_name);
+    const std::vector<std::string> last_tokens = tokenize(last_name);
+    const std::uint32_t first_token = internToken(first_tokens.empty() ? "" : first_tokens.front(), pending_deletes_);
+    const std::uint32_t last_token = internToken(last_tokens.empty() ? "" : last_tokens.front(), pending_deletes_);
+
+    const auto position = static_cast<std::uint32_t>(players_.size());
+    players_.push_back(IndexedPlayer{ player_id, std::move(first_name), std::move(last_name), first_token, last_token });
+    by_id_.emplace(player_id, position);
+    link(tokens_[first_token].players, Posting{ position, last_token });
+    if (last_token != first_token) {
+        link(tokens_[last_token].players, Posting{ position, first_token });
+    }
+}
+
+// Posting lists stay in rank order (last name, first name, ID) so a single-word search can stop after a page per token.
+void PlayerSearchIndex::link(std::vector<Posting>& postings, const Posting posting) const {
+    if (postings.empty() || isRankedBefore(postings.back().position, posting.position)) {
+        postings.push_back(posting);
+        return;
+    }
+    postings.insert(std::upper_bound(postings.begin(), postings.end(), posting,
+        [this](const Posting& a, const Posting& b) { return isRankedBefore(a.position, b.position); }), posting);
+}
+
+bool PlayerSearchIndex::isRankedBefore(const std::uint32_t a, const std::uint32_t b) const {
+    const IndexedPlayer& pa = players_[a];
+    const IndexedPlayer& pb = players_[b];
+    return std::tie(pa.last_name, pa.first_name, pa.player_id) < std::tie(pb.last_name, pb.first_name, pb.player_id);
+}
+
+std::uint32_t PlayerSearchIndex::internToken(const std::string& text, std::vector<DeleteEntry>& deletes) {
+    if (tokens_by_length_.size() <= text.size()) {
+        tokens_by_length_.resize(text.size() + 1);
+    }
+    auto& same_length = tokens_by_length_[text.size()];
+    const auto existing = same_length.find(text);
+    if (existing != same_length.end()) {
+        return existing->second;
+    }
+
+    const auto token_id = static_cast<std::uint32_t>(tokens_.size());
+    tokens_.push_back(Token{ text, {} });
+    same_length.emplace(text, token_id);
+    if (text.size() + 1 >= MIN_TYPO_LENGTH) {
+        for (const std::uint64_t variant : deletionVariants(text)) {
+            deletes.emplace_back(variant, token_id);
+        }
+    }
+    return token_id;
+}
+
+void PlayerSearchIndex::mergePendingDeletes() {
+    const auto middle = static_cast<std::ptrdiff_t>(deletes_.size());
+    std::sort(pending_deletes_.begin(), pending_deletes_.end());
+    deletes_.insert(deletes_.end(), pending_deletes_.begin(), pending_deletes_.end());
+    std::inplace_merge(deletes_.begin(), deletes_.begin() + middle, deletes_.end());
+    pending_deletes_.clear();
+}
+
+// Lower-case runs of letters, matching how formatName-normalized names compare.
+std::vector<std::string> PlayerSearchIndex::tokenize(const std::string& text) {
+    std::vector<std::string> tokens;
+    std::string current;
+    for (const char c : text) {
+        if (std::isalpha(static_cast<unsigned char>(c))) {
+            current += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        }
+        else if (!current.empty()) {
+            tokens.push_back(std::move(current));
+            current.clear();
+        }
+    }
+    if (!current.empty()) {
+        tokens.push_back(std::move(current));
+    }
+    return tokens;
+}
+
+// FNV-1a hashes of the token and of every string made by deleting one character. Collisions only add candidates,
+// which editDistance then rejects.
+std::vector<std::uint64_t> PlayerSearchIndex::deletionVariants(const std::string& token) {
+    std::vector<std::uint64_t> variants;
+    variants.reserve(token.size() + 1);
+    for (std::size_t skip = 0; skip <= token.size(); ++skip) {
+        std::uint64_t hash = 14695981039346656037ULL;
+        for (std::size_t i = 0; i < token.size(); ++i) {
+            if (i != skip) {
+                hash = (hash ^ static_cast<unsigned char>(token[i])) * 1099511628211ULL;
+            }
+        }
+        variants.push_back(hash);
+    }
+    std::sort(variants.begin(), variants.end());
+    variants.erase(std::unique(variants.begin(), variants.end()), variants.end());
+    return variants;
+}
+
+int PlayerSearchIndex::editDistance(const std::string& a, const std::string& b, const int max_distance) {
+    const int n = static_cast<int>(a.size());
+    const int m = static_cast<int>(b.size());
+    if (std::abs(n - m) > max_distance) {
+        return max_distance + 1;
+    }
+
+    // Three rolling rows: two back (for transpositions), previous and current. Names fit the stack buffer.
+    int stack_rows[3 * (MAX_STACK_LENGTH + 1)];
+    std::vector<int> heap_rows;
+    if (m > MAX_STACK_LENGTH) {
+        heap_rows.resize(3 * (m + 1));
+    }
+    int* before = m > MAX_STACK_LENGTH ? heap_rows.data() : stack_rows;
+    int* previous = before + m + 1;
+    int* current = previous + m + 1;
+    for (int j = 0; j <= m; ++j) {
+        previous[j] = j;
+    }
+    for (int i = 1; i <= n; ++i) {
+        current[0] = i;
+        int row_min = current[0];
+        for (int j = 1; j <= m; ++j) {
+            const int cost = a[i - 1] == b[j - 1] ? 0 : 1;
+            current[j] = std::min({ previous[j] + 1, current[j - 1] + 1, previous[j - 1] + cost });
+            if (i > 1 && j > 1 && a[i - 1] == b[j - 2] && a[i - 2] == b[j - 1]) {
+                current[j] = std::min(current[j], before[j - 2] + 1);
+            }
+            row_min = std::min(row_min, current[j]);
+        }
+        if (row_min > max_distance) {
+            return max_distance + 1;
+        }
+        std::swap(before, previous);
+        std::swap(previous, current);
+    }
+    return previous[m];
+}
+
+int PlayerSearchIndex::scoreToken(const std::string& token, const std::string& word) {
+    if (token.compare(0, word.size(), word) == 0) {
+        return token.size() == word.size() ? EXACT_SCORE : PREFIX_SCORE - static_cast<int>(token.size() - word.size());
+    }
+    if (word.size() >= MIN_TYPO_LENGTH && editDistance(token, word, 1) == 1) {
+        return TYPO_SCORE;
+    }
+    return 0;
+}
+
+// Tokens one edit from the word that are not already prefix matches.
+std::vector<std::uint32_t> PlayerSearchIndex::findTypos(const std::string& word) const {
+    std::vector<std::uint32_t> candidates;
+    const auto collect = [&candidates](const auto begin, const auto end, const std::uint64_t variant) {
+        for (auto it = begin; it != end; ++it) {
+            if (it->first == variant) {
+                candidates.push_back(it->second);
+            }
+        }
+    };
+    for (const std::uint64_t variant : deletionVariants(word)) {
+        const auto range = std::equal_range(deletes_.begin(), deletes_.end(), DeleteEntry{ variant, 0 },
+            [](const DeleteEntry& a, const DeleteEntry& b) { return a.first < b.first; });
+        collect(range.first, range.second, variant);
+        collect(pending_deletes_.begin(), pending_deletes_.end(), variant);
+    }
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+    std::vector<std::uint32_t> typos;
+    for (const std::uint32_t token_id : candidates) {
+        if (scoreToken(tokens_[token_id].text, word) == TYPO_SCORE) {
+            typos.push_back(token_id);
+        }
+    }
+    return typos;
+}
+
+// Every token the word matches with its score, unless there are more than max_tokens of them.
+bool PlayerSearchIndex::collectMatches(const std::string& word, const std::size_t max_tokens, WordMatches& matches) const {
+    std::vector<std::pair<std::uint32_t, int>> scores;
+    for (std::size_t length = word.size(); length < tokens_by_length_.size(); ++length) {
+        const auto& same_length = tokens_by_length_[length];
+        const int score = length == word.size() ? EXACT_SCORE : PREFIX_SCORE - static_cast<int>(length - word.size());
+        for (auto it = same_length.lower_bound(word); it != same_length.end() && it->first.compare(0, word.size(), word) == 0; ++it) {
+            if (scores.size() == max_tokens) {
+                return false;
+            }
+            scores.emplace_back(it->second, score);
+            matches.postings += tokens_[it->second].players.size();
+        }
+    }
+    if (word.size() >= MIN_TYPO_LENGTH) {
+        for (const std::uint32_t token_id : findTypos(word)) {
+            scores.emplace_back(token_id, TYPO_SCORE);
+            matches.postings += tokens_[token_id].players.size();
+        }
+    }
+    matches.build(scores);
+    return true;
+}
+
+void PlayerSearchIndex::WordMatches::build(const std::vector<std::pair<std::uint32_t, int>>& scores) {
+    std::size_t capacity = 16;
+    while (capacity < 2 * scores.size()) {
+        capacity *= 2;
+    }
+    slots.assign(capacity, { 0, 0 });
+    for (const auto& [token_id, score] : scores) {
+        std::size_t slot = (token_id * 0x9E3779B1u) & (capacity - 1);
+        while (slots[slot].first != 0) {
+            slot = (slot + 1) & (capacity - 1);
+        }
+        slots[slot] = { token_id + 1, score };
+    }
+}
+
+int PlayerSearchIndex::WordMatches::scoreOf(const std::uint32_t token_id) const {
+    const std::size_t mask = slots.size() - 1;
+    for (std::size_t slot = (token_id * 0x9E3779B1u) & mask; slots[slot].first != 0; slot = (slot + 1) & mask) {
+        if (slots[slot].first == token_id + 1) {
+            return slots[slot].second;
+        }
+    }
+    return 0;
+}
+
+std::vector<PlayerMatch> PlayerSearchIndex::search(const std::string& query, const std::size_t limit) const {
+    const std::vector<std::string> words = tokenize(query);
+    if (words.empty() || limit == 0) {
+        return {};
+    }
+
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    // One word supplies the candidates and the others score them through the tokens they match; the word with the
+    // fewest postings drives. Collecting a word costs about as much per token as comparing names costs per candidate,
+    // so a word matching more tokens than the driver has postings (a one-letter initial, say) compares names instead.
+    std::vector<std::size_t> order(words.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&words](const std::size_t a, const std::size_t b) { return words[a].size() > words[b].size(); });
+    std::size_t driver = order.front();
+    std::vector<WordMatches> matches(words.size());
+    if (words.size() > 1) {
+        std::size_t max_tokens = MAX_WORD_TOKENS;
+        for (const std::size_t i : order) {
+            matches[i].is_complete = collectMatches(words[i], max_tokens, matches[i]);
+            if (matches[i].is_complete && (!matches[driver].is_complete || matches[i].postings < matches[driver].postings)) {
+                driver = i;
+            }
+            if (matches[driver].is_complete) {
+                max_tokens = std::min(MAX_WORD_TOKENS, matches[driver].postings);
+            }
+        }
+    }
+    const std::string& driver_word = words[driver];
+
+    int others_max = 0;
+    for (std::size_t i = 0; i < words.size(); ++i) {
+        if (i != driver) {
+            const bool is_known = words[i].size() < tokens_by_length_.size() && tokens_by_length_[words[i].size()].count(words[i]) != 0;
+            others_max += is_known ? EXACT_SCORE : PREFIX_SCORE - 1;
+        }
+    }
+
+    const auto byRank = [this](const std::pair<int, std::uint32_t>& a, const std::pair<int, std::uint32_t>& b) {
+        return a.first != b.first ? a.first > b.first : isRankedBefore(a.second, b.second);
+    };
+
+    const auto scoreFor = [&](const std::uint32_t token_id, const std::size_t word) {
+        if (!matches[word].is_complete) {
+            return scoreToken(tokens_[token_id].text, words[word]);
+        }
+        return matches[word].scoreOf(token_id);
+    };
+
+    std::vector<std::pair<int, std::uint32_t>> ranked;
+    const auto addToken = [&](const std::uint32_t token_id, const int token_score) {
+        // With one word every player of a token scores the same, and postings are in rank order, so a page is enough.
+        std::size_t accepted = 0;
+        for (const Posting& posting : tokens_[token_id].players) {
+            if (words.size() == 1 && accepted == limit) {
+                break;
+            }
+            // A player whose other name matches the driver word at least as well is counted from that token instead.
+            if (posting.other_token != token_id) {
+                const int other_score = scoreFor(posting.other_token, driver);
+                if (other_score > token_score || (other_score == token_score && players_[posting.position].first_token == posting.other_token)) {
+                    continue;
+                }
+            }
+
+            int total = token_score;
+            for (std::size_t i = 0; i < words.size() && total > 0; ++i) {
+                if (i != driver) {
+                    const int score = std::max(scoreFor(token_id, i), scoreFor(posting.other_token, i));
+                    total = score == 0 ? 0 : total + score;
+                }
+            }
+            if (total > 0) {
+                ranked.emplace_back(total, posting.position);
+                ++accepted;
+            }
+        }
+    };
+    // Groups arrive best score first; once the page is full and the next group cannot beat its last entry, stop.
+    const auto isPageFinal = [&](const int next_score) {
+        if (ranked.size() < limit) {
+            return false;
+        }
+        // Only the page's lowest score matters here, so ties need not be broken by name.
+        std::nth_element(ranked.begin(), ranked.begin() + (limit - 1), ranked.end(),
+            [](const std::pair<int, std::uint32_t>& a, const std::pair<int, std::uint32_t>& b) { return a.first > b.first; });
+        return ranked[limit - 1].first > next_score + others_max;
+    };
+
+    bool is_final = false;
+    for (std::size_t length = driver_word.size(); length < tokens_by_length_.size() && !is_final; ++length) {
+        const auto& same_length = tokens_by_length_[length];
+        const int score = length == driver_word.size() ? EXACT_SCORE : PREFIX_SCORE - static_cast<int>(length - driver_word.size());
+        for (auto it = same_length.lower_bound(driver_word); it != same_length.end() && it->first.compare(0, driver_word.size(), driver_word) == 0; ++it) {
+            addToken(it->second, score);
+        }
+        const int next_score = length + 1 < tokens_by_length_.size() ? PREFIX_SCORE - static_cast<int>(length + 1 - driver_word.size()) : TYPO_SCORE;
+        is_final = isPageFinal(std::max(next_score, TYPO_SCORE));
+    }
+    if (!is_final && driver_word.size() >= MIN_TYPO_LENGTH) {
+        for (const std::uint32_t token_id : findTypos(driver_word)) {
+            addToken(token_id, TYPO_SCORE);
+        }
+    }
+
+    const std::size_t count = std::min(limit, ranked.size());
+    std::partial_sort(ranked.begin(), ranked.begin() + count, ranked.end(), byRank);
+
+    std::vector<PlayerMatch> results;
+    results.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        const IndexedPlayer& player = players_[ranked[i].second];
+        results.push_back(PlayerMatch{ player.player_id, player.first_name, player.last_name, ranked[i].first });
+    }
+    return results;
+}
@@ -0,0 +1,142 @@
+#include "PointLog.hpp"
+#include "DatabaseConnection.hpp"
+#include "PersistenceQueue.hpp"
+#include "PreparedStatements.hpp"
+#include "QueryMetrics.hpp"
+#include "ScoringTables.hpp"
+#include <iostream>
+
+PointLog& PointLog::getInstance() {
+    PersistenceQueue::getInstance();
+    static PointLog instance;
+    return instance;
+}
+
+void PointLog::record(const int match_id, const int winner, const bool is_player_one_serving) {
+    const int seq = nextSeq(match_id);
+    PersistenceQueue::getInstance().enqueue(match_id, [=](pqxx::work& txn) {
+        PreparedStatements::exec<InsertPointEventQuery>(txn, match_id, seq, winner, is_player_one_serving);
+    });
+}
+
+// The database is only asked for the last sequence number the first time a match is seen, outside the lock,
+// so a slow lookup for one match never holds up points on another.
+int PointLog::nextSeq(const int match_id) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto found = last_seq_.find(match_id);
+        if (found != last_seq_.end()) {
+            return ++found->second;
+        }
+    }
+
+    int last_seq = 0;
+    try {
+        ConnectionLease lease = DatabaseConnection::getInstance().acquire();
+        TracedNontransaction nt(*lease, "PointLog::nextSeq");
+        const pqxx::result r = nt.exec("SELECT COALESCE(MAX(seq), 0) AS seq FROM public.point_events WHERE match_id = "
+            + nt.quote(match_id) + ";");
+        last_seq = r[0]["seq"].as<int>();
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Exception while reading point log for match " << match_id << ": " << e.what() << '\n';
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    return ++last_seq_.emplace(match_id, last_seq).first->second;
+}
+
+void PointLog::setLastSeq(const int match_id, const int seq) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    last_seq_[match_id] = seq;
+}
+
+std::vector<PointEvent> PointLog::load(const int match_id) {
+    std::vector<PointEvent> events;
+    try {
+        ConnectionLease lease = DatabaseConnection::getInstance().acquire();
+        TracedNontransaction nt(*lease, "PointLog::load");
+        const pqxx::result r = nt.exec("SELECT seq, winner, is_player_one_serving FROM public.point_events "
+            "WHERE match_id = " + nt.quote(match_id) + " ORDER BY seq;");
+
+        events.reserve(r.size());
+        for (const auto& row : r) {
+            events.push_back(PointEvent{ row["seq"].as<int>(), row["winner"].as<int>(), row["is_player_one_serving"].as<bool>() });
+        }
+    }
+    catch (const pqxx::sql_error& e) {
+        std::cerr << "SQL error while loading point log: " << e.what() << '\n';
+        std::cerr << "Query was: " << e.query() << '\n';
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Exception while loading point log: " << e.what() << '\n';
+    }
+    return events;
+}
+
+MatchScore PointLog::replay(const int no_sets, const std::vector<PointEvent>& events) {
+    MatchScore score;
+    score.no_sets = no_sets;
+    if (!events.empty()) {
+        score.is_player_one_serving = events.front().is_player_one_serving;
+    }
+
+    for (const auto& event : events) {
+        if (ScoringTables::scorePoint(score, event.winner).has(INVALID_POINT)) {
+            std::cerr << "Point " << event.seq << " could not be replayed.\n";
+            break;
+        }
+    }
+    return score;
+}
+
+std::optional<MatchScore> PointLog::replayMatch(const int match_id, const int no_sets) {
+    PersistenceQueue::getInstance().flush();
+    const std::vector<PointEvent> events = load(match_id);
+    if (events.empty()) {
+        return std::nullopt;
+    }
+    return replay(no_sets, events);
+}
+
+// Rows arrive ordered by match, so each match is replayed in a single pass with no per-match queries.
+std::unordered_map<int, CompactScore> PointLog::replayAll() {
+    std::unordered_map<int, CompactScore> scores;
+    PersistenceQueue::getInstance().flush();
+
+    try {
+        ConnectionLease lease = DatabaseConnection::getInstance().acquire();
+        pqxx::nontransaction nt(*lease);
+        const pqxx::result r = nt.exec(
+            "SELECT p.match_id, m.no_sets, p.winner, p.is_player_one_serving "
+            "FROM public.point_events p JOIN public.matches m ON m.id = p.match_id "
+            "ORDER BY p.match_id, p.seq;");
+
+        int current_match_id = -1;
+        MatchScore score;
+        for (const auto& row : r) {
+            const int match_id = row[0].as<int>();
+            if (match_id != current_match_id) {
+                if (current_match_id != -1) {
+                    scores.emplace(current_match_id, CompactScore::fromMatchScore(score));
+                }
+                current_match_id = match_id;
+                score = MatchScore();
+                score.no_sets = row[1].as<int>();
+                score.is_player_one_serving = row[3].as<bool>();
+            }
+            ScoringTables::scorePoint(score, row[2].as<int>());
+        }
+        if (current_match_id != -1) {
+            scores.emplace(current_match_id, CompactScore::fromMatchScore(score));
+        }
+    }
+    catch (const pqxx::sql_error& e) {
+        std::cerr << "SQL error while replaying point log: " << e.what() << '\n';
+        std::cerr << "Query was: " << e.query() << '\n';
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Exception while replaying point log: " << e.what() << '\n';
+    }
+    return scores;
+}
@@ -0,0 +1,191 @@
+#include "PointNotifyListener.hpp"
+#include "DatabaseConnection.hpp"
+#include "LiveScoreCache.hpp"
+#include "PointLog.hpp"
+#include "ReferenceData.hpp"
+#include "ScoreEventBus.hpp"
+#include "ScoringTables.hpp"
+#include <chrono>
+#include <iostream>
+#include <sstream>
+
+class PointNotifyReceiver : public pqxx::notification_receiver {
+public:
+    using Handler = void (PointNotifyListener::*)(const std::string&);
+
+    PointNotifyReceiver(pqxx::connection& conn, const char* channel, PointNotifyListener& listener, const Handler handler)
+        : pqxx::notification_receiver(conn, channel), listener_(listener), handler_(handler) {}
+
+    void operator()(const std::string& payload, int) override { (listener_.*handler_)(payload); }
+
+private:
+    PointNotifyListener& listener_;
+    Handler handler_;
+};
+
+PointNotifyListener::PointNotifyListener(std::function<bool(int)> is_local) : is_local_(std::move(is_local)) {
+}
+
+PointNotifyListener::~PointNotifyListener() {
+    stop();
+}
+
+void PointNotifyListener::start() {
+    if (is_running_.exchange(true)) {
+        return;
+    }
+    worker_ = std::thread(&PointNotifyListener::run, this);
+}
+
+void PointNotifyListener::stop() {
+    is_running_ = false;
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+// Waits in one-second slices so stop() never blocks for long; a lost connection is retried and every replica is
+// dropped, since notifications sent while disconnected are gone.
+void PointNotifyListener::run() {
+    while (is_running_) {
+        std::unique_ptr<pqxx::connection> conn = DatabaseConnection::initializeConnection();
+        if (!conn) {
+            std::this_thread::sleep_for(std::chrono::seconds(1));
+            continue;
+        }
+
+        try {
+            PointNotifyReceiver points(*conn, CHANNEL, *this, &PointNotifyListener::onNotification);
+            PointNotifyReceiver statuses(*conn, STATUS_CHANNEL, *this, &PointNotifyListener::onStatusNotification);
+            while (is_running_) {
+                conn->await_notification(1, 0);
+            }
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Exception while listening for point events: " << e.what() << '\n';
+            replicas_.clear();
+        }
+    }
+}
+
+void PointNotifyListener::onNotification(const std::string& payload) {
+    std::istringstream fields(payload);
+    int match_id = 0;
+    int seq = 0;
+    int winner = 0;
+    char separator = 0;
+    if (!(fields >> match_id >> separator >> seq >> separator >> winner)) {
+        std::cerr << "Malformed point event: " << payload << '\n';
+        return;
+    }
+    if (is_local_ && is_local_(match_id)) {
+        return;
+    }
+    apply(match_id, seq, winner);
+}
+
+// Local matches are skipped as for points, since CourtServer already records their status. A match this process has
+// not cached yet is loaded once it is started or suspended, even before its first point.
+void PointNotifyListener::onStatusNotification(const std::string& payload) {
+    std::istringstream fields(payload);
+    int match_id = 0;
+    int status_id = 0;
+    char separator = 0;
+    if (!(fields >> match_id >> separator >> status_id)) {
+        std::cerr << "Malformed match status event: " << payload << '\n';
+        return;
+    }
+    if (is_local_ && is_local_(match_id)) {
+        return;
+    }
+
+    const ReferenceData& reference = ReferenceData::getInstance();
+    if (status_id == reference.getStatusId("Finished") || status_id == reference.getStatusId("Suspended")) {
+        replicas_.erase(match_id);
+    }
+    if (LiveScoreCache::getInstance().setStatus(match_id, status_id)) {
+        return;
+    }
+    if (status_id == reference.getStatusId("Started") || status_id == reference.getStatusId("Suspended")) {
+        std::optional<Replica> replica = load(match_id);
+        if (replica) {
+            replicas_[match_id] = *replica;
+        }
+    }
+}
+
+void PointNotifyListener::apply(const int match_id, const int seq, const int winner) {
+    const auto found = replicas_.find(match_id);
+    if (found != replicas_.end() && seq <= found->second.last_seq) {
+        return;
+    }
+
+    if (found == replicas_.end() || seq != found->second.last_seq + 1) {
+        std::optional<Replica> replica = load(match_id);
+        if (!replica) {
+            return;
+        }
+        replicas_[match_id] = *replica;
+        ScoreEventBus::getInstance().publish(match_id, CompactScore::fromMatchScore(replica->score), NO_EVENT);
+        return;
+    }
+
+    Replica& replica = found->second;
+    const PointResult result = ScoringTables::scorePoint(replica.score, winner);
+    replica.last_seq = seq;
+    if (result.has(INVALID_POINT)) {
+        replicas_.erase(found);
+        return;
+    }
+    const CompactScore score = CompactScore::fromMatchScore(replica.score);
+    const int status_id = score.isFinished() ? ReferenceData::getInstance().getStatusId("Finished") : 0;
+    LiveScoreCache::getInstance().update(match_id, score, status_id);
+    ScoreEventBus::getInstance().publish(match_id, score, result.events);
+    if (replica.score.isFinished()) {
+        replicas_.erase(found);
+    }
+}
+
+// Also (re)seeds the live score cache, since this may be the first this process hears of the match.
+std::optional<PointNotifyListener::Replica> PointNotifyListener::load(const int match_id) {
+    int no_sets = 0;
+    LiveMatch live;
+    live.match_id = match_id;
+    try {
+        ConnectionLease lease = DatabaseConnection::getInstance().acquire();
+        pqxx::nontransaction nt(*lease);
+        const pqxx::result r = nt.exec(
+            "SELECT m.status_id, m.no_sets, m.player_id1, m.player_id2, "
+            "p1.first_name || ' ' || p1.last_name AS player1_name, p2.first_name || ' ' || p2.last_name AS player2_name "
+            "FROM public.matches m "
+            "JOIN public.players p1 ON m.player_id1 = p1.id "
+            "JOIN public.players p2 ON m.player_id2 = p2.id "
+            "WHERE m.id = " + nt.quote(match_id) + ";");
+        if (r.empty()) {
+            return std::nullopt;
+        }
+        no_sets = r[0]["no_sets"].as<int>();
+        live.status_id = r[0]["status_id"].as<int>();
+        live.player_id1 = r[0]["player_id1"].as<int>();
+        live.player_id2 = r[0]["player_id2"].as<int>();
+        live.player1_name = r[0]["player1_name"].as<std::string>();
+        live.player2_name = r[0]["player2_name"].as<std::string>();
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Exception while loading match " << match_id << ": " << e.what() << '\n';
+        return std::nullopt;
+    }
+
+    const std::vector<PointEvent> events = PointLog::load(match_id);
+    if (events.empty()) {
+        live.score = CompactScore::start(no_sets, true);
+        LiveScoreCache::getInstance().upsert(live);
+        return std::nullopt;
+    }
+    Replica replica;
+    replica.last_seq = events.back().seq;
+    replica.score = PointLog::replay(no_sets, events);
+    live.score = CompactScore::fromMatchScore(replica.score);
+    LiveScoreCache::getInstance().upsert(live);
+    return replica;
+}
@@ -0,0 +1,13 @@
+#include "PreparedStatements.hpp"
+
+void PreparedStatements::prepareAll(pqxx::connection& conn) {
+    std::apply([&conn](auto... query) {
+        (conn.prepare(decltype(query)::name, decltype(query)::sql), ...);
+    }, All{});
+}
+
+std::vector<std::string_view> PreparedStatements::names() {
+    return std::apply([](auto... query) {
+        return std::vector<std::string_view>{ decltype(query)::name... };
+    }, All{});
+}
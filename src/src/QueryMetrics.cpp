@@ -0,0 +1,303 @@
+#include "QueryMetrics.hpp"
+#include "DatabaseConnection.hpp"
+#include "PersistenceQueue.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+std::atomic<bool> QueryMetrics::is_enabled_{ false };
+
+// Bucket bounds of the Prometheus histograms, in seconds. They are summed from the finer buckets above, so a count
+// may miss values within 3% below its bound.
+static constexpr double PROMETHEUS_BOUNDS[] = { 0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1,
+    0.25, 0.5, 1.0, 2.5, 5.0, 10.0 };
+
+void LatencyHistogram::record(const std::chrono::nanoseconds elapsed) {
+    const std::uint64_t micros = elapsed.count() > 0 ? static_cast<std::uint64_t>(elapsed.count()) / 1000 : 0;
+    buckets_[bucketIndex(micros)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(micros, std::memory_order_relaxed);
+}
+
+std::vector<std::uint64_t> LatencyHistogram::getBuckets() const {
+    std::vector<std::uint64_t> buckets(BUCKETS);
+    for (std::size_t i = 0; i < BUCKETS; ++i) {
+        buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+    }
+    return buckets;
+}
+
+std::size_t LatencyHistogram::bucketIndex(std::uint64_t micros) {
+    if (micros < SUB_BUCKETS) {
+        return static_cast<std::size_t>(micros);
+    }
+    const std::uint64_t max_micros = (1ULL << (MAX_BIT + 1)) - 1;
+    if (micros > max_micros) {
+        micros = max_micros;
+    }
+
+    int bit = 0;
+    for (int step = 32; step > 0; step >>= 1) {
+        if (micros >> (bit + step)) {
+            bit += step;
+        }
+    }
+    const int shift = bit - SUB_BUCKET_BITS;
+    return static_cast<std::size_t>((shift + 1) * SUB_BUCKETS + (micros >> shift) - SUB_BUCKETS);
+}
+
+std::uint64_t LatencyHistogram::bucketLowerBound(const std::size_t index) {
+    if (index < SUB_BUCKETS) {
+        return index;
+    }
+    const std::size_t group = index / SUB_BUCKETS;
+    return (index % SUB_BUCKETS + SUB_BUCKETS) << (group - 1);
+}
+
+std::uint64_t LatencyHistogram::bucketUpperBound(const std::size_t index) {
+    return index < SUB_BUCKETS ? index + 1 : bucketLowerBound(index) + (1ULL << (index / SUB_BUCKETS - 1));
+}
+
+std::chrono::microseconds LatencyHistogram::quantile(const std::vector<std::uint64_t>& buckets, const std::uint64_t count, const double q) {
+    if (count == 0) {
+        return std::chrono::microseconds(0);
+    }
+    const std::uint64_t rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(q * static_cast<double>(count) + 0.5));
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < buckets.size(); ++i) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            return std::chrono::microseconds(bucketUpperBound(i) - 1);
+        }
+    }
+    return std::chrono::microseconds(bucketUpperBound(buckets.size() - 1) - 1);
+}
+
+QueryMetrics& QueryMetrics::getInstance() {
+    static QueryMetrics instance;
+    return instance;
+}
+
+QueryMetrics::~QueryMetrics() {
+    stopDump();
+}
+
+StatementMetrics& QueryMetrics::get(const std::string& name) {
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        const auto found = statements_.find(name);
+        if (found != statements_.end()) {
+            return *found->second;
+        }
+    }
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto& metrics = statements_[name];
+    if (!metrics) {
+        metrics = std::make_unique<StatementMetrics>();
+    }
+    return *metrics;
+}
+
+std::vector<StatementSummary> QueryMetrics::getStatementSummaries() const {
+    std::vector<StatementSummary> summaries;
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    for (const auto& [name, metrics] : statements_) {
+        const std::vector<std::uint64_t> buckets = metrics->statements.getBuckets();
+        std::uint64_t count = 0;
+        for (const std::uint64_t bucket : buckets) {
+            count += bucket;
+        }
+        if (count == 0 && metrics->errors.load(std::memory_order_relaxed) == 0) {
+            continue;
+        }
+
+        StatementSummary summary;
+        summary.name = name;
+        summary.count = count;
+        summary.errors = metrics->errors.load(std::memory_order_relaxed);
+        summary.total = metrics->statements.getSum();
+        summary.p50 = LatencyHistogram::quantile(buckets, count, 0.50);
+        summary.p99 = LatencyHistogram::quantile(buckets, count, 0.99);
+        summary.max = LatencyHistogram::quantile(buckets, count, 1.0);
+        summaries.push_back(std::move(summary));
+    }
+    return summaries;
+}
+
+static std::string escapeLabel(const std::string& value) {
+    std::string escaped;
+    for (const char c : value) {
+        if (c == '\\' || c == '"') {
+            escaped += '\\';
+            escaped += c;
+        }
+        else if (c == '\n') {
+            escaped += "\\n";
+        }
+        else {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+// One histogram series per name. Buckets are copied first, so _count always matches the +Inf bucket.
+static void renderHistogram(std::ostream& out, const std::string& metric, const std::string& label, const std::string& name,
+    const LatencyHistogram& histogram) {
+    const std::vector<std::uint64_t> buckets = histogram.getBuckets();
+    const std::string series = label + "=\"" + escapeLabel(name) + "\"";
+
+    std::size_t index = 0;
+    std::uint64_t cumulative = 0;
+    for (const double bound : PROMETHEUS_BOUNDS) {
+        const double bound_micros = bound * 1e6;
+        while (index < buckets.size() && static_cast<double>(LatencyHistogram::bucketUpperBound(index)) <= bound_micros) {
+            cumulative += buckets[index++];
+        }
+        out << metric << "_bucket{" << series << ",le=\"" << bound << "\"} " << cumulative << '\n';
+    }
+    while (index < buckets.size()) {
+        cumulative += buckets[index++];
+    }
+    out << metric << "_bucket{" << series << ",le=\"+Inf\"} " << cumulative << '\n';
+    out << metric << "_sum{" << series << "} " << static_cast<double>(histogram.getSum().count()) / 1e6 << '\n';
+    out << metric << "_count{" << series << "} " << cumulative << '\n';
+}
+
+std::string QueryMetrics::renderPrometheus() const {
+    std::ostringstream out;
+    out.precision(9);
+
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+
+        out << "# HELP tennapp_db_statement_duration_seconds Time spent executing a statement, by call site or prepared statement.\n"
+            << "# TYPE tennapp_db_statement_duration_seconds histogram\n";
+        for (const auto& [name, metrics] : statements_) {
+            if (metrics->statements.getCount() > 0) {
+                renderHistogram(out, "tennapp_db_statement_duration_seconds", "statement", name, metrics->statements);
+            }
+        }
+
+        out << "# HELP tennapp_db_statement_duration_quantile_seconds Statement latency quantiles, within 3%.\n"
+            << "# TYPE tennapp_db_statement_duration_quantile_seconds gauge\n";
+        for (const auto& [name, metrics] : statements_) {
+            const std::vector<std::uint64_t> buckets = metrics->statements.getBuckets();
+            std::uint64_t count = 0;
+            for (const std::uint64_t bucket : buckets) {
+                count += bucket;
+            }
+            if (count == 0) {
+                continue;
+            }
+            for (const double q : { 0.5, 0.9, 0.99, 0.999, 1.0 }) {
+                out << "tennapp_db_statement_duration_quantile_seconds{statement=\"" << escapeLabel(name) << "\",quantile=\"" << q << "\"} "
+                    << static_cast<double>(LatencyHistogram::quantile(buckets, count, q).count()) / 1e6 << '\n';
+            }
+        }
+
+        out << "# HELP tennapp_db_statement_errors_total Statements that raised an error.\n"
+            << "# TYPE tennapp_db_statement_errors_total counter\n";
+        for (const auto& [name, metrics] : statements_) {
+            if (const std::uint64_t errors = metrics->errors.load(std::memory_order_relaxed)) {
+                out << "tennapp_db_statement_errors_total{statement=\"" << escapeLabel(name) << "\"} " << errors << '\n';
+            }
+        }
+
+        out << "# HELP tennapp_db_transaction_duration_seconds Time from BEGIN to COMMIT or rollback, by call site.\n"
+            << "# TYPE tennapp_db_transaction_duration_seconds histogram\n";
+        for (const auto& [name, metrics] : statements_) {
+            if (metrics->transactions.getCount() > 0) {
+                renderHistogram(out, "tennapp_db_transaction_duration_seconds", "transaction", name, metrics->transactions);
+            }
+        }
+
+        out << "# HELP tennapp_db_transaction_rollbacks_total Transactions that ended without a commit.\n"
+            << "# TYPE tennapp_db_transaction_rollbacks_total counter\n";
+        for (const auto& [name, metrics] : statements_) {
+            if (const std::uint64_t rollbacks = metrics->rollbacks.load(std::memory_order_relaxed)) {
+                out << "tennapp_db_transaction_rollbacks_total{transaction=\"" << escapeLabel(name) << "\"} " << rollbacks << '\n';
+            }
+        }
+    }
+
+    out << "# HELP tennapp_db_round_trips_total Statements, BEGINs and COMMITs sent to the database.\n"
+        << "# TYPE tennapp_db_round_trips_total counter\n"
+        << "tennapp_db_round_trips_total " << getRoundTrips() << '\n';
+
+    const QueueMetrics queue = PersistenceQueue::getInstance().getMetrics();
+    out << "# TYPE tennapp_queue_writes_total counter\n"
+        << "tennapp_queue_writes_total " << queue.enqueued << '\n'
+        << "# TYPE tennapp_queue_coalesced_writes_total counter\n"
+        << "tennapp_queue_coalesced_writes_total " << queue.coalesced << '\n'
+        << "# TYPE tennapp_queue_statements_total counter\n"
+        << "tennapp_queue_statements_total " << queue.statements << '\n'
+        << "# TYPE tennapp_queue_batches_total counter\n"
+        << "tennapp_queue_batches_total " << queue.batches << '\n'
+        << "# TYPE tennapp_queue_failed_batches_total counter\n"
+        << "tennapp_queue_failed_batches_total " << queue.failed_batches << '\n'
+        << "# TYPE tennapp_queue_depth gauge\n"
+        << "tennapp_queue_depth " << queue.depth << '\n'
+        << "# TYPE tennapp_queue_max_depth gauge\n"
+        << "tennapp_queue_max_depth " << queue.max_depth << '\n';
+
+    const PoolMetrics pool = DatabaseConnection::getInstance().getPool().getMetrics();
+    out << "# TYPE tennapp_pool_connections gauge\n"
+        << "tennapp_pool_connections{state=\"open\"} " << pool.open << '\n'
+        << "tennapp_pool_connections{state=\"idle\"} " << pool.idle << '\n'
+        << "# TYPE tennapp_pool_checkouts_total counter\n"
+        << "tennapp_pool_checkouts_total " << pool.checkouts << '\n'
+        << "# TYPE tennapp_pool_blocked_checkouts_total counter\n"
+        << "tennapp_pool_blocked_checkouts_total " << pool.blocked_checkouts << '\n'
+        << "# TYPE tennapp_pool_timeouts_total counter\n"
+        << "tennapp_pool_timeouts_total " << pool.timeouts << '\n'
+        << "# TYPE tennapp_pool_wait_seconds_total counter\n"
+        << "tennapp_pool_wait_seconds_total " << static_cast<double>(pool.total_wait.count()) / 1e6 << '\n';
+    return out.str();
+}
+
+void QueryMetrics::startDump(const std::string& path, const std::chrono::seconds interval) {
+    stopDump();
+    std::lock_guard<std::mutex> lock(dump_mutex_);
+    is_dump_stopping_ = false;
+    dump_thread_ = std::thread([this, path, interval]() {
+        std::unique_lock<std::mutex> dump_lock(dump_mutex_);
+        while (!dump_wakeup_.wait_for(dump_lock, interval, [this]() { return is_dump_stopping_; })) {
+            dump_lock.unlock();
+            writeDump(path);
+            dump_lock.lock();
+        }
+    });
+}
+
+void QueryMetrics::stopDump() {
+    {
+        std::lock_guard<std::mutex> lock(dump_mutex_);
+        is_dump_stopping_ = true;
+    }
+    dump_wakeup_.notify_all();
+    if (dump_thread_.joinable()) {
+        dump_thread_.join();
+    }
+}
+
+// Written beside the target and renamed over it, so a scraper never reads half a file.
+void QueryMetrics::writeDump(const std::string& path) const {
+    const std::string temp_path = path + ".tmp";
+    try {
+        {
+            std::ofstream file(temp_path, std::ios::trunc);
+            file << renderPrometheus();
+            if (!file) {
+                std::cerr << "Cannot write metrics to " << temp_path << '\n';
+                return;
+            }
+        }
+        std::filesystem::rename(temp_path, path);
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Exception while writing metrics to " << path << ": " << e.what() << '\n';
+    }
+}
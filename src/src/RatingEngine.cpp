@@ -0,0 +1,364 @@
+#include "RatingEngine.hpp"
+#include "DatabaseConnection.hpp"
+#include "PersistenceQueue.hpp"
+#include "PreparedStatements.hpp"
+#include "ReferenceData.hpp"
+#include "SqlArray.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <unordered_set>
+
+RatingEngine& RatingEngine::getInstance() {
+    static RatingEngine instance;
+    return instance;
+}
+
+double RatingEngine::expectedScore(const double rating, const double opponent_rating) {
+    return 1.0 / (1.0 + std::pow(10.0, (opponent_rating - rating) / 400.0));
+}
+
+double RatingEngine::kFactor(const RatingParameters& parameters, const int rated_matches) {
+    return rated_matches < parameters.provisional_matches ? parameters.provisional_k_factor : parameters.k_factor;
+}
+
+bool RatingEngine::warm() {
+    RatingParameters parameters;
+    std::unordered_map<int, Entry> players;
+    std::set<RankKey> ranking;
+
+    try {
+        ConnectionLease lease = DatabaseConnection::getInstance().acquire();
+        pqxx::nontransaction nt(*lease);
+
+        const pqxx::result stored = nt.exec(
+            "SELECT initial_rating, k_factor, provisional_k_factor, provisional_matches FROM public.rating_parameters WHERE id = 1;");
+        if (!stored.empty()) {
+            parameters.initial_rating = stored[0]["initial_rating"].as<double>();
+            parameters.k_factor = stored[0]["k_factor"].as<double>();
+            parameters.provisional_k_factor = stored[0]["provisional_k_factor"].as<double>();
+            parameters.provisional_matches = stored[0]["provisional_matches"].as<int>();
+        }
+
+        const pqxx::result r = nt.exec(
+            "SELECT id, first_name || ' ' || last_name AS name, rating, rated_matches FROM public.players;");
+        players.reserve(r.size());
+        for (const auto& row : r) {
+            const int player_id = row["id"].as<int>();
+            Entry entry{ row["name"].as<std::string>(), row["rating"].as<double>(), row["rated_matches"].as<int>() };
+            if (entry.rated_matches > 0) {
+                ranking.insert(RankKey{ entry.rating, player_id });
+            }
+            players.emplace(player_id, std::move(entry));
+        }
+    }
+    catch (const pqxx::sql_error& e) {
+        std::cerr << "SQL error while loading ratings: " << e.what() << '\n';
+        return false;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Exception while loading ratings: " << e.what() << '\n';
+        return false;
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    parameters_ = parameters;
+    players_ = std::move(players);
+    ranking_ = std::move(ranking);
+    return true;
+}
+
+void RatingEngine::recordResult(const int match_id, const int winner_id, const int loser_id) {
+    std::vector<std::pair<int, std::string>> names;
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        for (const int player_id : { winner_id, loser_id }) {
+            if (players_.count(player_id) == 0) {
+                names.emplace_back(player_id, "");
+            }
+        }
+    }
+    // Only players added after warm() need a lookup, and it is done before taking the write lock.
+    for (auto& [player_id, name] : names) {
+        name = loadName(player_id).value_or("Player " + std::to_string(player_id));
+    }
+    if (!names.empty()) {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        for (auto& [player_id, name] : names) {
+            players_.try_emplace(player_id, Entry{ std::move(name), parameters_.initial_rating, 0 });
+        }
+    }
+
+    std::lock_guard<std::mutex> recompute_lock(recompute_mutex_);
+    if (is_recomputing_) {
+        recorded_during_recompute_.emplace_back(match_id, winner_id, loser_id);
+    }
+    enqueueResult(match_id, winner_id, loser_id);
+}
+
+void RatingEngine::enqueueResult(const int match_id, const int winner_id, const int loser_id) {
+    // A retried write overwrites rated, so the cache only ever sees the ratings of the transaction that committed.
+    auto rated = std::make_shared<std::vector<PlayerRating>>();
+    PersistenceQueue::getInstance().enqueue(match_id, [this, winner_id, loser_id, rated](pqxx::work& txn) {
+        applyResult(txn, winner_id, loser_id, *rated);
+    }, [this, rated] {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        for (const PlayerRating& player : *rated) {
+            store(player.player_id, player.rating, player.rated_matches);
+        }
+    });
+}
+
+// Runs on the persistence queue. The rows stay locked until the batch commits; if it fails the write is retried
+// and re-reads them, and the cache is left alone until a commit succeeds.
+void RatingEngine::applyResult(pqxx::work& txn, const int winner_id, const int loser_id, std::vector<PlayerRating>& rated) {
+    rated.clear();
+    const RatingParameters parameters = getParameters();
+    const pqxx::result rows = PreparedStatements::exec<LockPlayerRatingsQuery>(txn, winner_id, loser_id);
+    if (rows.size() != 2) {
+        std::cerr << "Cannot rate a match between players " << winner_id << " and " << loser_id << ".\n";
+        return;
+    }
+    const auto& winner = rows[0]["id"].as<int>() == winner_id ? rows[0] : rows[1];
+    const auto& loser = rows[0]["id"].as<int>() == winner_id ? rows[1] : rows[0];
+    const double winner_rating = winner["rating"].as<double>();
+    const double loser_rating = loser["rating"].as<double>();
+    const int winner_matches = winner["rated_matches"].as<int>();
+    const int loser_matches = loser["rated_matches"].as<int>();
+
+    const double expected = expectedScore(winner_rating, loser_rating);
+    const double new_winner_rating = winner_rating + kFactor(parameters, winner_matches) * (1.0 - expected);
+    const double new_loser_rating = loser_rating - kFactor(parameters, loser_matches) * (1.0 - expected);
+    PreparedStatements::exec<UpdatePlayerRatingQuery>(txn, new_winner_rating, winner_matches + 1, winner_id);
+    PreparedStatements::exec<UpdatePlayerRatingQuery>(txn, new_loser_rating, loser_matches + 1, loser_id);
+
+    rated.push_back(PlayerRating{ winner_id, std::string(), new_winner_rating, winner_matches + 1 });
+    rated.push_back(PlayerRating{ loser_id, std::string(), new_loser_rating, loser_matches + 1 });
+}
+
+// Caller holds mutex_ exclusively.
+void RatingEngine::store(const int player_id, const double rating, const int rated_matches) {
+    Entry& entry = players_.try_emplace(player_id, Entry{ "Player " + std::to_string(player_id), rating, 0 }).first->second;
+    if (entry.rated_matches > 0) {
+        ranking_.erase(RankKey{ entry.rating, player_id });
+    }
+    entry.rating = rating;
+    entry.rated_matches = rated_matches;
+    if (rated_matches > 0) {
+        ranking_.insert(RankKey{ entry.rating, player_id });
+    }
+}
+
+bool RatingEngine::recompute(const RatingParameters& parameters, const unsigned threads) {
+    {
+        std::lock_guard<std::mutex> recompute_lock(recompute_mutex_);
+        if (is_recomputing_) {
+            std::cerr << "A rating recomputation is already running.\n";
+            return false;
+        }
+        is_recomputing_ = true;
+        recorded_during_recompute_.clear();
+    }
+    // Results recorded before this point are committed and so part of the history read below; later ones are replayed.
+    PersistenceQueue::getInstance().flush();
+    const auto abandon = [this] {
+        std::lock_guard<std::mutex> recompute_lock(recompute_mutex_);
+        is_recomputing_ = false;
+        recorded_during_recompute_.clear();
+    };
+
+    std::vector<int> player_ids;
+    std::vector<std::string> names;
+    std::unordered_map<int, int> index;
+    std::vector<HistoryMatch> history;
+    std::unordered_set<int> history_match_ids;
+    std::vector<double> ratings;
+    std::vector<int> counts;
+
+    try {
+        ConnectionLease lease = DatabaseConnection::getInstance().acquire();
+        pqxx::work txn(*lease);
+        const pqxx::result players = txn.exec("SELECT id, first_name || ' ' || last_name AS name FROM public.players ORDER BY id;");
+        player_ids.reserve(players.size());
+        names.reserve(players.size());
+        for (const auto& row : players) {
+            index.emplace(row["id"].as<int>(), static_cast<int>(player_ids.size()));
+            player_ids.push_back(row["id"].as<int>());
+            names.push_back(row["name"].as<std::string>());
+        }
+
+        const pqxx::result matches = txn.exec_params(
+            "SELECT id, winner_id, CASE WHEN winner_id = player_id1 THEN player_id2 ELSE player_id1 END AS loser_id "
+            "FROM public.matches WHERE status_id = $1 AND winner_id IS NOT NULL "
+            "ORDER BY COALESCE(actual_start_time, predicted_start_time) + duration, id;",
+            ReferenceData::getInstance().getStatusId("Finished"));
+        history.reserve(matches.size());
+        for (const auto& row : matches) {
+            history_match_ids.insert(row["id"].as<int>());
+            history.push_back(HistoryMatch{ index.at(row["winner_id"].as<int>()), index.at(row["loser_id"].as<int>()) });
+        }
+        txn.commit();
+    }
+    catch (const pqxx::sql_error& e) {
+        std::cerr << "SQL error while recomputing ratings: " << e.what() << '\n';
+        abandon();
+        return false;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Exception while recomputing ratings: " << e.what() << '\n';
+        abandon();
+        return false;
+    }
+
+    ratings.assign(player_ids.size(), parameters.initial_rating);
+    counts.assign(player_ids.size(), 0);
+    replay(history, parameters, ratings, counts, threads);
+
+    auto players = std::make_shared<std::unordered_map<int, Entry>>();
+    auto ranking = std::make_shared<std::set<RankKey>>();
+    players->reserve(player_ids.size());
+    for (std::size_t i = 0; i < player_ids.size(); ++i) {
+        if (counts[i] > 0) {
+            ranking->insert(RankKey{ ratings[i], player_ids[i] });
+        }
+        players->emplace(player_ids[i], Entry{ std::move(names[i]), ratings[i], counts[i] });
+    }
+
+    // The new ratings are written through the queue, so results queued before them are overwritten and results queued
+    // after them apply on top. Of the former, those missing from the history read above are queued again.
+    const auto write = [parameters, player_ids = std::move(player_ids), ratings = std::move(ratings),
+        counts = std::move(counts)](pqxx::work& txn) {
+        txn.exec_params(
+            "UPDATE public.players p SET rating = r.rating, rated_matches = r.rated_matches "
+            "FROM unnest($1::int[], $2::float8[], $3::int[]) AS r(id, rating, rated_matches) WHERE p.id = r.id;",
+            toSqlArray(player_ids), toSqlArray(ratings), toSqlArray(counts));
+        txn.exec_params(
+            "UPDATE public.rating_parameters SET initial_rating = $1, k_factor = $2, provisional_k_factor = $3, provisional_matches = $4 WHERE id = 1;",
+            parameters.initial_rating, parameters.k_factor, parameters.provisional_k_factor, parameters.provisional_matches);
+    };
+    const auto install = [this, parameters, players, ranking] {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        parameters_ = parameters;
+        players_ = *players;
+        ranking_ = *ranking;
+    };
+
+    {
+        std::lock_guard<std::mutex> recompute_lock(recompute_mutex_);
+        PersistenceQueue::getInstance().enqueue(0, write, install);
+        for (const auto& [match_id, winner_id, loser_id] : recorded_during_recompute_) {
+            if (history_match_ids.count(match_id) == 0) {
+                enqueueResult(match_id, winner_id, loser_id);
+            }
+        }
+        is_recomputing_ = false;
+        recorded_during_recompute_.clear();
+    }
+    if (!PersistenceQueue::getInstance().flush()) {
+        std::cerr << "Recomputed ratings could not be saved.\n";
+        return false;
+    }
+    return true;
+}
+
+// A match's level is one past the latest level of either player, so matches sharing a level touch disjoint players and
+// can be applied in any order, while each player's matches still apply in history order.
+void RatingEngine::replay(const std::vector<HistoryMatch>& history, const RatingParameters& parameters,
+    std::vector<double>& ratings, std::vector<int>& counts, const unsigned threads) {
+    std::vector<int> player_level(ratings.size(), 0);
+    std::vector<int> match_level(history.size());
+    int max_level = 0;
+    for (std::size_t i = 0; i < history.size(); ++i) {
+        const HistoryMatch& match = history[i];
+        const int level = std::max(player_level[match.winner], player_level[match.loser]) + 1;
+        player_level[match.winner] = player_level[match.loser] = match_level[i] = level;
+        max_level = std::max(max_level, level);
+    }
+
+    std::vector<std::size_t> level_begin(max_level + 2, 0);
+    for (const int level : match_level) {
+        ++level_begin[level + 1];
+    }
+    for (std::size_t level = 1; level < level_begin.size(); ++level) {
+        level_begin[level] += level_begin[level - 1];
+    }
+    std::vector<std::size_t> order(history.size());
+    std::vector<std::size_t> next = level_begin;
+    for (std::size_t i = 0; i < history.size(); ++i) {
+        order[next[match_level[i]]++] = i;
+    }
+
+    const auto applyRange = [&](const std::size_t begin, const std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            const HistoryMatch& match = history[order[i]];
+            const double expected = expectedScore(ratings[match.winner], ratings[match.loser]);
+            ratings[match.winner] += kFactor(parameters, counts[match.winner]) * (1.0 - expected);
+            ratings[match.loser] -= kFactor(parameters, counts[match.loser]) * (1.0 - expected);
+            ++counts[match.winner];
+            ++counts[match.loser];
+        }
+    };
+
+    const unsigned thread_count = threads == 0 ? std::max(1u, std::thread::hardware_concurrency()) : threads;
+    for (int level = 1; level <= max_level; ++level) {
+        const std::size_t begin = level_begin[level];
+        const std::size_t end = level_begin[level + 1];
+        if (thread_count == 1 || end - begin < PARALLEL_THRESHOLD) {
+            applyRange(begin, end);
+            continue;
+        }
+
+        const std::size_t chunk = (end - begin + thread_count - 1) / thread_count;
+        std::vector<std::thread> workers;
+        workers.reserve(thread_count - 1);
+        for (unsigned t = 1; t < thread_count; ++t) {
+            workers.emplace_back(applyRange, std::min(end, begin + t * chunk), std::min(end, begin + (t + 1) * chunk));
+        }
+        applyRange(begin, std::min(end, begin + chunk));
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+}
+
+std::vector<PlayerRating> RatingEngine::top(const std::size_t k) const {
+    std::vector<PlayerRating> leaders;
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    leaders.reserve(std::min(k, ranking_.size()));
+    for (auto it = ranking_.begin(); it != ranking_.end() && leaders.size() < k; ++it) {
+        const Entry& entry = players_.at(it->player_id);
+        leaders.push_back(PlayerRating{ it->player_id, entry.name, entry.rating, entry.rated_matches });
+    }
+    return leaders;
+}
+
+std::optional<PlayerRating> RatingEngine::get(const int player_id) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    const auto it = players_.find(player_id);
+    if (it == players_.end()) {
+        return std::nullopt;
+    }
+    return PlayerRating{ player_id, it->second.name, it->second.rating, it->second.rated_matches };
+}
+
+RatingParameters RatingEngine::getParameters() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return parameters_;
+}
+
+std::optional<std::string> RatingEngine::loadName(const int player_id) {
+    try {
+        ConnectionLease lease = DatabaseConnection::getInstance().acquire();
+        pqxx::nontransaction nt(*lease);
+        const pqxx::result r = nt.exec_params("SELECT first_name || ' ' || last_name FROM public.players WHERE id = $1;", player_id);
+        if (!r.empty()) {
+            return r[0][0].as<std::string>();
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Exception while loading player " << player_id << " for ratings: " << e.what() << '\n';
+    }
+    return std::nullopt;
+}
@@ -0,0 +1,84 @@
+#include "ReferenceData.hpp"
+#include "DatabaseConnection.hpp"
+#include <iostream>
+#include <stdexcept>
+
+ReferenceData& ReferenceData::getInstance() {
+    static ReferenceData instance;
+    return instance;
+}
+
+ReferenceData::ReferenceData() {
+    auto defaults = std::make_shared<Snapshot>();
+    for (const auto& entry : DEFAULT_MATCH_STATUSES) {
+        defaults->statuses.emplace_back(entry.id, entry.status);
+    }
+    defaults->tiebreak_types.assign(DEFAULT_TIEBREAK_TYPES.begin(), DEFAULT_TIEBREAK_TYPES.end());
+    snapshot_ = std::move(defaults);
+}
+
+std::shared_ptr<const ReferenceData::Snapshot> ReferenceData::current() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return snapshot_;
+}
+
+bool ReferenceData::refresh() {
+    auto loaded = std::make_shared<Snapshot>();
+
+    try {
+        ConnectionLease lease = DatabaseConnection::getInstance().acquire();
+        pqxx::nontransaction nt(*lease);
+
+        const pqxx::result statuses = nt.exec("SELECT id, status FROM public.match_status ORDER BY id;");
+        for (const auto& row : statuses) {
+            loaded->statuses.emplace_back(row["id"].as<int>(), row["status"].as<std::string>());
+        }
+
+        const pqxx::result types = nt.exec("SELECT type_id, min_points FROM public.tie_break_type ORDER BY type_id;");
+        for (const auto& row : types) {
+            loaded->tiebreak_types.push_back(TiebreakTypeEntry{ row["type_id"].as<int>(), row["min_points"].as<int>() });
+        }
+    }
+    catch (const pqxx::sql_error& e) {
+        std::cerr << "SQL error while loading reference data: " << e.what() << '\n';
+        return false;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Exception while loading reference data: " << e.what() << '\n';
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    snapshot_ = std::move(loaded);
+    return true;
+}
+
+int ReferenceData::getStatusId(const std::string& status_name) const {
+    const auto snapshot = current();
+    for (const auto& [id, status] : snapshot->statuses) {
+        if (status == status_name) {
+            return id;
+        }
+    }
+    throw std::runtime_error("Status not found.");
+}
+
+std::optional<std::string> ReferenceData::getStatusName(const int status_id) const {
+    const auto snapshot = current();
+    for (const auto& [id, status] : snapshot->statuses) {
+        if (id == status_id) {
+            return status;
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<int> ReferenceData::getTiebreakTypeId(const int min_points) const {
+    const auto snapshot = current();
+    for (const auto& type : snapshot->tiebreak_types) {
+        if (type.min_points == min_points) {
+            return type.type_id;
+        }
+    }
+    return std::nullopt;
+}
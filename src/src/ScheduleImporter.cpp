@@ -0,0 +1,240 @@
+#include "ScheduleImporter.hpp"
+#include "DatabaseConnection.hpp"
+#include "ReferenceData.hpp"
+#include "SqlArray.hpp"
+#include "UIManager.hpp"
+#include <algorithm>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <unordered_set>
+
+ScheduleReport ScheduleImporter::importFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        ScheduleReport report;
+        report.errors.push_back(ImportError{ 0, "Cannot open " + path + "." });
+        return report;
+    }
+    return importStream(file);
+}
+
+ScheduleReport ScheduleImporter::importStream(std::istream& in) {
+    const auto start = std::chrono::steady_clock::now();
+    ScheduleReport report;
+    const std::vector<DelimitedRecord> records = DelimitedFile::read(in);
+
+    std::size_t columns[4] = { 0, 1, 2, 3 };
+    std::size_t begin = 0;
+    if (!records.empty()) {
+        const std::vector<std::string>& header = records.front().fields;
+        const auto player1 = DelimitedFile::findColumn(header, { "player_id1", "player1", "player 1" });
+        const auto player2 = DelimitedFile::findColumn(header, { "player_id2", "player2", "player 2" });
+        const auto no_sets = DelimitedFile::findColumn(header, { "no_sets", "sets" });
+        const auto start_time = DelimitedFile::findColumn(header, { "predicted_start_time", "start_time", "start" });
+        if (player1 && player2 && no_sets && start_time) {
+            columns[0] = *player1;
+            columns[1] = *player2;
+            columns[2] = *no_sets;
+            columns[3] = *start_time;
+            begin = 1;
+        }
+    }
+
+    std::vector<Row> rows;
+    rows.reserve(records.size() - begin);
+    for (std::size_t i = begin; i < records.size(); ++i) {
+        Row row;
+        row.line = records[i].line;
+        parse(records[i].fields, columns, row);
+        rows.push_back(std::move(row));
+    }
+    report.rows_read = rows.size();
+
+    if (std::any_of(rows.begin(), rows.end(), [](const Row& row) { return row.error.empty(); })) {
+        report.is_committed = insert(rows, report);
+    }
+    for (const auto& row : rows) {
+        if (!row.error.empty()) {
+            report.errors.push_back(ImportError{ row.line, row.error });
+        }
+    }
+    std::sort(report.errors.begin(), report.errors.end(), [](const ImportError& a, const ImportError& b) { return a.line < b.line; });
+
+    report.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    return report;
+}
+
+void ScheduleImporter::printReport(const ScheduleReport& report, const std::size_t max_rows) {
+    for (std::size_t i = 0; i < report.errors.size() && i < max_rows; ++i) {
+        const ImportError& error = report.errors[i];
+        std::cout << (error.line == 0 ? std::string("Import") : "Line " + std::to_string(error.line)) << ": " << error.message << '\n';
+    }
+    if (report.errors.size() > max_rows) {
+        std::cout << "... and " << report.errors.size() - max_rows << " more rejected rows.\n";
+    }
+    for (std::size_t i = 0; i < report.scheduled.size() && i < max_rows; ++i) {
+        std::cout << "Line " << report.scheduled[i].line << ": match ID " << report.scheduled[i].match_id << '\n';
+    }
+    if (report.scheduled.size() > max_rows) {
+        std::cout << "... through match ID " << report.scheduled.back().match_id << ".\n";
+    }
+    std::cout << "Scheduled " << report.scheduled.size() << " of " << report.rows_read << " matches in " << report.elapsed.count() << " ms.\n";
+}
+
+void ScheduleImporter::parse(const std::vector<std::string>& fields, const std::size_t (&columns)[4], Row& row) {
+    if (fields.size() <= *std::max_element(std::begin(columns), std::end(columns))) {
+        row.error = "Expected player_id1, player_id2, no_sets and predicted_start_time.";
+        return;
+    }
+
+    try {
+        std::size_t end = 0;
+        row.player_id1 = std::stoi(fields[columns[0]], &end);
+        if (end != fields[columns[0]].size()) {
+            throw std::invalid_argument("player_id1");
+        }
+        row.player_id2 = std::stoi(fields[columns[1]], &end);
+        if (end != fields[columns[1]].size()) {
+            throw std::invalid_argument("player_id2");
+        }
+        row.no_sets = std::stoi(fields[columns[2]], &end);
+        if (end != fields[columns[2]].size()) {
+            throw std::invalid_argument("no_sets");
+        }
+    }
+    catch (const std::exception&) {
+        row.error = "Player IDs and number of sets must be whole numbers.";
+        return;
+    }
+
+    if (row.player_id1 == row.player_id2) {
+        row.error = "Player IDs must be different.";
+        return;
+    }
+    if (row.no_sets < 1 || row.no_sets > UIManager::MAX_SETS_TO_WIN) {
+        row.error = "Number of sets must be between 1 and " + std::to_string(UIManager::MAX_SETS_TO_WIN) + ".";
+        return;
+    }
+
+    bool is_future = false;
+    if (!parseStartTime(fields[columns[3]], row.predicted_start_time, is_future)) {
+        row.error = "Invalid start time '" + fields[columns[3]] + "'; expected YYYY-MM-DD HH:MM[:SS].";
+        return;
+    }
+    // Same rule as the interactive constructor: a start time that has already passed is scheduled as delayed.
+    row.status_id = ReferenceData::getInstance().getStatusId(is_future ? "Pending" : "Delayed");
+}
+
+bool ScheduleImporter::parseStartTime(const std::string& value, std::string& normalized, bool& is_future) {
+    std::tm tm = {};
+    std::istringstream ss(value);
+    ss >> std::get_time(&tm, "%Y-%m-%d %H:%M");
+    if (ss.fail() || value.find(':') == std::string::npos) {
+        return false;
+    }
+    if (ss.peek() == ':') {
+        ss.get();
+        ss >> std::get_time(&tm, "%S");
+        if (ss.fail()) {
+            return false;
+        }
+    }
+    if (ss.peek() != std::char_traits<char>::eof()) {
+        return false;
+    }
+
+    std::tm checked = tm;
+    checked.tm_isdst = -1;
+    const std::time_t time = std::mktime(&checked);
+    if (time == -1 || checked.tm_mday != tm.tm_mday || checked.tm_mon != tm.tm_mon) {
+        return false;
+    }
+
+    std::ostringstream out;
+    out << std::put_time(&tm, "%Y-%m-%d %H:%M:%S");
+    normalized = out.str();
+    is_future = time > std::time(nullptr);
+    return true;
+}
+
+bool ScheduleImporter::insert(std::vector<Row>& rows, ScheduleReport& report) {
+    try {
+        ConnectionLease lease = DatabaseConnection::getInstance().acquire();
+        pqxx::work txn(*lease);
+
+        std::vector<int> player_ids;
+        for (const auto& row : rows) {
+            if (row.error.empty()) {
+                player_ids.push_back(row.player_id1);
+                player_ids.push_back(row.player_id2);
+            }
+        }
+        std::sort(player_ids.begin(), player_ids.end());
+        player_ids.erase(std::unique(player_ids.begin(), player_ids.end()), player_ids.end());
+
+        std::unordered_set<int> existing;
+        const pqxx::result found = txn.exec_params("SELECT id FROM public.players WHERE id = ANY($1::int[]);", toSqlArray(player_ids));
+        for (const auto& row : found) {
+            existing.insert(row[0].as<int>());
+        }
+
+        std::vector<Row*> valid;
+        std::vector<int> status_ids, player_ids1, player_ids2, no_sets;
+        std::vector<std::string> start_times;
+        for (auto& row : rows) {
+            if (!row.error.empty()) {
+                continue;
+            }
+            if (existing.count(row.player_id1) == 0 || existing.count(row.player_id2) == 0) {
+                row.error = "Player " + std::to_string(existing.count(row.player_id1) == 0 ? row.player_id1 : row.player_id2) + " does not exist.";
+                continue;
+            }
+            valid.push_back(&row);
+            status_ids.push_back(row.status_id);
+            player_ids1.push_back(row.player_id1);
+            player_ids2.push_back(row.player_id2);
+            no_sets.push_back(row.no_sets);
+            start_times.push_back(row.predicted_start_time);
+        }
+        if (valid.empty()) {
+            return false;
+        }
+
+        // IDs are drawn from the sequence in input order and returned by ordinality, not by RETURNING order.
+        const pqxx::result ids = txn.exec_params(R"(
+            WITH input AS (
+                SELECT *
+                FROM unnest($1::int[], $2::int[], $3::int[], $4::int[], $5::timestamp[])
+                    WITH ORDINALITY AS t(status_id, player_id1, player_id2, no_sets, predicted_start_time, ord)
+            ), numbered AS (
+                SELECT nextval('public.matches_id_seq')::int AS id, i.*
+                FROM (SELECT * FROM input ORDER BY ord) i
+            ), inserted AS (
+                INSERT INTO public.matches (id, status_id, player_id1, player_id2, predicted_start_time, duration, no_sets)
+                SELECT id, status_id, player_id1, player_id2, predicted_start_time, interval '0 minutes', no_sets
+                FROM numbered
+            )
+            SELECT id FROM numbered ORDER BY ord;
+        )", toSqlArray(status_ids), toSqlArray(player_ids1), toSqlArray(player_ids2), toSqlArray(no_sets), toSqlArray(start_times));
+        txn.commit();
+
+        std::size_t i = 0;
+        for (const auto& row : ids) {
+            report.scheduled.push_back(ScheduledMatch{ valid[i++]->line, row[0].as<int>() });
+        }
+        return true;
+    }
+    catch (const pqxx::sql_error& e) {
+        std::cerr << "SQL error while scheduling matches: " << e.what() << '\n';
+        report.errors.push_back(ImportError{ 0, std::string("Database rejected the schedule: ") + e.what() });
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Exception while scheduling matches: " << e.what() << '\n';
+        report.errors.push_back(ImportError{ 0, std::string("Schedule import failed: ") + e.what() });
+    }
+    report.scheduled.clear();
+    return false;
+}
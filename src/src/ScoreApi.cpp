@@ -0,0 +1,429 @@
+#include "ScoreApi.hpp"
+#include "MatchHistoryIndex.hpp"
+#include "PlayerSearchIndex.hpp"
+#include "QueryMetrics.hpp"
+#include "RatingEngine.hpp"
+#include "ReferenceData.hpp"
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+HttpResponse ScoreApi::handle(const HttpRequest& request) {
+    const std::vector<std::string> segments = splitPath(request.path);
+    if (segments.size() == 1 && segments[0] == "events") {
+        return request.method == "GET" ? streamEvents(0) : HttpResponse::error(405, "Use GET.");
+    }
+    if (segments.size() == 1 && segments[0] == "metrics") {
+        return request.method == "GET" ? getMetrics() : HttpResponse::error(405, "Use GET.");
+    }
+    if (segments.size() == 1 && segments[0] == "leaderboard") {
+        return request.method == "GET" ? getLeaderboard(request) : HttpResponse::error(405, "Use GET.");
+    }
+    if (segments.size() == 1 && segments[0] == "players") {
+        return request.method == "GET" ? searchPlayers(request) : HttpResponse::error(405, "Use GET.");
+    }
+    if (segments.size() == 3 && segments[0] == "players" && segments[2] == "matches") {
+        return request.method == "GET" ? getPlayerHistory(segments[1], request) : HttpResponse::error(405, "Use GET.");
+    }
+    if (segments.empty() || segments[0] != "matches") {
+        return HttpResponse::error(404, "Unknown route.");
+    }
+
+    if (segments.size() == 1) {
+        return request.method == "GET" ? listMatches() : HttpResponse::error(405, "Use GET.");
+    }
+
+    int match_id = 0;
+    try {
+        std::size_t parsed = 0;
+        match_id = std::stoi(segments[1], &parsed);
+        if (parsed != segments[1].size()) {
+            return HttpResponse::error(400, "Invalid match id.");
+        }
+    }
+    catch (const std::exception&) {
+        return HttpResponse::error(400, "Invalid match id.");
+    }
+
+    if (segments.size() == 2) {
+        return request.method == "GET" ? getMatch(match_id) : HttpResponse::error(405, "Use GET.");
+    }
+    if (segments.size() != 3) {
+        return HttpResponse::error(404, "Unknown route.");
+    }
+
+    const std::string& action = segments[2];
+    if (action == "events") {
+        return request.method == "GET" ? streamEvents(match_id) : HttpResponse::error(405, "Use GET.");
+    }
+    if (request.method != "POST") {
+        return HttpResponse::error(405, "Use POST.");
+    }
+
+    if (action == "points") {
+        return scorePoint(match_id, request);
+    }
+    if (action == "start") {
+        return startMatch(match_id, request);
+    }
+    if (action == "suspend") {
+        return suspendMatch(match_id);
+    }
+    if (action == "finish") {
+        return finishMatch(match_id, request);
+    }
+    return HttpResponse::error(404, "Unknown route.");
+}
+
+HttpResponse ScoreApi::listMatches() const {
+    std::vector<LiveMatch> matches = LiveScoreCache::getInstance().getAll();
+    std::sort(matches.begin(), matches.end(), [](const LiveMatch& a, const LiveMatch& b) { return a.match_id < b.match_id; });
+
+    std::string body = "[";
+    for (std::size_t i = 0; i < matches.size(); ++i) {
+        if (i > 0) {
+            body += ',';
+        }
+        body += toJson(matches[i]);
+    }
+    body += ']';
+    return HttpResponse::json(200, std::move(body));
+}
+
+HttpResponse ScoreApi::getMetrics() {
+    return HttpResponse{ 200, "text/plain; version=0.0.4", QueryMetrics::getInstance().renderPrometheus(), nullptr };
+}
+
+HttpResponse ScoreApi::getLeaderboard(const HttpRequest& request) const {
+    std::size_t limit = DEFAULT_LEADERBOARD_SIZE;
+    const auto query = request.query.find("limit");
+    if (query != request.query.end()) {
+        try {
+            std::size_t parsed = 0;
+            const int value = std::stoi(query->second, &parsed);
+            if (parsed != query->second.size() || value < 1) {
+                return HttpResponse::error(400, "Invalid limit.");
+            }
+            limit = static_cast<std::size_t>(value);
+        }
+        catch (const std::exception&) {
+            return HttpResponse::error(400, "Invalid limit.");
+        }
+    }
+
+    const std::vector<PlayerRating> leaders = RatingEngine::getInstance().top(limit);
+    std::string body = "[";
+    for (std::size_t i = 0; i < leaders.size(); ++i) {
+        if (i > 0) {
+            body += ',';
+        }
+        std::ostringstream rating;
+        rating << std::fixed << std::setprecision(1) << leaders[i].rating;
+        body += "{\"rank\":" + std::to_string(i + 1) + ",\"id\":" + std::to_string(leaders[i].player_id) + ",\"name\":" + quote(leaders[i].name)
+            + ",\"rating\":" + rating.str() + ",\"matches\":" + std::to_string(leaders[i].rated_matches) + '}';
+    }
+    body += ']';
+    return HttpResponse::json(200, std::move(body));
+}
+
+HttpResponse ScoreApi::searchPlayers(const HttpRequest& request) const {
+    const auto query = request.query.find("q");
+    if (query == request.query.end()) {
+        return HttpResponse::error(400, "Missing q.");
+    }
+    std::size_t limit = PlayerSearchIndex::DEFAULT_LIMIT;
+    const auto limit_param = request.query.find("limit");
+    if (limit_param != request.query.end()) {
+        try {
+            std::size_t parsed = 0;
+            const int value = std::stoi(limit_param->second, &parsed);
+            if (parsed != limit_param->second.size() || value < 1) {
+                return HttpResponse::error(400, "Invalid limit.");
+            }
+            limit = static_cast<std::size_t>(value);
+        }
+        catch (const std::exception&) {
+            return HttpResponse::error(400, "Invalid limit.");
+        }
+    }
+
+    const std::vector<PlayerMatch> matches = PlayerSearchIndex::getInstance().search(query->second, limit);
+    std::string body = "[";
+    for (std::size_t i = 0; i < matches.size(); ++i) {
+        if (i > 0) {
+            body += ',';
+        }
+        body += "{\"id\":" + std::to_string(matches[i].player_id) + ",\"first_name\":" + quote(matches[i].first_name)
+            + ",\"last_name\":" + quote(matches[i].last_name) + ",\"score\":" + std::to_string(matches[i].score) + '}';
+    }
+    body += ']';
+    return HttpResponse::json(200, std::move(body));
+}
+
+HttpResponse ScoreApi::getPlayerHistory(const std::string& player, const HttpRequest& request) const {
+    int player_id = 0;
+    int opponent_id = 0;
+    try {
+        std::size_t parsed = 0;
+        player_id = std::stoi(player, &parsed);
+        if (parsed != player.size()) {
+            return HttpResponse::error(400, "Invalid player id.");
+        }
+        const auto opponent = request.query.find("opponent");
+        if (opponent != request.query.end()) {
+            opponent_id = std::stoi(opponent->second, &parsed);
+            if (parsed != opponent->second.size()) {
+                return HttpResponse::error(400, "Invalid opponent id.");
+            }
+        }
+    }
+    catch (const std::exception&) {
+        return HttpResponse::error(400, "Invalid player id.");
+    }
+
+    const MatchHistoryIndex& index = MatchHistoryIndex::getInstance();
+    const std::vector<MatchRecord> matches = opponent_id != 0 ? index.getHeadToHead(player_id, opponent_id) : index.getPlayerHistory(player_id);
+
+    std::string body = "[";
+    for (std::size_t i = 0; i < matches.size(); ++i) {
+        const MatchRecord& match = matches[i];
+        if (i > 0) {
+            body += ',';
+        }
+        body += "{\"match_id\":" + std::to_string(match.match_id) + ",\"player_id1\":" + std::to_string(match.player_id1)
+            + ",\"player_id2\":" + std::to_string(match.player_id2) + ",\"winner_id\":" + std::to_string(match.winner_id)
+            + ",\"sets\":[" + std::to_string(match.sets_player1) + ',' + std::to_string(match.sets_player2) + ']'
+            + ",\"duration_seconds\":" + std::to_string(match.duration_seconds) + '}';
+    }
+    body += ']';
+    return HttpResponse::json(200, std::move(body));
+}
+
+HttpResponse ScoreApi::getMatch(const int match_id) const {
+    const std::optional<LiveMatch> match = LiveScoreCache::getInstance().get(match_id);
+    if (!match) {
+        return HttpResponse::error(404, "Match is not live.");
+    }
+    return HttpResponse::json(200, toJson(*match));
+}
+
+HttpResponse ScoreApi::startMatch(const int match_id, const HttpRequest& request) {
+    const int server = playerParam(request, "server");
+    if (server == -1) {
+        return HttpResponse::error(400, "server must be 1 or 2.");
+    }
+    const auto takeover = request.query.find("takeover");
+    const bool is_takeover = takeover != request.query.end() && takeover->second == "1";
+    if (!court_server_.openMatch(match_id, server != 2, is_takeover)) {
+        return HttpResponse::error(409, "Match could not be started.");
+    }
+    return getMatch(match_id);
+}
+
+HttpResponse ScoreApi::scorePoint(const int match_id, const HttpRequest& request) {
+    const int player = playerParam(request, "player");
+    if (player <= 0) {
+        return HttpResponse::error(400, "player must be 1 or 2.");
+    }
+    return fromAck(court_server_.submitPoint(match_id, player).get());
+}
+
+HttpResponse ScoreApi::suspendMatch(const int match_id) {
+    switch (court_server_.suspendMatch(match_id)) {
+    case SuspendResult::NOT_LIVE:
+        return HttpResponse::error(404, "Match is not live.");
+    case SuspendResult::NOT_SAVED:
+        return HttpResponse::error(500, "Match was closed but its status could not be saved.");
+    case SuspendResult::SUSPENDED:
+        break;
+    }
+    return HttpResponse::json(200, "{\"match_id\":" + std::to_string(match_id) + ",\"status\":\"Suspended\"}");
+}
+
+HttpResponse ScoreApi::finishMatch(const int match_id, const HttpRequest& request) {
+    const int winner = playerParam(request, "winner");
+    if (winner <= 0) {
+        return HttpResponse::error(400, "winner must be 1 or 2.");
+    }
+    return fromAck(court_server_.finishMatch(match_id, winner).get());
+}
+
+// Each viewer drains its own coalescing subscription, so a slow client only ever skips to newer scores
+// and never holds up publishers or other viewers.
+HttpResponse ScoreApi::streamEvents(const int match_id) {
+    return HttpResponse::eventStream([match_id](HttpStream& stream) {
+        const std::shared_ptr<ScoreSubscription> subscription = ScoreEventBus::getInstance().subscribe(match_id);
+        auto last_write = std::chrono::steady_clock::now();
+        if (!stream.write("retry: 2000\n\n")) {
+            return;
+        }
+
+        while (stream.isOpen() && !subscription->isClosed()) {
+            std::string chunk;
+            for (const ScoreDelta& delta : subscription->wait(POLL_INTERVAL)) {
+                chunk += "id: " + std::to_string(delta.version) + "\nevent: score\ndata: " + toJson(delta) + "\n\n";
+            }
+
+            const auto now = std::chrono::steady_clock::now();
+            if (chunk.empty()) {
+                if (now - last_write < HEARTBEAT_INTERVAL) {
+                    continue;
+                }
+                chunk = ": keep-alive\n\n";
+            }
+            if (!stream.write(chunk)) {
+                break;
+            }
+            last_write = now;
+        }
+    });
+}
+
+HttpResponse ScoreApi::fromAck(const PointAck& ack) {
+    if (!ack.is_accepted) {
+        return HttpResponse::error(409, "Rejected: match " + std::to_string(ack.match_id) + " is not live or already finished.");
+    }
+    return HttpResponse::json(200, toJson(ack));
+}
+
+std::string ScoreApi::toJson(const int match_id, const CompactScore& score) {
+    std::ostringstream out;
+    out << "{\"match_id\":" << match_id
+        << ",\"sets\":[" << score.getSetsPlayerOne() << ',' << score.getSetsPlayerTwo() << ']'
+        << ",\"games\":[" << score.getGamesPlayerOne() << ',' << score.getGamesPlayerTwo() << ']'
+        << ",\"points\":[" << score.getPointsPlayerOne() << ',' << score.getPointsPlayerTwo() << ']'
+        << ",\"set\":" << score.getSetNum()
+        << ",\"is_tiebreak\":" << (score.getIsTiebreak() ? "true" : "false")
+        << ",\"serving\":" << (score.getIsPlayerOneServing() ? 1 : 2)
+        << ",\"winner\":" << score.getWinner() << '}';
+    return out.str();
+}
+
+std::string ScoreApi::toJson(const PointAck& ack) {
+    std::string json = toJson(ack.match_id, ack.score);
+    json.pop_back();
+    json += ",\"events\":" + std::to_string(static_cast<int>(ack.events)) + '}';
+    return json;
+}
+
+std::string ScoreApi::toJson(const ScoreDelta& delta) {
+    std::string json = toJson(delta.match_id, delta.score);
+    json.pop_back();
+    json += ",\"events\":" + std::to_string(static_cast<int>(delta.events)) + ",\"version\":" + std::to_string(delta.version) + '}';
+    return json;
+}
+
+std::string ScoreApi::toJson(const LiveMatch& match) {
+    std::string json = toJson(match.match_id, match.score);
+    json.pop_back();
+    json += ",\"status\":" + quote(ReferenceData::getInstance().getStatusName(match.status_id).value_or(""))
+        + ",\"player1\":{\"id\":" + std::to_string(match.player_id1) + ",\"name\":" + quote(match.player1_name) + '}'
+        + ",\"player2\":{\"id\":" + std::to_string(match.player_id2) + ",\"name\":" + quote(match.player2_name) + "}}";
+    return json;
+}
+
+std::string ScoreApi::quote(const std::string& value) {
+    std::string quoted = "\"";
+    for (const char c : value) {
+        if (c == '"' || c == '\\') {
+            quoted += '\\';
+            quoted += c;
+        }
+        else if (static_cast<unsigned char>(c) < 0x20) {
+            quoted += ' ';
+        }
+        else {
+            quoted += c;
+        }
+    }
+    quoted += '"';
+    return quoted;
+}
+
+std::vector<std::string> ScoreApi::splitPath(const std::string& path) {
+    std::vector<std::string> segments;
+    std::istringstream parts(path);
+    std::string segment;
+    while (std::getline(parts, segment, '/')) {
+        if (!segment.empty()) {
+            segments.push_back(segment);
+        }
+    }
+    return segments;
+}
+
+// Returns the whole value of the top-level key `name` in a flat JSON object ({"player": 1}, {"player": "1"})
+// or a form body (player=1&...), or nothing when the key is absent. Keys must match exactly.
+std::optional<std::string> ScoreApi::bodyParam(const std::string& body, const std::string& name) {
+    const std::size_t first = body.find_first_not_of(" \t\r\n");
+    if (first == std::string::npos) {
+        return std::nullopt;
+    }
+
+    if (body[first] != '{') {
+        std::size_t start = 0;
+        while (start <= body.size()) {
+            std::size_t end = body.find('&', start);
+            if (end == std::string::npos) {
+                end = body.size();
+            }
+            const std::string pair = body.substr(start, end - start);
+            const std::size_t equals = pair.find('=');
+            if (equals != std::string::npos && pair.compare(0, equals, name) == 0 && equals == name.size()) {
+                std::string value = pair.substr(equals + 1);
+                value.erase(value.find_last_not_of(" \t\r\n") + 1);
+                return value;
+            }
+            start = end + 1;
+        }
+        return std::nullopt;
+    }
+
+    const std::string key = "\"" + name + "\"";
+    for (std::size_t at = body.find(key); at != std::string::npos; at = body.find(key, at + 1)) {
+        const std::size_t before = body.find_last_not_of(" \t\r\n", at == 0 ? 0 : at - 1);
+        if (at == 0 || before == std::string::npos || (body[before] != '{' && body[before] != ',')) {
+            continue;
+        }
+        std::size_t pos = body.find_first_not_of(" \t\r\n", at + key.size());
+        if (pos == std::string::npos || body[pos] != ':') {
+            continue;
+        }
+        pos = body.find_first_not_of(" \t\r\n", pos + 1);
+        if (pos == std::string::npos) {
+            return std::string();
+        }
+        if (body[pos] == '"') {
+            const std::size_t close = body.find('"', pos + 1);
+            return close == std::string::npos ? std::string() : body.substr(pos + 1, close - pos - 1);
+        }
+        const std::size_t end = body.find_first_of(",} \t\r\n", pos);
+        return body.substr(pos, end == std::string::npos ? std::string::npos : end - pos);
+    }
+    return std::nullopt;
+}
+
+// Reads a 1|2 parameter from the query string, falling back to a form or JSON body ("player=1", {"player": 1}).
+// Returns 0 when absent and -1 when present but anything other than exactly 1 or 2.
+int ScoreApi::playerParam(const HttpRequest& request, const std::string& name) {
+    std::string value;
+    const auto query = request.query.find(name);
+    if (query != request.query.end()) {
+        value = query->second;
+    }
+    else {
+        const std::optional<std::string> body_value = bodyParam(request.body, name);
+        if (!body_value) {
+            return 0;
+        }
+        value = *body_value;
+    }
+
+    if (value == "1") {
+        return 1;
+    }
+    if (value == "2") {
+        return 2;
+    }
+    return -1;
+}
@@ -0,0 +1,110 @@
+#include "ScoreEventBus.hpp"
+#include <algorithm>
+
+void ScoreSubscription::push(const ScoreDelta& delta) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (is_closed_) {
+            return;
+        }
+        const auto found = pending_index_.find(delta.match_id);
+        if (found != pending_index_.end()) {
+            ScoreDelta& pending = pending_[found->second];
+            const std::uint8_t events = pending.events | delta.events;
+            pending = delta;
+            pending.events = events;
+            ++coalesced_;
+            return;
+        }
+        pending_index_.emplace(delta.match_id, pending_.size());
+        pending_.push_back(delta);
+    }
+    available_.notify_one();
+}
+
+std::vector<ScoreDelta> ScoreSubscription::wait(const std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    available_.wait_for(lock, timeout, [this] { return !pending_.empty() || is_closed_; });
+
+    std::vector<ScoreDelta> deltas;
+    if (!is_closed_) {
+        deltas.swap(pending_);
+        pending_index_.clear();
+    }
+    return deltas;
+}
+
+void ScoreSubscription::close() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        is_closed_ = true;
+    }
+    available_.notify_all();
+}
+
+bool ScoreSubscription::isClosed() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return is_closed_;
+}
+
+unsigned long long ScoreSubscription::getCoalesced() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return coalesced_;
+}
+
+ScoreEventBus& ScoreEventBus::getInstance() {
+    static ScoreEventBus instance;
+    return instance;
+}
+
+void ScoreEventBus::publish(const int match_id, const CompactScore& score, const std::uint8_t events) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const ScoreDelta delta{ match_id, next_version_++, score, events };
+    latest_[match_id] = delta;
+
+    for (const auto& weak : subscribers_) {
+        if (const std::shared_ptr<ScoreSubscription> subscription = weak.lock()) {
+            if (subscription->wants(match_id)) {
+                subscription->push(delta);
+            }
+        }
+    }
+}
+
+std::shared_ptr<ScoreSubscription> ScoreEventBus::subscribe(const int match_id) {
+    auto subscription = std::make_shared<ScoreSubscription>(match_id);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    subscribers_.erase(std::remove_if(subscribers_.begin(), subscribers_.end(),
+        [](const std::weak_ptr<ScoreSubscription>& weak) { return weak.expired(); }), subscribers_.end());
+
+    std::vector<ScoreDelta> initial;
+    for (const auto& [id, delta] : latest_) {
+        if (subscription->wants(id)) {
+            initial.push_back(delta);
+        }
+    }
+    std::sort(initial.begin(), initial.end(), [](const ScoreDelta& a, const ScoreDelta& b) { return a.version < b.version; });
+    for (const ScoreDelta& delta : initial) {
+        subscription->push(delta);
+    }
+
+    subscribers_.push_back(subscription);
+    return subscription;
+}
+
+std::size_t ScoreEventBus::getSubscriberCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return static_cast<std::size_t>(std::count_if(subscribers_.begin(), subscribers_.end(),
+        [](const std::weak_ptr<ScoreSubscription>& weak) { return !weak.expired(); }));
+}
+
+// Wakes every waiting viewer so streaming connections can finish during shutdown.
+void ScoreEventBus::closeAll() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& weak : subscribers_) {
+        if (const std::shared_ptr<ScoreSubscription> subscription = weak.lock()) {
+            subscription->close();
+        }
+    }
+}
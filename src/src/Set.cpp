@@ -1,5 +1,8 @@
 #include "Set.hpp"
 #include "DatabaseConnection.hpp"
+#include "PersistenceQueue.hpp"
+#include "PreparedStatements.hpp"
+#include "QueryMetrics.hpp"
 #include <iostream>
 #include "Tiebreak.hpp"
 #include "UIManager.hpp"
@@ -33,15 +36,15 @@ Set::Set(const int match_id, const int no_sets, const int set_num, const int gam
 	std::cout << "Current score in " << set_num << " set: \t" << games_player1 << " - " << games_player2 << '\n';
 }
 
-int Set::addGameResult(const int winning_player_id) {
-	updateTime();
+int Set::addGameResult(const int winning_player_id, UnitOfWork& uow, const TiebreakInput& tiebreak_input) {
+	updateTime(uow);
 	if (winning_player_id == 1) {
 		games_player1++;
-		updateMatchSetRecordWithoutServingPlayerId();
+		updateMatchSetRecordWithoutServingPlayerId(uow);
 	}
 	else if (winning_player_id == 2) {
 		games_player2++;
-		updateMatchSetRecordWithoutServingPlayerId();
+		updateMatchSetRecordWithoutServingPlayerId(uow);
 	}
 	else if (winning_player_id != 0) {
 		std::cerr << "Invalid player ID: " << winning_player_id << '\n';
@@ -56,6 +59,7 @@ int Set::addGameResult(const int winning_player_id) {
 		return winner;
 	}
 	else if (isTieBreak()) {
+		uow.commit();
 		const int tiebreak_points = getTiebreakPoints();
 		int no_point;
 		Tiebreak tiebreak;
@@ -70,12 +74,15 @@ int Set::addGameResult(const int winning_player_id) {
 		}
 		else
 		{
-			auto scores = getTieBreakScores();
+			const auto scores = resumed_tiebreak_points.has_value() ? *resumed_tiebreak_points : getTieBreakScores();
 			if (scores.first != -1 && scores.second != -1) {
 				bool is_player_one_serving_var;
 				no_point = scores.first + scores.second;
 
-				if (no_point % 4 == 0 || no_point % 4 == 3) {
+				if (resumed_tiebreak_server.has_value()) {
+					is_player_one_serving_var = *resumed_tiebreak_server;
+				}
+				else if (no_point % 4 == 0 || no_point % 4 == 3) {
 					is_player_one_serving_var = getIsPlayerOneServing();
 				}
 				else {
@@ -111,7 +118,7 @@ int Set::addGameResult(const int winning_player_id) {
 			bool is_continuing = true;
 			int return_value = 0;
 
-			switch (const int choice = getNumericInput("===================================\n"
+			switch (const int choice = tiebreak_input ? tiebreak_input() : getNumericInput("===================================\n"
 											  "Enter 1 for Player 1 point, 2 for Player 2 point, 3 to suspend, 4 to finish match: ")) {
 			case 1:
 				tiebreak.addPoint(1, match_id);
@@ -160,7 +167,7 @@ int Set::addGameResult(const int winning_player_id) {
 			games_player2++;
 		}
 
-		updateMatchSetRecordWithoutServingPlayerId();
+		updateMatchSetRecordWithoutServingPlayerId(uow);
 
 		tiebreak.updateInDatabase(match_id);
 		printGameInfo();
@@ -174,8 +181,8 @@ int Set::addGameResult(const int winning_player_id) {
 
 bool Set::isTieBreak() const
 {
-	if (games_player1 == 6 && games_player2 == 6) {
-		if ((set_num * 2 - 1) == no_sets) {
+	if (ScoringEngine::isTiebreak(games_player1, games_player2)) {
+		if (getTiebreakPoints() == ScoringEngine::SUPER_TIEBREAK_POINTS) {
 			std::cout << "Super tiebreak in set " << set_num << '\n';
 		}
 		else {
@@ -186,88 +193,80 @@ bool Set::isTieBreak() const
 	return false;
 }
 
-void Set::addMatchSetRecord() {
-	const long long elapsed_seconds = timer.stop();
-	duration += std::chrono::seconds(elapsed_seconds);
-	timer.start();
-	saveSetRecordToDatabase(true);
+void Set::addMatchSetRecord(UnitOfWork& uow) {
+	duration += std::chrono::seconds(takeElapsedSeconds());
+	saveSetRecordToDatabase(true, uow);
 }
 
-void Set::updateMatchSetRecord() {
-	const long long elapsed_seconds = timer.stop();
-	duration += std::chrono::seconds(elapsed_seconds);
-	timer.start();
-	saveSetRecordToDatabase(false);
+void Set::updateMatchSetRecord(UnitOfWork& uow) {
+	duration += std::chrono::seconds(takeElapsedSeconds());
+	saveSetRecordToDatabase(false, uow);
 }
 
-void Set::saveSetRecordToDatabase(const bool is_new_record) const {
-	DatabaseConnection& db = DatabaseConnection::getInstance();
-	try {
-		pqxx::work txn(*db.getConnection());
-		std::string query;
-		if (is_new_record) {
-			query = "INSERT INTO matches_sets (match_id, set_number, games_won_player1, games_won_player2, is_first_player_serving) VALUES (" +
-				txn.quote(match_id) + ", " +
-				txn.quote(set_num) + ", " +
-				txn.quote(games_player1) + ", " +
-				txn.quote(games_player2) + ", " +
-				txn.quote(is_player_one_serving) + ")";
-		}
-		else {
-			query = "UPDATE matches_sets SET games_won_player1 = " + txn.quote(games_player1) + ", " +
-				"games_won_player2 = " + txn.quote(games_player2) + ", " +
-				"is_first_player_serving = " + txn.quote(is_player_one_serving) + ", " +
-				" WHERE match_id = " + txn.quote(match_id) + " AND set_number = " + txn.quote(set_num);
-		}
-		txn.exec(query);
-		txn.commit();
+void Set::saveSetRecordToDatabase(const bool is_new_record, UnitOfWork& uow) const {
+	const int set_match_id = match_id;
+	const int set_number = set_num;
+	const int games_won_player1 = games_player1;
+	const int games_won_player2 = games_player2;
+	const bool is_first_player_serving = is_player_one_serving;
+
+	if (is_new_record) {
+		uow.add([=](pqxx::work& txn) {
+			PreparedStatements::exec<InsertMatchSetQuery>(txn, set_match_id, set_number, games_won_player1, games_won_player2, is_first_player_serving);
+		});
 	}
-	catch (const std::exception& e) {
-		std::cerr << "Error saving set record to database: " << e.what() << '\n';
-		throw;
+	else {
+		uow.add([=](pqxx::work& txn) {
+			PreparedStatements::exec<UpdateMatchSetQuery>(txn, games_won_player1, games_won_player2, is_first_player_serving, set_match_id, set_number);
+		});
 	}
 }
 
 void Set::updateTiebreakStatus() const {
-	DatabaseConnection& db = DatabaseConnection::getInstance();
-	try {
-		pqxx::work txn(*db.getConnection());
-		const std::string query = "UPDATE matches_sets SET is_tie_break = TRUE WHERE match_id = " +
-			txn.quote(match_id) + " AND set_number = " + txn.quote(set_num);
-		txn.exec(query);
-		txn.commit();
-	}
-	catch (const std::exception& e) {
-		std::cerr << "Error marking set as tiebreak in database: " << e.what() << '\n';
-		throw;
-	}
+	const int set_match_id = match_id;
+	const int set_number = set_num;
+
+	PersistenceQueue::getInstance().enqueue(match_id, [=](pqxx::work& txn) {
+		PreparedStatements::exec<MarkSetTiebreakQuery>(txn, set_match_id, set_number);
+	});
+}
+
+void Set::updateMatchSetRecordWithoutServingPlayerId(UnitOfWork& uow) {
+	duration += std::chrono::seconds(takeElapsedSeconds());
+
+	const int set_match_id = match_id;
+	const int set_number = set_num;
+	const int games_won_player1 = games_player1;
+	const int games_won_player2 = games_player2;
+
+	uow.add([=](pqxx::work& txn) {
+		PreparedStatements::exec<UpdateSetGamesQuery>(txn, games_won_player1, games_won_player2, set_match_id, set_number);
+	});
 }
 
-void Set::updateMatchSetRecordWithoutServingPlayerId() {
+long long Set::takeElapsedSeconds() {
 	const long long elapsed_seconds = timer.stop();
-	duration += std::chrono::seconds(elapsed_seconds);
 	timer.start();
-	DatabaseConnection& db = DatabaseConnection::getInstance();
-	try {
-		pqxx::work txn(*db.getConnection());
-		const std::string query = "UPDATE matches_sets SET " +
-			std::string("games_won_player1 = ") + txn.quote(games_player1) + ", " +
-			"games_won_player2 = " + txn.quote(games_player2) +
-			" WHERE match_id = " + txn.quote(match_id) + " AND set_number = " + txn.quote(set_num);
-		txn.exec(query);
-		txn.commit();
-	}
-	catch (const std::exception& e) {
-		std::cerr << "Error updating set record in database: " << e.what() << '\n';
-		throw;
+	return elapsed_seconds;
+}
+
+void Set::resumeCurrentGame(const int points_player1, const int points_player2, const bool is_serving) {
+	if (!current_game.has_value()) {
+		current_game = Game(points_player1, points_player2, games_player1 + games_player2 + 1);
+		current_game->printGameInfo();
+		current_game->setIsPlayerOneServing(is_serving);
+		std::cout << "  Player " << (is_serving ? "1" : "2") << " is serving.\n";
+		current_game->printCurScore();
 	}
 }
 
+// For matches without a point log: the current game is read back from game_points.
 void Set::resumeCurrentGame(const bool is_serving) {
 	if (!current_game.has_value()) {
 		DatabaseConnection& db = DatabaseConnection::getInstance();
 		try {
-			pqxx::nontransaction nt(*db.getConnection());
+			ConnectionLease lease = db.acquire();
+			TracedNontransaction nt(*lease, "Set::resumeCurrentGame");
 			const std::string query =
 				"SELECT match_id, set_number, game_number, player1_points, player2_points "
 				"FROM public.game_points "
@@ -289,6 +288,7 @@ void Set::resumeCurrentGame(const bool is_serving) {
 				}
 
 				current_game = Game(player1_points, player2_points, game_number);
+				current_game->printGameInfo();
 				current_game->setIsPlayerOneServing(is_serving);
 				std::cout << "  Player " << (is_serving ? "1" : "2") << " is serving.\n";
 				current_game->printCurScore();
@@ -316,7 +316,8 @@ int Set::convertScore(const std::string& db_score) {
 std::pair<int, int> Set::getTieBreakScores() const {
 	DatabaseConnection& db = DatabaseConnection::getInstance();
 	try {
-		pqxx::nontransaction nt(*db.getConnection());
+		ConnectionLease lease = db.acquire();
+		TracedNontransaction nt(*lease, "Set::getTieBreakScores");
 		const std::string query =
 			"SELECT player1_score, player2_score "
 			"FROM public.tie_breaks "
@@ -341,33 +342,11 @@ std::pair<int, int> Set::getTieBreakScores() const {
 }
 
 void Set::updateTime() {
-	const long long elapsed_seconds = timer.stop();
-	duration = std::chrono::seconds(elapsed_seconds);
-	timer.start();
-
-	DatabaseConnection& db = DatabaseConnection::getInstance();
-	try {
-		pqxx::work w(*db.getConnection());
-
-		const int duration_seconds = std::chrono::duration_cast<std::chrono::seconds>(duration).count();
-		const int hours = duration_seconds / 3600;
-		const int minutes = (duration_seconds % 3600) / 60;
-		const int seconds = duration_seconds % 60;
-
-		const std::string interval_string = std::to_string(hours) + " hours " +
-			std::to_string(minutes) + " minutes " +
-			std::to_string(seconds) + " seconds";
-
-		const std::string match_query = "UPDATE public.matches SET duration = duration + interval '" +
-			interval_string + "' WHERE id = " + w.quote(match_id) + ";";
+	duration = std::chrono::seconds(takeElapsedSeconds());
+	PersistenceQueue::getInstance().addDuration(match_id, duration.count());
+}
 
-		w.exec(match_query);
-		w.commit();
-	}
-	catch (const pqxx::sql_error& e) {
-		std::cerr << "SQL error in updateTime: " << e.what() << '\n';
-	}
-	catch (const std::exception& e) {
-		std::cerr << "Exception in updateTime: " << e.what() << '\n';
-	}
+void Set::updateTime(UnitOfWork& uow) {
+	duration = std::chrono::seconds(takeElapsedSeconds());
+	uow.addDuration(duration.count());
 }
\ No newline at end of file
@@ -0,0 +1,177 @@
+#include "TableWriter.hpp"
+#include <cctype>
+
+TableWriter::TableWriter(std::ostream& out, std::vector<TableColumn> columns, const TableFormat format)
+    : out_(out), columns_(std::move(columns)), format_(format) {
+    keys_.reserve(columns_.size());
+    for (const auto& column : columns_) {
+        std::string key;
+        for (const char c : column.title) {
+            key += std::isalnum(static_cast<unsigned char>(c)) ? static_cast<char>(std::tolower(static_cast<unsigned char>(c))) : '_';
+        }
+        keys_.push_back(key);
+    }
+}
+
+void TableWriter::writeRow(const std::vector<std::string>& cells) {
+    if (rows_ == 0) {
+        writeHeader();
+    }
+
+    switch (format_) {
+    case TABLE_TEXT:
+        writeText(cells);
+        break;
+    case TABLE_CSV:
+        writeCsv(cells);
+        break;
+    case TABLE_JSON:
+        writeJson(cells);
+        break;
+    }
+    ++rows_;
+}
+
+void TableWriter::writeRow(const pqxx::row& row) {
+    std::vector<std::string> cells;
+    cells.reserve(columns_.size());
+    for (const auto& field : row) {
+        if (cells.size() == columns_.size()) {
+            break;
+        }
+        cells.emplace_back(field.is_null() ? "" : field.c_str());
+    }
+    writeRow(cells);
+}
+
+void TableWriter::finish() {
+    if (is_finished_) {
+        return;
+    }
+    is_finished_ = true;
+
+    if (format_ == TABLE_JSON) {
+        out_ << (rows_ == 0 ? "[]\n" : "\n]\n");
+    }
+    out_.flush();
+}
+
+// The header goes out with the first row, so an empty listing prints nothing and callers can report it their own way.
+void TableWriter::writeHeader() {
+    switch (format_) {
+    case TABLE_TEXT: {
+        std::string rule;
+        for (std::size_t i = 0; i < columns_.size(); ++i) {
+            out_ << (i == 0 ? "" : " | ") << fit(columns_[i].title, columns_[i].width);
+            rule += (i == 0 ? "" : "-+-") + std::string(columns_[i].width, '-');
+        }
+        out_ << '\n' << rule << '\n';
+        break;
+    }
+    case TABLE_CSV:
+        for (std::size_t i = 0; i < columns_.size(); ++i) {
+            out_ << (i == 0 ? "" : ",") << escapeCsv(columns_[i].title);
+        }
+        out_ << "\r\n";
+        break;
+    case TABLE_JSON:
+        out_ << '[';
+        break;
+    }
+}
+
+void TableWriter::writeText(const std::vector<std::string>& cells) {
+    for (std::size_t i = 0; i < columns_.size(); ++i) {
+        out_ << (i == 0 ? "" : " | ") << fit(i < cells.size() ? cells[i] : "", columns_[i].width);
+    }
+    out_ << '\n';
+}
+
+void TableWriter::writeCsv(const std::vector<std::string>& cells) {
+    for (std::size_t i = 0; i < columns_.size(); ++i) {
+        out_ << (i == 0 ? "" : ",") << escapeCsv(i < cells.size() ? cells[i] : "");
+    }
+    out_ << "\r\n";
+}
+
+void TableWriter::writeJson(const std::vector<std::string>& cells) {
+    out_ << (rows_ == 0 ? "\n  {" : ",\n  {");
+    for (std::size_t i = 0; i < columns_.size(); ++i) {
+        const std::string cell = i < cells.size() ? cells[i] : "";
+        out_ << (i == 0 ? "\"" : ", \"") << keys_[i] << "\": ";
+        if (cell.empty()) {
+            out_ << "null";
+        }
+        else if (columns_[i].is_numeric) {
+            out_ << cell;
+        }
+        else {
+            out_ << '"' << escapeJson(cell) << '"';
+        }
+    }
+    out_ << '}';
+}
+
+std::size_t TableWriter::streamQuery(pqxx::work& txn, const std::string& query, TableWriter& writer, const std::size_t fetch_size) {
+    const std::size_t before = writer.getRowCount();
+    txn.exec("DECLARE table_writer_cursor NO SCROLL CURSOR FOR " + query);
+
+    const std::string fetch = "FETCH FORWARD " + std::to_string(fetch_size) + " FROM table_writer_cursor";
+    while (true) {
+        const pqxx::result batch = txn.exec(fetch);
+        for (const auto& row : batch) {
+            writer.writeRow(row);
+        }
+        if (static_cast<std::size_t>(batch.size()) < fetch_size) {
+            break;
+        }
+    }
+
+    txn.exec("CLOSE table_writer_cursor");
+    return writer.getRowCount() - before;
+}
+
+// Over-long cells are cut and marked with '~' so every row keeps the same width.
+std::string TableWriter::fit(const std::string& cell, const std::size_t width) {
+    if (cell.size() > width) {
+        return width == 0 ? "" : cell.substr(0, width - 1) + '~';
+    }
+    return cell + std::string(width - cell.size(), ' ');
+}
+
+std::string TableWriter::escapeCsv(const std::string& cell) {
+    if (cell.find_first_of(",\"\r\n") == std::string::npos) {
+        return cell;
+    }
+    std::string escaped = "\"";
+    for (const char c : cell) {
+        if (c == '"') {
+            escaped += '"';
+        }
+        escaped += c;
+    }
+    escaped += '"';
+    return escaped;
+}
+
+std::string TableWriter::escapeJson(const std::string& cell) {
+    static const char* const HEX = "0123456789abcdef";
+    std::string escaped;
+    escaped.reserve(cell.size());
+    for (const char c : cell) {
+        const auto byte = static_cast<unsigned char>(c);
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+            escaped += c;
+        }
+        else if (byte < 0x20) {
+            escaped += "\\u00";
+            escaped += HEX[byte >> 4];
+            escaped += HEX[byte & 0xF];
+        }
+        else {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
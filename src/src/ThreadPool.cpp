@@ -0,0 +1,101 @@
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <iostream>
+
+thread_local ThreadPool* ThreadPool::current_pool_ = nullptr;
+thread_local std::size_t ThreadPool::current_index_ = 0;
+
+ThreadPool::ThreadPool(const unsigned threads) {
+    const unsigned thread_count = threads == 0 ? std::max(1u, std::thread::hardware_concurrency()) : threads;
+    for (unsigned i = 0; i < thread_count; ++i) {
+        queues_.push_back(std::make_unique<WorkQueue>());
+    }
+    for (unsigned i = 0; i < thread_count; ++i) {
+        workers_.emplace_back(&ThreadPool::run, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+        is_stopping_ = true;
+    }
+    work_available_.notify_all();
+
+    for (auto& worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+// Tasks submitted from a worker stay on that worker's deque; others are spread round-robin.
+void ThreadPool::submit(Task task) {
+    const std::size_t index = current_pool_ == this
+        ? current_index_
+        : next_queue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+
+    pending_.fetch_add(1, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+        queues_[index]->tasks.push_back(std::move(task));
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+    }
+    work_available_.notify_one();
+}
+
+void ThreadPool::run(const std::size_t index) {
+    current_pool_ = this;
+    current_index_ = index;
+
+    while (true) {
+        Task task;
+        if (popLocal(index, task) || steal(index, task)) {
+            pending_.fetch_sub(1, std::memory_order_acq_rel);
+            try {
+                task();
+            }
+            catch (const std::exception& e) {
+                std::cerr << "Exception in thread pool task: " << e.what() << '\n';
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleep_mutex_);
+        work_available_.wait(lock, [this] { return pending_.load(std::memory_order_acquire) > 0 || is_stopping_; });
+        if (is_stopping_ && pending_.load(std::memory_order_acquire) == 0) {
+            break;
+        }
+    }
+
+    current_pool_ = nullptr;
+}
+
+bool ThreadPool::popLocal(const std::size_t index, Task& task) {
+    WorkQueue& queue = *queues_[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) {
+        return false;
+    }
+    task = std::move(queue.tasks.front());
+    queue.tasks.pop_front();
+    return true;
+}
+
+bool ThreadPool::steal(const std::size_t index, Task& task) {
+    for (std::size_t offset = 1; offset < queues_.size(); ++offset) {
+        WorkQueue& queue = *queues_[(index + offset) % queues_.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) {
+            continue;
+        }
+        task = std::move(queue.tasks.back());
+        queue.tasks.pop_back();
+        steals_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
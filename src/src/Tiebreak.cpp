@@ -1,5 +1,9 @@
 #include "Tiebreak.hpp"
-#include "DatabaseConnection.hpp"
+#include "PersistenceQueue.hpp"
+#include "PointLog.hpp"
+#include "PreparedStatements.hpp"
+#include "ReferenceData.hpp"
+#include "ScoringEngine.hpp"
 #include <iostream>
 
 Tiebreak::Tiebreak(const bool is_player_one_serving, const int set_num, const int max_points)
@@ -22,6 +26,10 @@ Tiebreak::Tiebreak(const bool is_player_one_serving, const int set_num, const in
 
 void Tiebreak::addPoint(const int player, const int match_id)
 {
+    if (player == 1 || player == 2) {
+        PointLog::getInstance().record(match_id, player, is_player_one_serving);
+    }
+
     if (player == 1) {
         points_player1++;
         std::cout << "Point for player 1.\n";
@@ -40,19 +48,12 @@ void Tiebreak::addPoint(const int player, const int match_id)
 
 bool Tiebreak::isTiebreakWon() const
 {
-    return (points_player1 >= max_points && (points_player1 - points_player2) >= 2) ||
-        (points_player2 >= max_points && (points_player2 - points_player1) >= 2);
+    return winner() != 0;
 }
 
 int Tiebreak::winner() const
 {
-    if (points_player1 >= max_points && (points_player1 - points_player2) >= 2) {
-        return 1;
-    }
-    else if (points_player2 >= max_points && (points_player2 - points_player1) >= 2) {
-        return 2;
-    }
-    return 0;
+    return ScoringEngine::tiebreakWinner(points_player1, points_player2, max_points);
 }
 
 int Tiebreak::determineWinner() const
@@ -69,53 +70,31 @@ int Tiebreak::determineWinner() const
 
 void Tiebreak::saveToDatabase(const int match_id) const
 {
-    DatabaseConnection& db = DatabaseConnection::getInstance();
-    try {
-        pqxx::work txn(*db.getConnection());
-        const std::string type_query = "SELECT type_id FROM tie_break_type WHERE min_points = " + txn.quote(max_points);
-        const pqxx::result result = txn.exec(type_query);
+    const std::optional<int> tiebreak_type_id = ReferenceData::getInstance().getTiebreakTypeId(max_points);
+    if (!tiebreak_type_id) {
+        throw std::runtime_error("No matching tie_break_type found for maxPoints: " + std::to_string(max_points));
+    }
 
-        if (result.empty()) {
-            throw std::runtime_error("No matching tie_break_type found for maxPoints: " + std::to_string(max_points));
-        }
+    const int tiebreak_set_num = set_num;
+    const int player1_score = points_player1;
+    const int player2_score = points_player2;
+    const int type_id = *tiebreak_type_id;
 
-        const int tiebreak_type_id = result[0][0].as<int>();
-        const std::string insert_query = "INSERT INTO tie_breaks (match_id, set_number, player1_score, player2_score, tie_break_type) VALUES (" +
-            txn.quote(match_id) + ", " +
-            txn.quote(set_num) + ", " +
-            txn.quote(points_player1) + ", " +
-            txn.quote(points_player2) + ", " +
-            txn.quote(tiebreak_type_id) + ")";
-        txn.exec(insert_query);
-        txn.commit();
-    }
-    catch (const pqxx::sql_error& e) {
-        std::cerr << "SQL Error: " << e.what() << '\n';
-        std::cerr << "Query was: " << e.query() << '\n';
-        throw;
-    }
-    catch (const std::exception& e) {
-        std::cerr << "Error saving tiebreak to database: " << e.what() << '\n';
-        throw;
-    }
+    // Queued ahead of this tiebreak's keyed updates, so the row exists before they run.
+    PersistenceQueue::getInstance().enqueue(match_id, [=](pqxx::work& txn) {
+        PreparedStatements::exec<InsertTiebreakQuery>(txn, match_id, tiebreak_set_num, player1_score, player2_score, type_id);
+    });
 }
 
 void Tiebreak::updateInDatabase(const int match_id) const
 {
-    DatabaseConnection& db = DatabaseConnection::getInstance();
-    try {
-        pqxx::work txn(*db.getConnection());
-        const std::string update_query = "UPDATE tie_breaks SET player1_score = " + txn.quote(points_player1) + ", " +
-            "player2_score = " + txn.quote(points_player2) +
-            " WHERE match_id = " + txn.quote(match_id) +
-            " AND set_number = " + txn.quote(set_num);
-        txn.exec(update_query);
-        txn.commit();
-    }
-    catch (const std::exception& e) {
-        std::cerr << "Error updating tiebreak in database: " << e.what() << '\n';
-        throw;
-    }
+    const int tiebreak_set_num = set_num;
+    const int player1_score = points_player1;
+    const int player2_score = points_player2;
+
+    PersistenceQueue::getInstance().enqueue(match_id, "tiebreak:" + std::to_string(set_num), [=](pqxx::work& txn) {
+        PreparedStatements::exec<UpdateTiebreakQuery>(txn, player1_score, player2_score, match_id, tiebreak_set_num);
+    });
 }
 
 void Tiebreak::printServingPlayer() const
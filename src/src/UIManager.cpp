@@ -1,7 +1,20 @@
 #include "UIManager.hpp"
 #include "Player.hpp"
 #include "Match.hpp"
+#include "KeysetPager.hpp"
+#include "DelimitedFile.hpp"
+#include "TableWriter.hpp"
+#include "PlayerImporter.hpp"
+#include "ScheduleImporter.hpp"
+#include "LiveScoreCache.hpp"
+#include "MatchHistoryIndex.hpp"
+#include "PlayerSearchIndex.hpp"
+#include "RatingEngine.hpp"
+#include "ReferenceData.hpp"
 #include "validate.hpp"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
 #include <iostream>
 #include <tabulate/table.hpp>
 
@@ -22,6 +35,41 @@ int getNumericInput(const std::string& prompt) {
 	}
 }
 
+int getPlayerInput(const std::string& prompt) {
+	std::string input;
+	while (input.empty()) {
+		std::cout << prompt;
+		if (!std::getline(std::cin, input)) {
+			return 0;
+		}
+		input = DelimitedFile::trim(input);
+	}
+
+	std::size_t parsed = 0;
+	try {
+		const int player_id = std::stoi(input, &parsed);
+		if (parsed == input.size()) {
+			return player_id;
+		}
+	}
+	catch (const std::exception&) {
+	}
+
+	const std::vector<PlayerMatch> matches = PlayerSearchIndex::getInstance().search(input);
+	if (matches.empty()) {
+		std::cout << "No players match \"" << input << "\".\n";
+		return 0;
+	}
+	for (std::size_t i = 0; i < matches.size(); ++i) {
+		std::cout << i + 1 << ". " << matches[i].first_name << ' ' << matches[i].last_name << " (ID " << matches[i].player_id << ")\n";
+	}
+	const int choice = getNumericInput("Choose a player (0 to cancel): ");
+	if (choice < 1 || choice > static_cast<int>(matches.size())) {
+		return 0;
+	}
+	return matches[choice - 1].player_id;
+}
+
 void UIManager::addPlayer() {
 	std::string first_name, last_name;
 	char confirmation;
@@ -46,13 +94,13 @@ void UIManager::addPlayer() {
 }
 
 void UIManager::showPlayers() {
-	const int player_id = getNumericInput("Enter Player ID (or -1 for all): ");
+	const int player_id = getPlayerInput("Enter Player ID or name (or -1 for all): ");
 	Player::showPlayerStatistics(player_id);
 }
 
 void UIManager::addMatch() {
-	const int player1_id = getNumericInput("Enter Player 1 ID: ");
-	const int player2_id = getNumericInput("Enter Player 2 ID: ");
+	const int player1_id = getPlayerInput("Enter Player 1 ID or name: ");
+	const int player2_id = getPlayerInput("Enter Player 2 ID or name: ");
 
 	if (player1_id == player2_id) {
 		std::cerr << "Player IDs must be different.\n";
@@ -100,9 +148,7 @@ void UIManager::addMatch() {
 
 void UIManager::showMatches() {
 	const int match_id = getNumericInput("Enter match ID (or -1 for all): ");
-	DatabaseConnection& db = DatabaseConnection::getInstance();
-	pqxx::connection* conn = db.getConnection();
-	std::string query = R"(
+	const KeysetPager pager(R"(
 	    SELECT m.id, ms.status, m.player_id1, m.player_id2, 
 	           COALESCE(m.winner_id::text, 'N/A') AS winner_id,
 	           m.predicted_start_time, 
@@ -111,41 +157,21 @@ void UIManager::showMatches() {
 	           COALESCE(m.actual_start_time::text, 'N/A') AS actual_start_time
 	    FROM public.matches m
 	    JOIN public.match_status ms ON m.status_id = ms.id
-	)";
-
-	if (match_id != -1) {
-		query += " WHERE m.id = $1";
-	}
-
-	query += " ORDER BY m.id ASC";
+	)", "m.id", match_id != -1 ? "m.id = " + std::to_string(match_id) : "");
 
-	try {
-		pqxx::nontransaction nt(*conn);
-		pqxx::result result = (match_id != -1) ? nt.exec_params(query, match_id) : nt.exec(query);
+	TableWriter writer(std::cout, {
+		{ "ID", 6, true }, { "Status", 10 }, { "Player ID1", 10, true }, { "Player ID2", 10, true }, { "Winner ID", 9 },
+		{ "Predicted Start Time", 20 }, { "Duration", 8 }, { "No Sets", 7, true }, { "Actual Start Time", 26 } });
 
-		if (result.empty()) {
-			std::cout << (match_id == -1 ? "No matches found." : "No match with id " + std::to_string(match_id) + " found.") << '\n';
+	pager.run([&writer](const pqxx::result& page) {
+		for (const auto& row : page) {
+			writer.writeRow(row);
 		}
-		else {
-			tabulate::Table table;
-			table.add_row({ "ID", "Status", "Player ID1", "Player ID2", "Winner ID", "Predicted Start Time", "Duration", "No Sets", "Actual Start Time" });
-
-			for (const auto& row : result) {
-				table.add_row({
-					row[0].as<std::string>(), row[1].as<std::string>(), row[2].as<std::string>(),
-					row[3].as<std::string>(), row[4].as<std::string>(), row[5].as<std::string>(),
-					row[6].as<std::string>(), row[7].as<std::string>(), row[8].as<std::string>()
-					});
-			}
+	});
+	writer.finish();
 
-			std::cout << table << '\n';
-		}
-	}
-	catch (const pqxx::sql_error& e) {
-		std::cerr << "SQL error: " << e.what() << " Query: " << e.query() << '\n';
-	}
-	catch (const std::exception& e) {
-		std::cerr << "Database error: " << e.what() << '\n';
+	if (writer.getRowCount() == 0) {
+		std::cout << (match_id == -1 ? "No matches found." : "No match with id " + std::to_string(match_id) + " found.") << '\n';
 	}
 }
 
@@ -225,6 +251,15 @@ void UIManager::run() {
 			<< "7. Show Match Details\n"
 			<< "8. Start Match\n"
 			<< "9. Resume Match\n"
+			<< "10. Show Live Scores\n"
+			<< "11. Export Matches\n"
+			<< "12. Import Players\n"
+			<< "13. Import Schedule\n"
+			<< "14. Show Leaderboard\n"
+			<< "15. Recompute Ratings\n"
+			<< "16. Show Head-to-Head\n"
+			<< "17. Search Players\n"
+			<< "18. Show Player's Match History\n"
 			<< "0. Exit\n"
 			<< "***************************************\n";
 
@@ -256,6 +291,33 @@ void UIManager::run() {
 		case 9:
 			resumeMatch();
 			break;
+		case 10:
+			showLiveScores();
+			break;
+		case 11:
+			exportMatches();
+			break;
+		case 12:
+			importPlayers();
+			break;
+		case 13:
+			importSchedule();
+			break;
+		case 14:
+			showLeaderboard();
+			break;
+		case 15:
+			recomputeRatings();
+			break;
+		case 16:
+			showHeadToHead();
+			break;
+		case 17:
+			searchPlayers();
+			break;
+		case 18:
+			showPlayerHistory();
+			break;
 		case 0:
 			std::cout << "Exiting program.\n";
 			return;
@@ -288,7 +350,8 @@ void UIManager::resumeMatch()
 				bool is_ended = false;
 
 				if (match.getCurrentSet()->getIsResumedTiebreak()) {
-					switch (const int game_status = match.getCurrentSet()->addGameResult(0)) {
+					UnitOfWork uow(match.getId());
+					switch (const int game_status = match.getCurrentSet()->addGameResult(0, uow)) {
 					case 10:
 						match.suspendMatch();
 						exit_outer_loop = true;
@@ -301,9 +364,10 @@ void UIManager::resumeMatch()
 						exit_outer_loop = true;
 						break;
 					default:
-						handleSetContinuation(match, game_status);
+						handleSetContinuation(match, game_status, uow);
 						break;
 					}
+					uow.commit();
 				}
 
 				updateMatchStatus(match);
@@ -391,14 +455,7 @@ void UIManager::handleMatchFinishing(Match& match) {
 }
 
 void UIManager::updateMatchStatus(Match& match) {
-	const int sets_player_one = match.getSetsPlayerOne();
-	const int sets_player_two = match.getSetsPlayerTwo();
-	const int no_sets = match.getNoSets();
-
-	if (sets_player_one >= no_sets || sets_player_two >= no_sets) {
-		const int winner_id = (sets_player_one > sets_player_two) ? match.getIdPlayerOne() : match.getIdPlayerTwo();
-		match.endMatch(winner_id);
-	}
+	match.endIfWon();
 }
 
 int UIManager::processGameEnd(Match& match)
@@ -410,8 +467,9 @@ int UIManager::processGameEnd(Match& match)
 	}
 
 	int return_value = 0;
+	UnitOfWork uow(match.getId());
 
-	switch (const int game_status = match.getCurrentSet()->addGameResult(is_game_ended)) {
+	switch (const int game_status = match.recordGame(is_game_ended, uow)) {
 	case 10:
 		handleMatchSuspension(match);
 		return_value = 10;
@@ -421,33 +479,19 @@ int UIManager::processGameEnd(Match& match)
 		return_value = 11;
 		break;
 	case 0:
-		match.getCurrentSet()->changeGame();
-		break;
 	case -1:
 		break;
 	default:
 		return_value = game_status;
-		if (game_status == 1) {
-			match.updateSetsPlayerOne();
-		}
-		else if (game_status == 2) {
-			match.updateSetsPlayerTwo();
-		}
-
 		std::cout << "Score in sets: \t" << match.getSetsPlayerOne() << " - " << match.getSetsPlayerTwo() << std::endl;
-		
-		match.updateMatchInDatabase();
-
-		if (!match.isMatchWinner()) {
-			match.updateCurrentSet(match.getId());
-		}
 		break;
 	}
 
+	uow.commit();
 	return return_value;
 }
 
-void UIManager::handleSetContinuation(Match& match, const int game_status) {
+void UIManager::handleSetContinuation(Match& match, const int game_status, UnitOfWork& uow) {
 	if (game_status == 1) {
 		match.updateSetsPlayerOne();
 	}
@@ -457,11 +501,12 @@ void UIManager::handleSetContinuation(Match& match, const int game_status) {
 
 	const int num_of_sets = match.getSetsPlayerOne() + match.getSetsPlayerTwo();
 	match.printScoreInfo();
-	match.updateMatchInDatabase();
+	match.updateMatchInDatabase(uow);
 
 	if (!match.isMatchWinner()) {
-		match.updateCurrentSet(match.getId());
+		match.updateCurrentSet(match.getId(), uow);
 	}
+	uow.commit();
 }
 
 void UIManager::handleMatchSuspension(Match& match) {
@@ -469,101 +514,187 @@ void UIManager::handleMatchSuspension(Match& match) {
 }
 
 void UIManager::showAllMatches() {
-	DatabaseConnection& db = DatabaseConnection::getInstance();
-	pqxx::nontransaction nt(*db.getConnection());
-
-	try {
-		const std::string query = R"(
+	const KeysetPager pager(R"(
         SELECT 
-            m.id, ms.status, 
-            p1.first_name || ' ' || p1.last_name AS player1_name, 
-            p2.first_name || ' ' || p2.last_name AS player2_name, 
-            COALESCE(w.first_name || ' ' || w.last_name, 'N/A') AS winner_name, 
-            m.no_sets AS no_sets, 
-            EXTRACT(HOUR FROM m.duration) || ':' || LPAD(EXTRACT(MINUTE FROM m.duration)::text, 2, '0') AS duration,
-			SUM(CASE WHEN (mse.games_won_player1 >= 6 AND mse.games_won_player1 >= mse.games_won_player2 + 2) OR mse.games_won_player1 = 7 THEN 1 ELSE 0 END) AS player1_sets_won,
-            SUM(CASE WHEN (mse.games_won_player2 >= 6 AND mse.games_won_player2 >= mse.games_won_player1 + 2) OR mse.games_won_player2 = 7 THEN 1 ELSE 0 END) AS player2_sets_won
+            match_id AS id, status, player1_name, player2_name, winner_name, no_sets, 
+            EXTRACT(HOUR FROM duration) || ':' || LPAD(EXTRACT(MINUTE FROM duration)::text, 2, '0') AS duration,
+            sets_won_player1 AS player1_sets_won, 
+            sets_won_player2 AS player2_sets_won
 		FROM 
-            public.matches m
-        JOIN 
-            public.players p1 ON m.player_id1 = p1.id
-        JOIN 
-            public.players p2 ON m.player_id2 = p2.id
-        LEFT JOIN 
-            public.players w ON m.winner_id = w.id
-        LEFT JOIN 
-            public.match_status ms ON m.status_id = ms.id
-        LEFT JOIN 
-            public.matches_sets mse ON m.id = mse.match_id
-        GROUP BY 
-		    m.id, ms.status, p1.first_name, p1.last_name, p2.first_name, p2.last_name, w.first_name, w.last_name, m.no_sets, m.duration
-		ORDER BY 
-			m.id ASC;
-    )";
-
-		pqxx::result r = nt.exec(query);
-
-		if (r.empty()) {
-			std::cout << "No matches found.\n";
+            public.match_summary
+    )", "match_id");
+
+	TableWriter writer(std::cout, MATCH_SUMMARY_COLUMNS);
+
+	pager.run([&writer](const pqxx::result& page) {
+		for (const auto& row : page) {
+			std::string sets_score = row["player1_sets_won"].as<std::string>() + ":" + row["player2_sets_won"].as<std::string>();
+
+			writer.writeRow({
+				row["id"].as<std::string>(),
+				row["status"].as<std::string>(),
+				row["player1_name"].as<std::string>(),
+				row["player2_name"].as<std::string>(),
+				row["winner_name"].as<std::string>(),
+				sets_score,
+				row["duration"].as<std::string>()
+				});
 		}
-		else {
-			tabulate::Table table;
-			table.add_row({ "ID", "Status", "Player 1", "Player 2", "Winner", "Score in Sets", "Duration" });
+	});
+	writer.finish();
 
-			for (const auto& row : r) {
-				std::string sets_score = row["player1_sets_won"].as<std::string>() + ":" + row["player2_sets_won"].as<std::string>();
+	if (writer.getRowCount() == 0) {
+		std::cout << "No matches found.\n";
+	}
+}
 
-				table.add_row({
-					row["id"].as<std::string>(),
-					row["status"].as<std::string>(),
-					row["player1_name"].as<std::string>(),
-					row["player2_name"].as<std::string>(),
-					row["winner_name"].as<std::string>(),
-					sets_score,
-					row["duration"].as<std::string>()
-					});
-			}
+void UIManager::exportMatches() {
+	const int format = getNumericInput("Format (1 = text, 2 = CSV, 3 = JSON): ");
+	if (format < 1 || format > 3) {
+		std::cout << "Invalid format.\n";
+		return;
+	}
+	std::cout << "Enter file name: ";
+	std::string file_name;
+	std::getline(std::cin, file_name);
 
-			std::cout << table << '\n';
-		}
+	std::ofstream file(file_name, std::ios::binary);
+	if (!file) {
+		std::cerr << "Cannot open " << file_name << " for writing.\n";
+		return;
+	}
+
+	TableWriter writer(file, MATCH_SUMMARY_COLUMNS, static_cast<TableFormat>(format - 1));
+	try {
+		ConnectionLease lease = DatabaseConnection::getInstance().acquire();
+		pqxx::work txn(*lease);
+		TableWriter::streamQuery(txn, R"(
+            SELECT 
+                match_id, status, player1_name, player2_name, winner_name, 
+                sets_won_player1 || ':' || sets_won_player2 AS sets_score,
+                EXTRACT(HOUR FROM duration) || ':' || LPAD(EXTRACT(MINUTE FROM duration)::text, 2, '0') AS duration
+            FROM public.match_summary
+            ORDER BY match_id
+        )", writer);
+		txn.commit();
+	}
+	catch (const pqxx::sql_error& e) {
+		std::cerr << "SQL error: " << e.what() << " Query: " << e.query() << '\n';
 	}
 	catch (const std::exception& e) {
-		std::cerr << "Exception: " << e.what() << '\n';
+		std::cerr << "Exception while exporting matches: " << e.what() << '\n';
 	}
+	writer.finish();
+	std::cout << "Exported " << writer.getRowCount() << " matches to " << file_name << ".\n";
+}
+
+void UIManager::importPlayers() {
+	std::cout << "Enter CSV or TSV file name (first name, last name): ";
+	std::string file_name;
+	std::getline(std::cin, file_name);
+
+	const ImportReport report = PlayerImporter::importFile(file_name);
+	PlayerImporter::printReport(report);
+}
+
+void UIManager::importSchedule() {
+	std::cout << "Enter draw file name (player_id1, player_id2, no_sets, predicted_start_time): ";
+	std::string file_name;
+	std::getline(std::cin, file_name);
+
+	const ScheduleReport report = ScheduleImporter::importFile(file_name);
+	ScheduleImporter::printReport(report);
+}
+
+// Served from the rating engine's in-memory index; no query is run.
+void UIManager::showLeaderboard() {
+	const int k = getNumericInput("How many players to show: ");
+	if (k < 1) {
+		std::cout << "Enter a positive number.\n";
+		return;
+	}
+
+	const std::vector<PlayerRating> leaders = RatingEngine::getInstance().top(static_cast<std::size_t>(k));
+	if (leaders.empty()) {
+		std::cout << "No rated players yet.\n";
+		return;
+	}
+
+	TableWriter writer(std::cout, { { "Rank", 5, true }, { "ID", 6, true }, { "Player", 40 }, { "Rating", 8, true }, { "Matches", 8, true } });
+	for (std::size_t i = 0; i < leaders.size(); ++i) {
+		writer.writeRow({ std::to_string(i + 1), std::to_string(leaders[i].player_id), leaders[i].name,
+			std::to_string(static_cast<int>(std::lround(leaders[i].rating))), std::to_string(leaders[i].rated_matches) });
+	}
+	writer.finish();
+}
+
+void UIManager::recomputeRatings() {
+	RatingParameters parameters = RatingEngine::getInstance().getParameters();
+	const int k_factor = getNumericInput("Enter K factor (currently " + std::to_string(static_cast<int>(parameters.k_factor)) + "): ");
+	if (k_factor < 1) {
+		std::cout << "K factor must be positive.\n";
+		return;
+	}
+	parameters.k_factor = k_factor;
+
+	if (RatingEngine::getInstance().recompute(parameters)) {
+		std::cout << "Ratings recomputed.\n";
+	}
+	else {
+		std::cout << "Ratings were not changed.\n";
+	}
+}
+
+// Served entirely from the live score cache; no query is run.
+void UIManager::showLiveScores() {
+	std::vector<LiveMatch> matches = LiveScoreCache::getInstance().getAll();
+	if (matches.empty()) {
+		std::cout << "No live matches.\n";
+		return;
+	}
+	std::sort(matches.begin(), matches.end(), [](const LiveMatch& a, const LiveMatch& b) { return a.match_id < b.match_id; });
+
+	tabulate::Table table;
+	table.add_row({ "ID", "Status", "Player 1", "Player 2", "Sets", "Games", "Points", "Serving" });
+
+	for (const auto& match : matches) {
+		const CompactScore& score = match.score;
+		const std::string points = score.getIsTiebreak()
+			? std::to_string(score.getPointsPlayerOne()) + ":" + std::to_string(score.getPointsPlayerTwo())
+			: Game::getScoreString(score.getPointsPlayerOne()) + ":" + Game::getScoreString(score.getPointsPlayerTwo());
+
+		table.add_row({
+			std::to_string(match.match_id),
+			ReferenceData::getInstance().getStatusName(match.status_id).value_or("N/A"),
+			match.player1_name,
+			match.player2_name,
+			std::to_string(score.getSetsPlayerOne()) + ":" + std::to_string(score.getSetsPlayerTwo()),
+			std::to_string(score.getGamesPlayerOne()) + ":" + std::to_string(score.getGamesPlayerTwo()),
+			score.isFinished() ? "-" : points,
+			score.isFinished() ? "-" : (score.getIsPlayerOneServing() ? match.player1_name : match.player2_name)
+			});
+	}
+
+	std::cout << table << '\n';
 }
 
 void UIManager::showMatchDetails() {
 	const int match_id = getNumericInput("Enter match ID: ");
 	DatabaseConnection& db = DatabaseConnection::getInstance();
-	pqxx::nontransaction nt(*db.getConnection());
+	ConnectionLease lease = db.acquire();
+	pqxx::nontransaction nt(*lease);
 
 	std::string match_query = R"(
 	    SELECT 
-	        m.id, 
-	        ms.status, 
-	        p1.first_name || ' ' || p1.last_name AS player1_name, 
-	        p2.first_name || ' ' || p2.last_name AS player2_name, 
-	        COALESCE(w.first_name || ' ' || w.last_name, 'N/A') AS winner_name, 
-	        m.no_sets AS score_in_sets, 
-	        SUM(CASE WHEN (mse.games_won_player1 >= 6 AND mse.games_won_player1 >= mse.games_won_player2 + 2) OR mse.games_won_player1 = 7 THEN 1 ELSE 0 END) AS player1_sets_won,
-            SUM(CASE WHEN (mse.games_won_player2 >= 6 AND mse.games_won_player2 >= mse.games_won_player1 + 2) OR mse.games_won_player2 = 7 THEN 1 ELSE 0 END) AS player2_sets_won,
-	        EXTRACT(HOUR FROM m.duration) || ':' || LPAD(EXTRACT(MINUTE FROM m.duration)::text, 2, '0') AS duration
+	        match_id AS id, status, player1_name, player2_name, winner_name, 
+	        no_sets AS score_in_sets, 
+	        sets_won_player1 AS player1_sets_won, 
+	        sets_won_player2 AS player2_sets_won,
+	        EXTRACT(HOUR FROM duration) || ':' || LPAD(EXTRACT(MINUTE FROM duration)::text, 2, '0') AS duration
 	    FROM 
-	        public.matches m
-	    JOIN 
-	        public.players p1 ON m.player_id1 = p1.id
-	    JOIN 
-	        public.players p2 ON m.player_id2 = p2.id
-	    LEFT JOIN 
-	        public.players w ON m.winner_id = w.id
-	    LEFT JOIN 
-	        public.match_status ms ON m.status_id = ms.id
-	    LEFT JOIN 
-	        public.matches_sets mse ON m.id = mse.match_id
+	        public.match_summary
 	    WHERE 
-	        m.id = )" + nt.quote(match_id) + R"(
-	    GROUP BY 
-	        m.id, ms.status, p1.first_name, p1.last_name, p2.first_name, p2.last_name, w.first_name, w.last_name, m.no_sets, m.duration
+	        match_id = )" + nt.quote(match_id) + R"(
 	)";
 
 	pqxx::result match_result = nt.exec(match_query);
@@ -677,63 +808,101 @@ void UIManager::showMatchDetails() {
 	}
 }
 
+std::vector<std::string> UIManager::toHistoryRow(const MatchRecord& match) {
+	const auto name = [](const int player_id) {
+		const std::optional<PlayerRating> player = RatingEngine::getInstance().get(player_id);
+		return player ? player->name : "Player " + std::to_string(player_id);
+	};
+	const int minutes = match.duration_seconds / 60;
+	const std::string duration = std::to_string(minutes / 60) + ":" + (minutes % 60 < 10 ? "0" : "") + std::to_string(minutes % 60);
+
+	return { std::to_string(match.match_id), name(match.player_id1), name(match.player_id2), name(match.winner_id),
+		std::to_string(match.sets_player1) + ":" + std::to_string(match.sets_player2), duration };
+}
+
+void UIManager::showHeadToHead() {
+	const int player_a = getPlayerInput("Enter first player ID or name: ");
+	const int player_b = getPlayerInput("Enter second player ID or name: ");
+	if (player_a == 0 || player_b == 0) {
+		return;
+	}
+	if (player_a == player_b) {
+		std::cerr << "Player IDs must be different.\n";
+		return;
+	}
+
+	const std::vector<MatchRecord> matches = MatchHistoryIndex::getInstance().getHeadToHead(player_a, player_b);
+	if (matches.empty()) {
+		std::cout << "These players have not finished a match against each other.\n";
+		return;
+	}
+
+	const long wins_a = std::count_if(matches.begin(), matches.end(), [player_a](const MatchRecord& match) { return match.winner_id == player_a; });
+	TableWriter writer(std::cout, MATCH_HISTORY_COLUMNS);
+	for (const auto& match : matches) {
+		writer.writeRow(toHistoryRow(match));
+	}
+	writer.finish();
+	std::cout << "Head-to-head: " << wins_a << " - " << static_cast<long>(matches.size()) - wins_a << '\n';
+}
+
+void UIManager::searchPlayers() {
+	std::cout << "Enter name: ";
+	std::string query;
+	std::getline(std::cin, query);
+
+	const std::vector<PlayerMatch> matches = PlayerSearchIndex::getInstance().search(query, PlayerSearchIndex::DEFAULT_LIMIT);
+	if (matches.empty()) {
+		std::cout << "No players found.\n";
+		return;
+	}
+
+	TableWriter writer(std::cout, { { "Player ID", 9, true }, { "First Name", 25 }, { "Last Name", 25 } });
+	for (const auto& match : matches) {
+		writer.writeRow({ std::to_string(match.player_id), match.first_name, match.last_name });
+	}
+	writer.finish();
+}
+
 void UIManager::showMatchesResultsForPlayer() {
-	const int player_id = getNumericInput("Enter Player ID: ");
+	const int player_id = getPlayerInput("Enter Player ID or name: ");
+	if (player_id == 0) {
+		return;
+	}
 	DatabaseConnection& db = DatabaseConnection::getInstance();
 
 	try {
-		std::string query_ = "SELECT * FROM public.players WHERE id = " + std::to_string(player_id);
-		pqxx::nontransaction nt1(*db.getConnection());
-		pqxx::result r_ = nt1.exec(query_);
-		nt1.commit();
-
-		if (r_.empty()) {
-			std::cout << "No user found.\n";
-			return;
+		{
+			std::string query_ = "SELECT * FROM public.players WHERE id = " + std::to_string(player_id);
+			ConnectionLease lease = db.acquire();
+			pqxx::nontransaction nt1(*lease);
+			pqxx::result r_ = nt1.exec(query_);
+			nt1.commit();
+
+			if (r_.empty()) {
+				std::cout << "No user found.\n";
+				return;
+			}
 		}
 
-		const std::string query = R"(
+		const KeysetPager pager(R"(
 		    SELECT 
-		        m.id, 
-		        p1.first_name || ' ' || p1.last_name AS player1_name, 
-		        p2.first_name || ' ' || p2.last_name AS player2_name, 
-		        COALESCE(w.first_name || ' ' || w.last_name, 'N/A') AS winner_name, 
-		        m.no_sets AS score_in_sets, 
-		        EXTRACT(HOUR FROM m.duration) || ':' || LPAD(EXTRACT(MINUTE FROM m.duration)::text, 2, '0') AS duration,
-		        SUM(CASE WHEN (ms.games_won_player1 >= 6 AND ms.games_won_player1 >= ms.games_won_player2 + 2) OR ms.games_won_player1 = 7 THEN 1 ELSE 0 END) AS player1_sets_won,
-				SUM(CASE WHEN (ms.games_won_player2 >= 6 AND ms.games_won_player2 >= ms.games_won_player1 + 2) OR ms.games_won_player2 = 7 THEN 1 ELSE 0 END) AS player2_sets_won
+		        match_id AS id, player1_name, player2_name, winner_name, 
+		        no_sets AS score_in_sets, 
+		        EXTRACT(HOUR FROM duration) || ':' || LPAD(EXTRACT(MINUTE FROM duration)::text, 2, '0') AS duration,
+		        sets_won_player1 AS player1_sets_won,
+		        sets_won_player2 AS player2_sets_won
 			FROM 
-		        public.matches m
-		    JOIN 
-		        public.players p1 ON m.player_id1 = p1.id
-		    JOIN 
-		        public.players p2 ON m.player_id2 = p2.id
-		    LEFT JOIN 
-		        public.players w ON m.winner_id = w.id
-		    LEFT JOIN 
-		        public.matches_sets ms ON m.id = ms.match_id
-		    WHERE 
-		        m.player_id1 = )" + nt1.quote(player_id) + R"( OR m.player_id2 = )" + nt1.quote(player_id) + R"(
-		    GROUP BY 
-		        m.id, p1.first_name, p1.last_name, p2.first_name, p2.last_name, w.first_name, w.last_name, m.no_sets, m.duration
-		    ORDER BY 
-		        m.id ASC
-		)";
-
-		pqxx::nontransaction nt2(*db.getConnection());
-		pqxx::result r = nt2.exec(query);
-
-		if (r.empty()) {
-			std::cout << "No matches found for player with ID " << player_id << ".\n";
-		}
-		else {
-			tabulate::Table table;
-			table.add_row({ "ID", "Player 1", "Player 2", "Winner", "Score in Sets", "Duration" });
+		        public.match_summary
+		)", "match_id", "player_id1 = " + std::to_string(player_id) + " OR player_id2 = " + std::to_string(player_id));
+
+		TableWriter writer(std::cout, MATCH_HISTORY_COLUMNS);
 
-			for (const auto& row : r) {
+		pager.run([&writer](const pqxx::result& page) {
+			for (const auto& row : page) {
 				std::string sets_score = row["player1_sets_won"].as<std::string>() + ":" + row["player2_sets_won"].as<std::string>();
 
-				table.add_row({
+				writer.writeRow({
 					row["id"].as<std::string>(),
 					row["player1_name"].as<std::string>(),
 					row["player2_name"].as<std::string>(),
@@ -742,11 +911,36 @@ void UIManager::showMatchesResultsForPlayer() {
 					row["duration"].as<std::string>()
 					});
 			}
+		});
+		writer.finish();
 
-			std::cout << table << '\n';
+		if (writer.getRowCount() == 0) {
+			std::cout << "No matches found for player with ID " << player_id << ".\n";
 		}
 	}
 	catch (const std::exception& e) {
 		std::cerr << "Exception: " << e.what() << '\n';
 	}
+}
+
+// Finished matches only, straight from the MatchHistoryIndex, with the player's win-loss record.
+void UIManager::showPlayerHistory() {
+	const int player_id = getPlayerInput("Enter Player ID or name: ");
+	if (player_id == 0) {
+		return;
+	}
+
+	const std::vector<MatchRecord> matches = MatchHistoryIndex::getInstance().getPlayerHistory(player_id);
+	if (matches.empty()) {
+		std::cout << "No finished matches found for player with ID " << player_id << ".\n";
+		return;
+	}
+
+	const long wins = std::count_if(matches.begin(), matches.end(), [player_id](const MatchRecord& match) { return match.winner_id == player_id; });
+	TableWriter writer(std::cout, MATCH_HISTORY_COLUMNS);
+	for (const auto& match : matches) {
+		writer.writeRow(toHistoryRow(match));
+	}
+	writer.finish();
+	std::cout << "Won " << wins << ", lost " << static_cast<long>(matches.size()) - wins << '\n';
 }
\ No newline at end of file
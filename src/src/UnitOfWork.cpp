@@ -0,0 +1,34 @@
+#include "UnitOfWork.hpp"
+#include "PreparedStatements.hpp"
+#include <iostream>
+
+UnitOfWork::~UnitOfWork() {
+    if (empty()) {
+        return;
+    }
+    if (std::uncaught_exceptions() > uncaught_exceptions_) {
+        std::cerr << "Discarding " << writes_.size() << " score writes for match " << match_id_ << " after an exception.\n";
+    }
+    else {
+        std::cerr << "Unit of work for match " << match_id_ << " was never committed; its " << writes_.size() << " writes are discarded.\n";
+    }
+}
+
+void UnitOfWork::commit() {
+    if (empty()) {
+        return;
+    }
+
+    PersistenceQueue::getInstance().enqueue(match_id_,
+        [match_id = match_id_, writes = std::move(writes_), duration_seconds = duration_seconds_](pqxx::work& txn) {
+            for (const auto& write : writes) {
+                write(txn);
+            }
+            if (duration_seconds > 0) {
+                PreparedStatements::exec<AddMatchDurationQuery>(txn, duration_seconds, match_id);
+            }
+        });
+
+    writes_.clear();
+    duration_seconds_ = 0;
+}
@@ -1,19 +1,119 @@
+#include "CourtServer.hpp"
 #include "DatabaseConnection.hpp"
+#include "LiveScoreCache.hpp"
+#include "LoadGenerator.hpp"
+#include "MatchHistoryIndex.hpp"
+#include "PlayerImporter.hpp"
+#include "PlayerSearchIndex.hpp"
+#include "PointNotifyListener.hpp"
+#include "QueryMetrics.hpp"
+#include "RatingEngine.hpp"
+#include "ReferenceData.hpp"
+#include "ScheduleImporter.hpp"
+#include "ScoreApi.hpp"
 #include "UIManager.hpp"
+#include <chrono>
 #include <iostream>
+#include <string>
 
-int main() {
+static constexpr std::chrono::seconds METRICS_DUMP_INTERVAL{ 10 };
+
+// For the modes that serve reads: the live scores, leaderboard, match history and player search.
+static void warmReadIndexes() {
+    LiveScoreCache::getInstance().warm();
+    RatingEngine::getInstance().warm();
+    MatchHistoryIndex::getInstance().build();
+    PlayerSearchIndex::getInstance().load();
+}
+
+int main(const int argc, char* argv[]) {
     try {
-        DatabaseConnection& db = DatabaseConnection::getInstance();
+        const bool is_load_test = argc > 1 && std::string(argv[1]) == "--load-test";
+        LoadTestParams load_test;
+        if (is_load_test) {
+            load_test.matches = argc > 2 ? std::stoul(argv[2]) : load_test.matches;
+            load_test.concurrency = argc > 3 ? static_cast<unsigned>(std::stoul(argv[3])) : load_test.concurrency;
+            load_test.no_sets = argc > 4 ? std::stoi(argv[4]) : load_test.no_sets;
+            DatabaseConnection::setPoolSize(LoadGenerator::poolSizeFor(load_test.concurrency));
+        }
 
-        if (!db.getConnection()) {
-            std::cerr << "Database connection failed.\n";
+        try {
+            DatabaseConnection::getInstance().acquire();
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Database connection failed: " << e.what() << '\n';
             return 1;
         }
 
         std::cout << "Database connection successful.\n";
+        ReferenceData::getInstance().refresh();
+
+        if (argc > 2 && std::string(argv[1]) == "--import-players") {
+            const unsigned threads = argc > 3 ? static_cast<unsigned>(std::stoul(argv[3])) : 0;
+            const ImportReport report = PlayerImporter::importFile(argv[2], threads);
+            PlayerImporter::printReport(report);
+            return report.is_committed ? 0 : 1;
+        }
+
+        if (argc > 2 && std::string(argv[1]) == "--import-schedule") {
+            const ScheduleReport report = ScheduleImporter::importFile(argv[2]);
+            ScheduleImporter::printReport(report);
+            return report.is_committed ? 0 : 1;
+        }
+
+        // Played matches are rated, so the stored rating parameters are needed; nothing reads the other indexes.
+        if (is_load_test) {
+            RatingEngine::getInstance().warm();
+            QueryMetrics::setEnabled(true);
+            const LoadTestReport report = LoadGenerator::run(load_test);
+            LoadGenerator::printReport(report);
+            return report.matches_played == report.matches_planned && report.score_mismatches == 0 ? 0 : 1;
+        }
+
+        if (argc > 1 && std::string(argv[1]) == "--server") {
+            const unsigned threads = argc > 2 ? static_cast<unsigned>(std::stoul(argv[2])) : 0;
+            RatingEngine::getInstance().warm();
+            QueryMetrics::setEnabled(true);
+            if (argc > 3) {
+                QueryMetrics::getInstance().startDump(argv[3], METRICS_DUMP_INTERVAL);
+            }
+            CourtServer server(threads);
+            std::cout << "Court server ready.\n";
+            server.run(std::cin, std::cout);
+            QueryMetrics::getInstance().stopDump();
+            return 0;
+        }
+
+        if (argc > 1 && std::string(argv[1]) == "--http") {
+            const unsigned short port = argc > 2 ? static_cast<unsigned short>(std::stoul(argv[2])) : 8080;
+            const unsigned threads = argc > 3 ? static_cast<unsigned>(std::stoul(argv[3])) : 0;
+            const std::string bind_address = argc > 4 ? argv[4] : HttpServer::DEFAULT_BIND_ADDRESS;
+            warmReadIndexes();
+            QueryMetrics::setEnabled(true);
+            CourtServer court_server(threads);
+            ScoreApi api(court_server);
+            HttpServer http_server(port, [&api](const HttpRequest& request) { return api.handle(request); }, 256, bind_address);
+            if (!http_server.start()) {
+                return 1;
+            }
+            PointNotifyListener listener([&court_server](const int match_id) { return court_server.getScore(match_id).has_value(); });
+            listener.start();
+            std::cout << "Scoring API listening on " << bind_address << ':' << port << ". Type 'quit' to stop.\n";
+            std::string line;
+            while (std::getline(std::cin, line) && line != "quit") {
+            }
+            listener.stop();
+            ScoreEventBus::getInstance().closeAll();
+            http_server.stop();
+            return 0;
+        }
+
+        warmReadIndexes();
+        PointNotifyListener listener;
+        listener.start();
         UIManager ui_manager;
         ui_manager.run();
+        listener.stop();
     }
     catch (const std::exception& e) {
         std::cerr << "Exception: " << e.what() << '\n';